@@ -5,14 +5,17 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QObject>
-#include <QSharedPointer>
+#include <QScopedPointer>
+#include <QVariantList>
 
 /**
  * @brief The SqlDatabase class is equivalent to QSqlDatabase with some small changes:
  * - The database does not need to have a connection name, but is still shared.
  * - The database will automatically be closed if no more references (e.g SqlQuery's) are pointing to it
  * - The database only works with SqlQuery instead of QSqlQuery.
+ * - A database can only be used by the thread which opened it, use SqlConnectionPool to share it between threads.
  * \sa SqlQuery
+ * \sa SqlConnectionPool
  */
 
 class ITEMFRAMEWORK_EXPORT SqlDatabase : private QSqlDatabase
@@ -40,6 +43,13 @@ public:
      */
     class SqlQuery exec(const QString& query) const;
 
+    /**
+     * @brief Creates a new, closed connection with the same driver and connection properties. A connection can only
+     * be used by the thread which opened it, so every thread needs its own clone (see SqlConnectionPool).
+     * @return the cloned SqlDatabase
+     */
+    SqlDatabase clone() const;
+
     //All methods from the base class are made public:
     using QSqlDatabase::close;
     using QSqlDatabase::commit;
@@ -73,6 +83,18 @@ public:
 
 };
 
+/**
+ * @brief Holds the SqlDatabase of a SqlQuery. It is the first base class of SqlQuery, so the database is released
+ * after the QSqlQuery part, which still uses the driver of the database while it is destroyed.
+ */
+class SqlQueryDatabase
+{
+protected:
+    SqlQueryDatabase() {}
+    SqlQueryDatabase(const SqlDatabase& database) : _database(database) {}
+    SqlDatabase _database;
+};
+
 /**
  * @brief The SqlQuery class inherits from QSqlQuery class, but:
  * - Works with SqlDatabase instead of QSqlDatabase
@@ -80,7 +102,7 @@ public:
  * - Has a database() method to get the database back
  * \sa SqlDatabase
  */
-class ITEMFRAMEWORK_EXPORT SqlQuery: public QSqlQuery
+class ITEMFRAMEWORK_EXPORT SqlQuery: private SqlQueryDatabase, public QSqlQuery
 {
     friend class TestSqlDatabase;
 public:
@@ -113,9 +135,58 @@ public:
      * @return the SqlDatabase object
      */
     SqlDatabase database() const;
+};
+
+/**
+ * @brief The SqlConnectionPool class hands out a connection per thread to the database it was configured with:
+ * - The first use in a thread opens a clone of the configured database, which is closed when the thread finishes.
+ * - Every thread keeps its prepared statements by their sql text, so a statement used again is not prepared again.
+ * The pool itself is threadsafe. It should be destroyed after the threads which used it finished.
+ * \sa SqlDatabase
+ */
+class ITEMFRAMEWORK_EXPORT SqlConnectionPool
+{
+public:
+    /**
+     * @brief Constructs a pool for \a database. The database itself is never opened, only its clones.
+     * @param database The configured SqlDatabase
+     * @param maxCachedStatements The number of prepared statements which are kept per thread
+     */
+    explicit SqlConnectionPool(const SqlDatabase& database, int maxCachedStatements = 64);
+
+    /**
+     * @brief Destroys the pool and closes the connections which are still open.
+     */
+    ~SqlConnectionPool();
+
+    /**
+     * @brief Returns the connection of the calling thread and opens it on first use. Use lastError() of the
+     * returned SqlDatabase, if it could not be opened.
+     * @return the SqlDatabase of the calling thread
+     */
+    SqlDatabase database();
+
+    /**
+     * @brief Returns the prepared statement for \a query on the connection of the calling thread. The statement is
+     * only prepared on first use, later calls return the cached statement with its previous result finished.
+     * The statement is shared, so a result has to be read before the same query is prepared again in the thread.
+     * @param query The SQL query string to prepare
+     * @return a SqlQuery object to bind the values to and execute, check lastError() if preparing failed
+     */
+    SqlQuery prepare(const QString& query);
+
+    /**
+     * @brief Executes the prepared statement for \a query with the positional \a values on the connection of the
+     * calling thread (see prepare).
+     * @param query The SQL query string to execute
+     * @param values The values for the placeholders of the query
+     * @return a SqlQuery object containing the result
+     */
+    SqlQuery exec(const QString& query, const QVariantList& values = QVariantList());
 
 private:
-    QSharedPointer<class DatabaseHolder> _deleter;
+    QScopedPointer<class SqlConnectionPoolPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(SqlConnectionPool)
 };
 
 #endif /* SQL_DATABASE_H_ */
@@ -0,0 +1,118 @@
+#ifndef SQL_QUERY_WORKER_H
+#define SQL_QUERY_WORKER_H
+
+#include "appcore.h"
+#include "helper/sql_database.h"
+#include <QThread>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QSharedPointer>
+#include <QScopedPointer>
+#include <QVector>
+
+struct SqlAsyncQueryState;
+
+/**
+ * @brief The SqlAsyncQuery class is the handle of a query which runs on a SqlQueryWorker.
+ * - The rows of the result are delivered in batches by rowsFetched(), in the thread of the requesting object.
+ * - finished() is emitted once all rows were delivered or the query failed. The handle deletes itself afterwards,
+ *   and after cancel().
+ * - The handle is a child of the requesting object, so deleting the object (e.g. an item) cancels the query.
+ * \sa SqlQueryWorker
+ */
+class ITEMFRAMEWORK_EXPORT SqlAsyncQuery : public QObject
+{
+    Q_OBJECT
+    friend class SqlQueryWorker;
+public:
+    /**
+     * @brief Cancels the query if it is still running. The rows which are not fetched yet are skipped and
+     * no more signals are emitted. Destroying the handle cancels the query as well.
+     */
+    ~SqlAsyncQuery();
+
+    /**
+     * @brief Stops the query after the current batch and drops all rows which are not delivered yet.
+     * finished() is not emitted for a cancelled query. The handle deletes itself once control returns to the event loop.
+     */
+    void cancel();
+
+    /**
+     * @return Returns \c true if the query was cancelled, otherwise returns \c false.
+     */
+    bool isCancelled() const;
+
+signals:
+    /**
+     * @brief Emitted for every batch of rows of the result, in the order of the result.
+     * @param rows The fetched rows, at most the batch size of the query
+     */
+    void rowsFetched(const QVector<QSqlRecord>& rows);
+
+    /**
+     * @brief Emitted after the last batch, or if the query could not be executed.
+     * @param error The error of the query, QSqlError::NoError if it succeeded
+     */
+    void finished(const QSqlError& error);
+
+private:
+    SqlAsyncQuery(const QSharedPointer<SqlAsyncQueryState>& state, QObject* requester);
+    QSharedPointer<SqlAsyncQueryState> _state;
+    bool _isFinished = false;
+
+private slots:
+    void deliver();
+};
+
+/**
+ * @brief The SqlQueryWorker class runs queries on a dedicated thread with its own connection to a database, so
+ * a slow query does not block the requesting (e.g. the GUI) thread.
+ * - The queries run one after another, in the order they were requested.
+ * - The statements are prepared once and kept by their sql text (see SqlConnectionPool).
+ * - A worker keeps at most a few undelivered batches per query, fetching waits until the requester caught up.
+ * The worker thread is started by the constructor and stopped by the destructor, which cancels all queries.
+ * \sa SqlAsyncQuery
+ */
+class ITEMFRAMEWORK_EXPORT SqlQueryWorker : public QThread
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief The default number of rows which are delivered at once.
+     */
+    static const int DefaultBatchSize = 256;
+
+    /**
+     * @brief Constructs a worker for \a database and starts its thread. The database itself is never opened,
+     * the worker opens a clone of it (see SqlDatabase::clone).
+     * @param database The configured SqlDatabase
+     * @param parent The parent object
+     */
+    explicit SqlQueryWorker(const SqlDatabase& database, QObject* parent = nullptr);
+
+    /**
+     * @brief Cancels all queries and waits until the current query stopped.
+     */
+    ~SqlQueryWorker();
+
+    /**
+     * @brief Queues \a query for the worker thread. This method is threadsafe.
+     * @param query The SQL query string to execute
+     * @param requester The object which requests the query, it has to live in the calling thread. The returned handle
+     * is its child, so the query is cancelled when the requester is deleted.
+     * @param values The values for the placeholders of the query
+     * @param batchSize The maximum number of rows per rowsFetched() signal
+     * @return the handle of the query, connect to its signals to receive the result
+     */
+    SqlAsyncQuery* exec(const QString& query, QObject* requester, const QVariantList& values = QVariantList(),
+                        int batchSize = DefaultBatchSize);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QScopedPointer<class SqlQueryWorkerPrivate> d_ptr;
+    Q_DECLARE_PRIVATE(SqlQueryWorker)
+};
+
+#endif // SQL_QUERY_WORKER_H
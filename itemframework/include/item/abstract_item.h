@@ -65,6 +65,14 @@ class SettingsScope;
  *
  * \sa connectorStyle
  * \sa registerConnectorStyle
+ *
+ * Level of detail
+ * ---------------
+ * When the view is zoomed out, items are painted with less detail. Below full detail the
+ * labels and ports are not painted, at low detail the item is only painted as a flat rectangle
+ * and paintItemBox is not called at all.
+ *
+ * \sa detailLevel
  */
 class ITEMFRAMEWORK_EXPORT AbstractItem : public QGraphicsObject
 {
@@ -72,6 +80,15 @@ class ITEMFRAMEWORK_EXPORT AbstractItem : public QGraphicsObject
     Q_PROPERTY(SettingsScope* settingsScope READ settingsScope)
 
 public:
+    /**
+     * @brief The detail tiers used to paint items, depending on the zoom level of the view
+     */
+    enum DetailLevel {
+        LowDetail,     ///< flat rectangles only
+        ReducedDetail, ///< item boxes without labels and ports
+        FullDetail     ///< everything
+    };
+
     /**
      * @brief Constructs an AbstractItem with the name \a typeName
      * @param typeName The type name of your item
@@ -238,6 +255,13 @@ public:
      */
     static QPen connectorStyle(int transportType);
 
+    /**
+     * @param option The style option passed to paint()
+     * @param painter The painter passed to paint()
+     * @return The detail tier to paint with, based on the level of detail of the painter's transformation
+     */
+    static DetailLevel detailLevel(QStyleOptionGraphicsItem const* option, QPainter const* painter);
+
 
 protected:
     /**
@@ -360,10 +384,23 @@ protected:
     /**
      * @brief This Method paints the Item Rectangle, the Icon and the progress bar
      * of the item. Override for custom behavior.
+     *
+     * When painted in a view, the result is cached as pixmap per zoom level. The cache is
+     * discarded by setImage, setProgress, setName and selection changes. Overrides which paint
+     * additional state must call invalidateItemBox when it changes.
      * @param painter The painter to use
+     *
+     * \sa invalidateItemBox
      */
     virtual void paintItemBox(QPainter* painter);
 
+    /**
+     * @brief Discards the cached rendering of paintItemBox and schedules a repaint.
+     *
+     * \sa paintItemBox
+     */
+    void invalidateItemBox();
+
     void timerEvent(QTimerEvent* t) override;
     QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
     void contextMenuEvent(QGraphicsSceneContextMenuEvent* event) override;
@@ -397,10 +434,13 @@ public slots:
     void disconnectConnections();
 
 private:
+    void updatePortPositions(); // passes a changed scene position on to the inputs and outputs
+
     QScopedPointer<class AbstractItemPrivate> const d_ptr;
     Q_DECLARE_PRIVATE(AbstractItem)
 
     friend class Item_Origin_Visualizer_Entry;
+    friend class ItemScene;
 };
 
 #endif // ABSTRACT_ITEM_H
@@ -89,6 +89,11 @@ protected:
      */
     void updateScenePosition();
 
+    /**
+     * @brief Keeps the port index of the scene up to date when this object is added to or removed from a scene
+     */
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
 signals:
     /**
      * @brief This signal is emitted whenever this objects local or scene
@@ -0,0 +1,51 @@
+#ifndef ITEM_BATCH_H
+#define ITEM_BATCH_H
+
+#include "appcore.h"
+
+/**
+ * @brief The ItemBatch class is a guard which bundles the construction of many items and connections.
+ *
+ * While at least one ItemBatch exists, the framework defers the work it would otherwise do for every single change:
+ * - adding inputs and outputs does not realign the ports of the item,
+ * - connecting an input to an output does not emit ItemInput::outputConnected(), ItemOutput::inputConnected()
+ *   and ItemInput::dataChanged(),
+ * - connectors are not routed.
+ *
+ * When the outermost ItemBatch is destroyed, the batch commits: every touched item is realigned once, the connection
+ * signals are emitted once per connection and the data is propagated once per input, and every touched connector is
+ * routed once. A connection which is removed again within the batch is reported neither as connected nor as
+ * disconnected.
+ * Batches may be nested. They must only be used from the GUI thread.
+ *
+ * \code
+ * {
+ *     ItemBatch batch;
+ *     // create items, add ports, connect them ...
+ * } // everything is realigned, propagated and routed here
+ * \endcode
+ */
+class ITEMFRAMEWORK_EXPORT ItemBatch
+{
+public:
+    /**
+     * @brief Begins a batch, or joins the batch which is already active
+     */
+    ItemBatch();
+
+    /**
+     * @brief Commits the batch if this is the outermost guard
+     */
+    ~ItemBatch();
+
+    /**
+     * @return true if a batch is active
+     */
+    static bool isActive();
+
+private:
+    ItemBatch(ItemBatch const&) = delete;
+    ItemBatch& operator=(ItemBatch const&) = delete;
+};
+
+#endif // ITEM_BATCH_H
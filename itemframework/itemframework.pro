@@ -23,23 +23,32 @@ SOURCES     +=  \
                 src/gui/livedoc.cpp \
                 src/gui/about_dialog.cpp \
                 src/res/resource.cpp \
+                src/res/theme.cpp \
                 src/helper/startup_helper.cpp \
                 src/helper/settings_scope.cpp \
                 src/helper/dom_helper.cpp \
                 src/helper/singleton.cpp \
                 src/helper/progress_reporter.cpp \
+                src/helper/sql_database.cpp \
+                src/helper/sql_query_worker.cpp \
                 src/item/abstract_item.cpp \
                 src/item/abstract_window_item.cpp \
                 src/item/abstract_item_input_output_base.cpp \
+                src/item/item_batch.cpp \
                 src/item/item_connector.cpp \
                 src/item/item_input.cpp \
+                src/item/item_journal.cpp \
                 src/item/item_list_model.cpp \
                 src/item/item_manager.cpp \
+                src/item/item_mime_data.cpp \
                 src/item/item_note.cpp \
                 src/item/item_origin_visualizer_entry.cpp \
                 src/item/item_origin_visualizer.cpp \
                 src/item/item_output.cpp \
                 src/item/item_scene.cpp \
+                src/item/item_port_index.cpp \
+                src/item/item_record_store.cpp \
+                src/item/item_router.cpp \
                 src/item/item_serializer.cpp \
                 src/item/item_toolbox_view.cpp \
                 src/item/item_toolbox.cpp \
@@ -47,15 +56,22 @@ SOURCES     +=  \
                 src/item/item_templates_view.cpp \
                 src/item/item_templates_widget.cpp \
                 src/item/item_templates_model.cpp \
+                src/item/item_template_store.cpp \
                 src/plugin/plugin_manager.cpp \
                 src/plugin/plugin_meta_data.cpp \
                 src/plugin/plugin_table_model.cpp \
                 src/error/console_widget.cpp \
                 src/error/console_message.cpp \
                 src/error/console_model.cpp \
+                src/error/console_message_queue.cpp \
+                src/error/console_file_sink.cpp \
+                src/error/console_filter_proxy_model.cpp \
                 src/project/abstract_workspace.cpp \
                 src/project/file_workspace.cpp \
+                src/project/file_workspace_index.cpp \
                 src/project/sql_workspace.cpp \
+                src/project/sql_project.cpp \
+                src/project/sql_project_store.cpp \
                 src/project/select_workspace_dialog.cpp \
                 src/project/file_workspace_gui.cpp \
                 src/project/sql_workspace_gui.cpp \
@@ -64,8 +80,10 @@ SOURCES     +=  \
                 src/project/project_gui.cpp \
                 src/project/abstract_workspace_gui.cpp \
                 src/project/abstract_project.cpp \
+                src/project/project_hash.cpp \
                 src/project/file_project.cpp \
                 src/project/file_helper.cpp \
+                src/project/file_watch_service.cpp \
                 src/project/file_project_new_dialog.cpp \
                 src/project/file_workspace_new_dialog.cpp \
                 src/project/project_changed_extern_dialog.cpp \
@@ -95,35 +113,51 @@ HEADERS     +=  \
                 src/helper/startup_helper_p.h \
                 src/helper/settings_scope_p.h \
                 src/helper/progress_reporter_p.h \
+                src/helper/sql_database_p.h \
+                src/helper/sql_query_worker_p.h \
                 src/item/abstract_item_p.h \
                 src/item/abstract_window_item_p.h \
                 src/item/abstract_item_input_output_base_p.h \
                 src/item/item_input_p.h \
                 src/item/item_output_p.h \
+                src/item/item_batch_p.h \
                 src/item/item_connector.h \
+                src/item/item_journal.h \
                 src/item/item_list_model.h \
                 src/item/item_manager.h \
+                src/item/item_mime_data.h \
                 src/item/item_note.h \
                 src/item/item_origin_visualizer_entry.h \
                 src/item/item_scene.h \
+                src/item/item_port_index.h \
+                src/item/item_record_store.h \
+                src/item/item_router.h \
                 src/item/item_serializer.h \
                 src/item/item_toolbox_view.h \
                 src/item/item_toolbox.h \
                 src/item/item_view.h \
                 src/item/item_origin_visualizer_p.h \
                 src/item/item_templates_model.h \
+                src/item/item_template_store.h \
                 src/item/item_templates_view.h \
                 src/item/item_templates_widget.h \
                 src/res/resource.h \
+                src/res/theme.h \
                 src/plugin/plugin_meta_data.h \
                 src/plugin/plugin_table_model.h \
                 src/plugin/plugin_manager_p.h \
                 src/error/console_widget.h \
                 src/error/console_message.h \
                 src/error/console_model.h \
+                src/error/console_message_queue.h \
+                src/error/console_file_sink.h \
+                src/error/console_filter_proxy_model.h \
                 src/project/abstract_workspace.h \
                 src/project/file_workspace.h \
+                src/project/file_workspace_index.h \
                 src/project/sql_workspace.h \
+                src/project/sql_project.h \
+                src/project/sql_project_store.h \
                 src/project/select_workspace_dialog.h \
                 src/project/file_workspace_gui.h \
                 src/project/sql_workspace_gui.h \
@@ -132,8 +166,10 @@ HEADERS     +=  \
                 src/project/project_gui.h \
                 src/project/abstract_workspace_gui.h \
                 src/project/abstract_project.h \
+                src/project/project_hash.h \
                 src/project/file_project.h \
                 src/project/file_helper.h \
+                src/project/file_watch_service.h \
                 src/project/file_project_new_dialog.h \
                 src/project/file_workspace_new_dialog.h \
                 src/project/file_datatype_helper.h \
@@ -168,6 +204,7 @@ HEADERS     +=     \
                 include/item/abstract_item_input_output_base.h \
                 include/item/item_input.h \
                 include/item/item_output.h \
+                include/item/item_batch.h \
                 include/item/item_origin_visualizer.h \
                 include/plugin/plugin_manager.h \
                 include/plugin/interface_factory.h \
@@ -176,7 +213,9 @@ HEADERS     +=     \
                 include/helper/startup_helper_templates.h \
                 include/helper/settings_scope.h \
                 include/helper/dom_helper.h \
-                include/helper/progress_reporter.h
+                include/helper/progress_reporter.h \
+                include/helper/sql_database.h \
+                include/helper/sql_query_worker.h
 
 FORMS       +=  \
                 src/gui/gui_main_window.ui \
@@ -0,0 +1,191 @@
+#include "console_file_sink.h"
+#include "console_message_queue.h"
+#include "helper/startup_helper.h"
+#include "helper/settings_scope.h"
+#include <QDebug>
+#include <QMetaEnum>
+#include <QAtomicInt>
+
+STARTUP_ADD_COMPONENT(ConsoleFileSink)
+
+//Settings keys
+static const char* const LogFileKey = "ConsoleLogFile";
+static const char* const LogFileMaxSizeKey = "ConsoleLogFileMaxSize";
+static const char* const LogFileCountKey = "ConsoleLogFileCount";
+
+static const qint64 DefaultMaxSize = 5 * 1024 * 1024;
+static const int DefaultFileCount = 5;
+
+//The queue and the enabled flag outlive the sink, so that message handlers running concurrently to deinit() stay valid.
+static ConsoleMessageQueue pendingMessages;
+static QAtomicInt sinkEnabled(0);
+static ConsoleFileSink* sink = nullptr;
+
+void ConsoleFileSink::log(const ConsoleMessage& msg)
+{
+    if (sinkEnabled.loadAcquire() != 0) {
+        pendingMessages.push(msg);
+    }
+}
+
+void ConsoleFileSink::init()
+{
+    SettingsScope* settings = SettingsScope::globalScope();
+    QString path = settings->value(LogFileKey).toString();
+
+    if (path.isEmpty()) { //The sink is optional
+        return;
+    }
+
+    qint64 maxSize = settings->value(LogFileMaxSizeKey, DefaultMaxSize).toLongLong();
+    int fileCount = settings->value(LogFileCountKey, DefaultFileCount).toInt();
+
+    sink = new ConsoleFileSink(path, qMax<qint64>(maxSize, 1024), qMax(fileCount, 1));
+
+    if (!sink->openFile()) {
+        qWarning() << "Could not open console log file" << path << ":" << sink->_file.errorString();
+        delete sink;
+        sink = nullptr;
+        return;
+    }
+
+    sinkEnabled.storeRelease(1);
+    sink->start(QThread::LowPriority);
+}
+
+void ConsoleFileSink::deinit()
+{
+    if (sink == nullptr) {
+        return;
+    }
+
+    sinkEnabled.storeRelease(0);
+
+    sink->_stopMutex.lock();
+    sink->_stopRequested = true;
+    sink->_stopCondition.wakeAll();
+    sink->_stopMutex.unlock();
+
+    sink->wait(); //The writer thread writes the remaining messages before it finishes
+    delete sink;
+    sink = nullptr;
+}
+
+ConsoleFileSink::ConsoleFileSink(const QString& path, qint64 maxSize, int fileCount)
+    : _path(path), _maxSize(maxSize), _fileCount(fileCount), _file(path)
+{
+}
+
+void ConsoleFileSink::run()
+{
+    bool stop = false;
+
+    while (!stop) {
+        _stopMutex.lock();
+
+        if (!_stopRequested) {
+            _stopCondition.wait(&_stopMutex, FlushInterval);
+        }
+
+        stop = _stopRequested;
+        _stopMutex.unlock();
+
+        writePending();
+    }
+
+    _file.close();
+}
+
+void ConsoleFileSink::writePending()
+{
+    QVector<ConsoleMessage> msgs = pendingMessages.takeAll();
+
+    if (msgs.isEmpty() || !_file.isOpen()) {
+        return;
+    }
+
+    QByteArray batch;
+
+    for (const ConsoleMessage& msg : msgs) {
+        QByteArray line = formatMessage(msg).toUtf8();
+        line.append('\n');
+
+        if (_written + batch.size() + line.size() > _maxSize && _written + batch.size() > 0) {
+            write(batch);
+            batch.clear();
+            rotate();
+
+            if (!_file.isOpen()) {
+                return; //Reopening failed, drop the rest of the batch
+            }
+        }
+
+        batch.append(line);
+    }
+
+    write(batch); //One write per batch
+    _file.flush();
+}
+
+void ConsoleFileSink::write(const QByteArray& batch)
+{
+    const qint64 written = _file.write(batch);
+
+    if (written < 0) {
+        //Reported once per failure, the warning itself is queued for this file again
+        if (!_writeFailed) {
+            _writeFailed = true;
+            qWarning() << "Could not write console log file" << _path << ":" << _file.errorString();
+        }
+
+        return;
+    }
+
+    _writeFailed = false;
+    _written += written;
+}
+
+void ConsoleFileSink::rotate()
+{
+    _file.close();
+
+    //The file count includes the current file: <path>.<n-2> -> <path>.<n-1>, ..., <path> -> <path>.1.
+    //The oldest file is overwritten.
+    if (_fileCount > 1) {
+        QFile::remove(QString("%1.%2").arg(_path).arg(_fileCount - 1));
+
+        for (int i = _fileCount - 2; i >= 1; --i) {
+            QFile::rename(QString("%1.%2").arg(_path).arg(i), QString("%1.%2").arg(_path).arg(i + 1));
+        }
+
+        QFile::rename(_path, _path + ".1");
+    } else {
+        QFile::remove(_path); //No older file is kept, start over
+    }
+
+    openFile();
+}
+
+bool ConsoleFileSink::openFile()
+{
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    _written = _file.size();
+    return true;
+}
+
+QString ConsoleFileSink::formatMessage(const ConsoleMessage& msg)
+{
+    const QMetaEnum& me = QMetaEnum::fromType<ConsoleMessage::MsgType>();
+
+    //Use the multi argument overload, so that placeholders inside the message are not replaced
+    return QString("%1 [0x%2] %3 %4: %5 (%6)")
+           .arg(msg.time().toString("yyyy-MM-dd hh:mm:ss.zzz"),
+                QString::number((quint64)(msg.threadId()), 16),
+                QString(me.valueToKey(msg.type())),
+                msg.category(),
+                msg.message(),
+                msg.location());
+}
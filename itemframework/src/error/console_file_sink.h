@@ -0,0 +1,89 @@
+#ifndef CONSOLEFILESINK_H
+#define CONSOLEFILESINK_H
+
+#include "appcore.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include "console_message.h"
+
+/**
+ * @brief The ConsoleFileSink class writes all ConsoleMessages to size rotated log files.
+ *
+ * The sink is optional and disabled by default. It is enabled by setting the global setting
+ * "ConsoleLogFile" to the path of the log file. When the file grows beyond "ConsoleLogFileMaxSize" bytes
+ * it is renamed to <path>.1 (older files are shifted up to <path>.<ConsoleLogFileCount - 1>) and a new file is started.
+ * So at most "ConsoleLogFileCount" files exist, including the current one.
+ *
+ * Messages are queued lock-free by the message handler and written in batches by a dedicated writer thread,
+ * so logging never waits for the disk.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ConsoleFileSink : public QThread
+{
+    Q_OBJECT
+    Q_CLASSINFO("dependsOn", "SettingsScope")
+
+public:
+    /**
+     * @brief The interval (in ms) in which the writer thread flushes queued messages to disk.
+     */
+    static const int FlushInterval = 250;
+
+    /**
+     * @brief Queues a message for the log file, if the sink is enabled. This Method is Threadsafe and lock-free.
+     * @param msg The message to write
+     */
+    static void log(const ConsoleMessage& msg);
+
+    /**
+     * @brief Reads the settings and starts the writer thread if the sink is enabled.
+     * Is called by the StartupHelper.
+     */
+    static void init();
+
+    /**
+     * @brief Writes all pending messages and stops the writer thread.
+     * Is called by the StartupHelper.
+     */
+    static void deinit();
+
+protected:
+    void run();
+
+private:
+    ConsoleFileSink(const QString& path, qint64 maxSize, int fileCount);
+
+    /**
+     * @brief Writes all queued messages. Called from the writer thread only.
+     */
+    void writePending();
+
+    /**
+     * @brief Writes \a batch to the current file and counts the written bytes. Called from the writer thread only.
+     */
+    void write(const QByteArray& batch);
+
+    /**
+     * @brief Closes the current file, shifts the older files and opens a new one. Called from the writer thread only.
+     */
+    void rotate();
+
+    bool openFile();
+
+    static QString formatMessage(const ConsoleMessage& msg);
+
+    const QString _path;
+    const qint64 _maxSize;
+    const int _fileCount;
+    QFile _file;
+    qint64 _written = 0;
+    bool _writeFailed = false; // the last write failed and was reported
+
+    QMutex _stopMutex;
+    QWaitCondition _stopCondition;
+    bool _stopRequested = false;
+};
+
+#endif // CONSOLEFILESINK_H
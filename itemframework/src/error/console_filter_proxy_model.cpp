@@ -0,0 +1,51 @@
+#include "console_filter_proxy_model.h"
+
+ConsoleFilterProxyModel::ConsoleFilterProxyModel(ConsoleModel* model, QObject* parent)
+    : QSortFilterProxyModel(parent), _model(model)
+{
+    setSourceModel(model);
+    connect(model, &ConsoleModel::indexesRebuilt, this, &ConsoleFilterProxyModel::updateMatches);
+}
+
+void ConsoleFilterProxyModel::setFilter(const ConsoleModel::Filter& filter)
+{
+    _filter = filter;
+    updateMatches();
+}
+
+const ConsoleModel::Filter& ConsoleFilterProxyModel::filter() const
+{
+    return _filter;
+}
+
+void ConsoleFilterProxyModel::updateMatches()
+{
+    _matches.clear();
+
+    if (!_filter.isEmpty()) {
+        const QVector<qint64> ids = _model->findMessages(_filter);
+        _matches.reserve(ids.size());
+
+        for (qint64 id : ids) {
+            _matches.insert(id);
+        }
+    }
+
+    _matchesEnd = _model->messageId(_model->rowCount(QModelIndex()));
+    invalidateFilter();
+}
+
+bool ConsoleFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
+{
+    if (_filter.isEmpty()) {
+        return true;
+    }
+
+    const qint64 id = _model->messageId(sourceRow);
+
+    if (id < _matchesEnd) { //message existed when the filter was set
+        return _matches.contains(id);
+    }
+
+    return _model->matches(sourceRow, _filter); //new message
+}
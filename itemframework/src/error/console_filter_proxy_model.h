@@ -0,0 +1,51 @@
+#ifndef CONSOLE_FILTER_PROXY_MODEL_H
+#define CONSOLE_FILTER_PROXY_MODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QSet>
+#include "console_model.h"
+
+/**
+ * @brief The ConsoleFilterProxyModel filters the rows of a ConsoleModel.
+ * The matching messages are looked up once in the indexes of the ConsoleModel when the filter changes,
+ * so accepting a row is only a set lookup. New messages are checked directly when they arrive.
+ */
+class ConsoleFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ConsoleFilterProxyModel(ConsoleModel* model, QObject* parent = nullptr);
+
+    /**
+     * @brief Sets the filter and updates the visible rows
+     */
+    void setFilter(const ConsoleModel::Filter& filter);
+
+    /**
+     * @brief Returns the current filter
+     */
+    const ConsoleModel::Filter& filter() const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const;
+
+private slots:
+    void updateMatches();
+
+private:
+    ConsoleModel* _model;
+    ConsoleModel::Filter _filter;
+
+    /**
+     * @brief The ids of the matching messages, which existed when the filter was set
+     */
+    QSet<qint64> _matches;
+
+    /**
+     * @brief The first message id which was not looked up
+     */
+    qint64 _matchesEnd = 0;
+};
+
+#endif // CONSOLE_FILTER_PROXY_MODEL_H
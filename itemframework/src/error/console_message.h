@@ -1,12 +1,13 @@
 #ifndef CONSOLE_MESSAGE_H
 #define CONSOLE_MESSAGE_H
 
+#include "appcore.h"
 #include <QString>
 #include <QDateTime>
 #include <QMessageLogContext>
 #include <QObject>
 
-class ConsoleMessage
+class ITEMFRAMEWORK_TEST_EXPORT ConsoleMessage
 {
     Q_GADGET
 public:
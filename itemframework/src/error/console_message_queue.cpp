@@ -0,0 +1,46 @@
+#include "console_message_queue.h"
+
+ConsoleMessageQueue::~ConsoleMessageQueue()
+{
+    Node* node = _head.fetchAndStoreAcquire(nullptr);
+
+    while (node != nullptr) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void ConsoleMessageQueue::push(const ConsoleMessage& msg)
+{
+    Node* node = new Node{msg, nullptr};
+    Node* head;
+
+    do { //Retry until no other producer changed the head in between
+        head = _head.loadAcquire();
+        node->next = head;
+    } while (!_head.testAndSetRelease(head, node));
+}
+
+QVector<ConsoleMessage> ConsoleMessageQueue::takeAll()
+{
+    Node* node = _head.fetchAndStoreAcquire(nullptr); //Detach the whole list at once
+
+    int count = 0;
+
+    for (Node* n = node; n != nullptr; n = n->next) {
+        ++count;
+    }
+
+    //The list is linked from newest to oldest, so fill the result from the back
+    QVector<ConsoleMessage> msgs(count);
+
+    while (node != nullptr) {
+        msgs[--count] = node->msg;
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+
+    return msgs;
+}
@@ -0,0 +1,46 @@
+#ifndef CONSOLEMESSAGEQUEUE_H
+#define CONSOLEMESSAGEQUEUE_H
+
+#include "appcore.h"
+#include <QAtomicPointer>
+#include <QVector>
+#include "console_message.h"
+
+/**
+ * @brief The ConsoleMessageQueue class is a lock-free queue for ConsoleMessages with many producers and one consumer.
+ * Producers (any thread) push single messages, the consumer takes all pending messages at once.
+ * Because the consumer never removes single nodes, the queue is not affected by the ABA problem.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ConsoleMessageQueue
+{
+public:
+    ConsoleMessageQueue() = default;
+    ConsoleMessageQueue(const ConsoleMessageQueue&) = delete;
+    ConsoleMessageQueue& operator=(const ConsoleMessageQueue&) = delete;
+    ~ConsoleMessageQueue();
+
+    /**
+     * @brief Appends a message to the queue. This Method is Threadsafe and never blocks.
+     * @param msg The message to append
+     */
+    void push(const ConsoleMessage& msg);
+
+    /**
+     * @brief Removes all pending messages from the queue. This Method is Threadsafe, but must only be called by one consumer.
+     * @return The pending messages in the order they were pushed
+     */
+    QVector<ConsoleMessage> takeAll();
+
+private:
+    struct Node {
+        ConsoleMessage msg;
+        Node* next;
+    };
+
+    /**
+     * @brief The most recently pushed node. The nodes are linked from newest to oldest.
+     */
+    QAtomicPointer<Node> _head;
+};
+
+#endif // CONSOLEMESSAGEQUEUE_H
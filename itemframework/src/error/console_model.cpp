@@ -1,8 +1,12 @@
 #include "console_model.h"
+#include "console_file_sink.h"
 #include "helper/startup_helper.h"
 #include <QBrush>
 #include <QMetaEnum>
 #include <QMutexLocker>
+#include <QRegExp>
+#include <QSet>
+#include <algorithm>
 #include <iterator>
 
 //--------------- Static & Initialization Stuff ----------------------
@@ -14,13 +18,16 @@ static ConsoleModel consoleModel; //The instnace of ConsoleModel which will be u
 static void msg_handler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
     original_message_handler(type, context, msg); //forward message to original handler
-    consoleModel.appendMessage(ConsoleMessage(type, context, msg)); //append message to model instance (where it will be buffered)
+    const ConsoleMessage consoleMessage(type, context, msg);
+    ConsoleFileSink::log(consoleMessage); //queue message for the log file (does nothing if the file sink is disabled)
+    consoleModel.appendMessage(consoleMessage); //append message to model instance (where it will be buffered)
 }
 
 static void register_msg_handler()
 {
     qRegisterMetaType<ConsoleMessage>();
     original_message_handler = qInstallMessageHandler(msg_handler); //Install our message handler and backup the previous handler
+    consoleModel.startTimer(ConsoleModel::DrainInterval); //The application exists now, so the model can drain its queue periodically
 }
 Q_COREAPP_STARTUP_FUNCTION(register_msg_handler) //Registers the handler, so that it will be called before QApplication::exec()
 
@@ -30,11 +37,90 @@ ConsoleModel* ConsoleModel::instance()
     return &consoleModel; //Return the static instance.
 }
 
+//Helpers for the indexes
+static quint64 trigramKey(const QChar* chars)
+{
+    return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | quint64(chars[2].unicode());
+}
+
+static QVector<qint64> intersectSorted(const QVector<qint64>& a, const QVector<qint64>& b)
+{
+    QVector<qint64> result;
+    std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(result));
+    return result;
+}
+
+static QVector<qint64> mergeSorted(const QVector<qint64>& a, const QVector<qint64>& b)
+{
+    QVector<qint64> result;
+    result.reserve(a.size() + b.size());
+    std::merge(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(result));
+    return result;
+}
+
 //------------------ Class Implementation ------------------------------
 
 ConsoleModel::ConsoleModel()
+    : _msgs(DefaultCapacity)
+{
+}
+
+void ConsoleModel::setCapacity(int capacity)
+{
+    if (capacity < 1 || capacity == _msgs.size()) {
+        return;
+    }
+
+    if (_count > capacity) {
+        removeRows(0, _count - capacity, QModelIndex()); //drop the oldest messages which do not fit anymore
+    }
+
+    QVector<ConsoleMessage> msgs(capacity);
+
+    for (int row = 0; row < _count; ++row) {
+        msgs[row] = messageAt(row);
+    }
+
+    _msgs.swap(msgs);
+    _first = 0;
+}
+
+int ConsoleModel::capacity() const
+{
+    return _msgs.size();
+}
+
+int ConsoleModel::slotForRow(int row) const
+{
+    return (_first + row) % _msgs.size();
+}
+
+const ConsoleMessage& ConsoleModel::messageAt(int row) const
+{
+    return _msgs.at(slotForRow(row));
+}
+
+int ConsoleModel::insertPosition(const QDateTime& time) const
 {
-    connect(this, &ConsoleModel::consoleMessageCreated, this, &ConsoleModel::insertMessageIntoModel);
+    if (_count == 0 || !(time < messageAt(_count - 1).time())) {
+        return _count; //the common case: the message is the newest one
+    }
+
+    //Messages from other threads can arrive out of order. Binary search for the first row which is newer.
+    int low = 0;
+    int high = _count - 1;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+
+        if (time < messageAt(mid).time()) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
 }
 
 bool ConsoleModel::removeRows(int row, int count, const QModelIndex& parent)
@@ -44,10 +130,34 @@ bool ConsoleModel::removeRows(int row, int count, const QModelIndex& parent)
     }
 
     beginRemoveRows(QModelIndex(), row, row + count - 1);
-    auto it = std::next(_msgs.begin(), row);
 
-    for (int r = 0; r < count; ++r) {
-        it = _msgs.erase(it);
+    if (row == 0) {
+        //Removing the oldest messages only moves the start of the ring
+        for (int r = 0; r < count; ++r) {
+            _msgs[slotForRow(r)] = ConsoleMessage();
+        }
+
+        _first = slotForRow(count);
+        _evicted += count; //Index entries of the removed messages are now stale and get pruned later
+
+        if (_evicted - _prunedUntil >= _msgs.size()) {
+            pruneIndexes();
+        }
+    } else {
+        //Move the messages behind the removed block to the front and release the vacated slots
+        for (int r = row; r < _count - count; ++r) {
+            _msgs[slotForRow(r)] = messageAt(r + count);
+        }
+
+        for (int r = _count - count; r < _count; ++r) {
+            _msgs[slotForRow(r)] = ConsoleMessage();
+        }
+    }
+
+    _count -= count;
+
+    if (row != 0) {
+        scheduleIndexRebuild(); //All following rows moved. Views remove filtered rows range by range, rebuild only once.
     }
 
     endRemoveRows();
@@ -56,22 +166,303 @@ bool ConsoleModel::removeRows(int row, int count, const QModelIndex& parent)
 
 void ConsoleModel::insertMessageIntoModel(ConsoleMessage msg)
 {
-    set_iterator it = _msgs.insert(msg); //insert new message at the correct position, and get the iterator to the new element
-    int ind = std::distance(_msgs.begin(), it); //Calculate index of new element
+    if (_count == _msgs.size()) {
+        //Buffer is full: drop a batch of the oldest messages at once, so that views are not notified for every new message
+        removeRows(0, std::max(1, _msgs.size() / 10), QModelIndex());
+    }
+
+    int ind = insertPosition(msg.time());
     beginInsertRows(QModelIndex(), ind, ind);
+
+    //Make room at the insert position. For in-order messages this loop does nothing.
+    for (int r = _count; r > ind; --r) {
+        _msgs[slotForRow(r)] = messageAt(r - 1);
+    }
+
+    _msgs[slotForRow(ind)] = msg;
+    ++_count;
+
+    if (ind != _count - 1) {
+        scheduleIndexRebuild(); //All following rows moved
+    } else if (!_indexesStale) {
+        indexRow(ind);
+    }
+
     endInsertRows();
 }
 
+void ConsoleModel::insertMessagesIntoModel(QVector<ConsoleMessage> msgs)
+{
+    //Messages from different threads can be out of order
+    std::stable_sort(msgs.begin(), msgs.end(), [](const ConsoleMessage & a, const ConsoleMessage & b) {
+        return a.time() < b.time();
+    });
+
+    //Messages which are older than the newest message in the model have to be sorted in one by one.
+    //The indexes are rebuilt once after the whole batch, not for every late message.
+    int first = 0;
+
+    while (first < msgs.size() && _count > 0 && msgs.at(first).time() < messageAt(_count - 1).time()) {
+        insertMessageIntoModel(msgs.at(first++));
+    }
+
+    //All remaining messages are appended as one block. Drop the ones which would not fit anyway.
+    first = std::max(first, msgs.size() - _msgs.size());
+    int count = msgs.size() - first;
+
+    if (count < 1) {
+        rebuildStaleIndexes();
+        return;
+    }
+
+    int overflow = _count + count - _msgs.size();
+
+    if (overflow > 0) {
+        removeRows(0, std::min(_count, std::max(overflow, _msgs.size() / 10)), QModelIndex());
+    }
+
+    beginInsertRows(QModelIndex(), _count, _count + count - 1);
+
+    for (int i = first; i < msgs.size(); ++i) {
+        _msgs[slotForRow(_count)] = msgs.at(i);
+
+        if (!_indexesStale) {
+            indexRow(_count);
+        }
+
+        ++_count;
+    }
+
+    endInsertRows();
+    rebuildStaleIndexes();
+}
+
+void ConsoleModel::indexRow(int row)
+{
+    const ConsoleMessage& msg = messageAt(row);
+    const qint64 id = messageId(row);
+
+    _typeIndex[msg.type()].append(id);
+
+    QVector<qint64>& categoryIds = _categoryIndex[msg.category()];
+
+    if (categoryIds.isEmpty()) {
+        emit categoryAdded(msg.category());
+    }
+
+    categoryIds.append(id);
+
+    //Every trigram of the (lower case) text of all columns. A message is added only once per trigram.
+    QStringList columns;
+
+    for (int column = 0; column < ConsoleModel::NumberOfColumns; ++column) {
+        columns.append(columnText(msg, column));
+    }
+
+    const QString text = columns.join('\n').toLower();
+    QSet<quint64> trigrams;
+
+    for (int i = 0; i + 2 < text.size(); ++i) {
+        trigrams.insert(trigramKey(text.constData() + i));
+    }
+
+    for (quint64 trigram : trigrams) {
+        _textIndex[trigram].append(id);
+    }
+}
+
+template<typename Key>
+static void pruneIndex(QHash<Key, QVector<qint64>>& index, qint64 firstValidId)
+{
+    for (auto it = index.begin(); it != index.end();) {
+        QVector<qint64>& ids = it.value();
+        ids.erase(ids.begin(), std::lower_bound(ids.begin(), ids.end(), firstValidId));
+
+        if (ids.isEmpty()) {
+            it = index.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ConsoleModel::pruneIndexes()
+{
+    pruneIndex(_typeIndex, _evicted);
+    pruneIndex(_categoryIndex, _evicted);
+    pruneIndex(_textIndex, _evicted);
+    _prunedUntil = _evicted;
+}
+
+void ConsoleModel::scheduleIndexRebuild()
+{
+    if (_indexesStale) {
+        return;
+    }
+
+    _indexesStale = true;
+    QMetaObject::invokeMethod(this, "rebuildStaleIndexes", Qt::QueuedConnection); //Rebuilt at the latest when control returns to the event loop
+}
+
+void ConsoleModel::rebuildStaleIndexes()
+{
+    if (!_indexesStale) {
+        return;
+    }
+
+    _typeIndex.clear();
+    _categoryIndex.clear();
+    _textIndex.clear();
+    _prunedUntil = _evicted;
+    _indexesStale = false;
+
+    for (int row = 0; row < _count; ++row) {
+        indexRow(row);
+    }
+
+    emit indexesRebuilt();
+}
+
+qint64 ConsoleModel::messageId(int row) const
+{
+    return _evicted + row;
+}
+
+QStringList ConsoleModel::categories() const
+{
+    return _categoryIndex.keys();
+}
+
+bool ConsoleModel::Filter::isEmpty() const
+{
+    return types.isEmpty() && category.isEmpty() && text.isEmpty();
+}
+
+bool ConsoleModel::textMatches(const ConsoleMessage& msg, const QRegExp& rx)
+{
+    for (int column = 0; column < ConsoleModel::NumberOfColumns; ++column) {
+        if (columnText(msg, column).contains(rx)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ConsoleModel::matches(int row, const Filter& filter) const
+{
+    if (row < 0 || row >= _count) {
+        return false;
+    }
+
+    const ConsoleMessage& msg = messageAt(row);
+
+    if (!filter.types.isEmpty() && !filter.types.contains(msg.type())) {
+        return false;
+    }
+
+    if (!filter.category.isEmpty() && msg.category() != filter.category) {
+        return false;
+    }
+
+    return filter.text.isEmpty() || textMatches(msg, QRegExp(filter.text, Qt::CaseInsensitive, QRegExp::Wildcard));
+}
+
+QVector<qint64> ConsoleModel::findMessages(const Filter& filter) const
+{
+    if (_indexesStale) { //Rows moved since the last rebuild, check every message directly until the indexes are rebuilt
+        QVector<qint64> result;
+
+        for (int row = 0; row < _count; ++row) {
+            if (matches(row, filter)) {
+                result.append(messageId(row));
+            }
+        }
+
+        return result;
+    }
+
+    QVector<qint64> candidates;
+    bool restricted = false;
+
+    auto restrict = [&](const QVector<qint64>& ids) {
+        candidates = restricted ? intersectSorted(candidates, ids) : ids;
+        restricted = true;
+    };
+
+    if (!filter.types.isEmpty()) {
+        QVector<qint64> ids;
+
+        for (ConsoleMessage::MsgType type : filter.types) {
+            ids = mergeSorted(ids, _typeIndex.value(type));
+        }
+
+        restrict(ids);
+    }
+
+    if (!filter.category.isEmpty()) {
+        restrict(_categoryIndex.value(filter.category));
+    }
+
+    //Every literal part of the wildcard must be contained in the message, so all of its trigrams must be in the index.
+    //Character classes ([...]) can not be looked up, the wildcard check below handles them.
+    const QString text = filter.text.toLower();
+
+    if (!text.contains('[')) {
+        for (const QString& part : text.split(QRegExp("[*?]"), QString::SkipEmptyParts)) {
+            for (int i = 0; i + 2 < part.size() && (!restricted || !candidates.isEmpty()); ++i) {
+                restrict(_textIndex.value(trigramKey(part.constData() + i)));
+            }
+        }
+    }
+
+    if (!restricted) {
+        candidates.reserve(_count);
+
+        for (int row = 0; row < _count; ++row) {
+            candidates.append(messageId(row));
+        }
+    }
+
+    //Drop index entries of already removed messages
+    candidates.erase(candidates.begin(), std::lower_bound(candidates.begin(), candidates.end(), _evicted));
+
+    if (filter.text.isEmpty()) {
+        return candidates;
+    }
+
+    //The trigrams only preselect the messages, the wildcard itself still has to be checked
+    const QRegExp rx(filter.text, Qt::CaseInsensitive, QRegExp::Wildcard);
+    QVector<qint64> result;
+
+    for (qint64 id : candidates) {
+        if (textMatches(messageAt(id - _evicted), rx)) {
+            result.append(id);
+        }
+    }
+
+    return result;
+}
+
+void ConsoleModel::timerEvent(QTimerEvent*)
+{
+    QVector<ConsoleMessage> msgs = _pending.takeAll();
+
+    if (!msgs.isEmpty()) {
+        insertMessagesIntoModel(msgs);
+    }
+}
+
 void ConsoleModel::appendMessage(const ConsoleMessage msg)
 {
-    emit consoleMessageCreated(msg);
-    //emit signal that is connected to the method above, to ensure that the insertion happens in the Thread which owns this model (GUI-Thread)
+    _pending.push(msg);
+    //The message is inserted by the next timerEvent(), to ensure that the insertion happens in the Thread which owns this model (GUI-Thread)
 }
 
 
 int ConsoleModel::rowCount(const QModelIndex&) const
 {
-    return _msgs.size();
+    return _count;
 }
 
 int ConsoleModel::columnCount(const QModelIndex&) const
@@ -81,11 +472,11 @@ int ConsoleModel::columnCount(const QModelIndex&) const
 
 QVariant ConsoleModel::data(const QModelIndex& index, int role) const
 {
-    if (index.row() < 0 || (size_t)(index.row()) >= _msgs.size()) { //row out of bounds
+    if (index.row() < 0 || index.row() >= _count) { //row out of bounds
         return QVariant();
     }
 
-    const ConsoleMessage& msg = *(std::next(_msgs.cbegin(), index.row()));
+    const ConsoleMessage& msg = messageAt(index.row());
 
     if (role == Qt::ForegroundRole && index.column() == ConsoleModel::Type) { //color for type column
         return QVariant::fromValue(QBrush(ConsoleMessage::colorForMsgType(msg.type())));
@@ -95,32 +486,39 @@ QVariant ConsoleModel::data(const QModelIndex& index, int role) const
         return QVariant::fromValue(msg);
     }
 
-    if (role == Qt::DisplayRole) { //Text requested
-        switch (index.column()) {
-        case ConsoleModel::Type: {
-            const QMetaEnum& me = QMetaEnum::fromType<ConsoleMessage::MsgType>();
-            return me.valueToKey(msg.type()); //Return untranslated(!) enum key
-        }
+    if (role == Qt::DisplayRole && index.column() >= 0 && index.column() < ConsoleModel::NumberOfColumns) { //Text requested
+        return columnText(msg, index.column());
+    }
 
-        case ConsoleModel::Message:
-            return msg.message(); //Return untranslated(!) message
+    return QVariant();
+}
 
-        case ConsoleModel::Category:
-            return msg.category();
+QString ConsoleModel::columnText(const ConsoleMessage& msg, int column)
+{
+    switch (column) {
+    case ConsoleModel::Type: {
+        const QMetaEnum& me = QMetaEnum::fromType<ConsoleMessage::MsgType>();
+        return me.valueToKey(msg.type()); //Return untranslated(!) enum key
+    }
 
-        case ConsoleModel::Location:
-            return msg.location();
+    case ConsoleModel::Message:
+        return msg.message(); //Return untranslated(!) message
 
-        case ConsoleModel::Time:
-            return msg.time().toString("hh:mm:ss.z");
+    case ConsoleModel::Category:
+        return msg.category();
 
-        case ConsoleModel::Thread:
-            return QString("0x%1").arg(QString::number((quint64)(msg.threadId()), 16));
+    case ConsoleModel::Location:
+        return msg.location();
+
+    case ConsoleModel::Time:
+        return msg.time().toString("hh:mm:ss.z");
+
+    case ConsoleModel::Thread:
+        return QString("0x%1").arg(QString::number((quint64)(msg.threadId()), 16));
 
-        }
     }
 
-    return QVariant();
+    return QString();
 }
 
 QVariant ConsoleModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -1,13 +1,18 @@
 #ifndef CONSOLEMODEL_H
 #define CONSOLEMODEL_H
 
+#include "appcore.h"
 #include <QObject>
 #include <QAbstractTableModel>
 #include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QRegExp>
 #include "console_message.h"
-#include <set>
+#include "console_message_queue.h"
 
-class ConsoleModel : public QAbstractTableModel
+class ITEMFRAMEWORK_TEST_EXPORT ConsoleModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
@@ -38,11 +43,72 @@ public:
     static ConsoleModel* instance();
 
     /**
-     * @brief Appends a new ConsoleMessage to the model. This Method is Threadsafe.
+     * @brief Appends a new ConsoleMessage to the model. This Method is Threadsafe and lock-free.
+     * The message is queued and shows up in the model after the next drain (see DrainInterval).
      * @param msg
      */
     void appendMessage(const ConsoleMessage msg);
 
+    /**
+     * @brief The number of messages the model keeps if no other capacity was set.
+     */
+    static const int DefaultCapacity = 10000;
+
+    /**
+     * @brief The interval (in ms) in which queued messages are inserted into the model.
+     */
+    static const int DrainInterval = 50;
+
+    /**
+     * @brief Sets the maximum number of messages the model keeps.
+     * If the model is full, the oldest messages are removed to make room for new ones.
+     * Shrinking the capacity removes the oldest messages immediately.
+     * @param capacity The new capacity. Must be at least 1.
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief Returns the maximum number of messages the model keeps.
+     * \sa setCapacity()
+     */
+    int capacity() const;
+
+    /**
+     * @brief The Filter struct describes a subset of the messages. Empty members match all messages.
+     */
+    struct Filter {
+        QList<ConsoleMessage::MsgType> types; /*<! The message must have one of these types */
+        QString category; /*<! The message must have exactly this category */
+        QString text; /*<! Case insensitive wildcard, which must match the text of at least one column */
+
+        bool isEmpty() const;
+    };
+
+    /**
+     * @brief Returns the ids of all messages matching the passed filter, in ascending order.
+     * The type, category and text indexes are used, so only a few messages have to be checked directly.
+     * While the indexes are stale (see indexesRebuilt()) all messages are checked directly.
+     * \sa messageId()
+     */
+    QVector<qint64> findMessages(const Filter& filter) const;
+
+    /**
+     * @brief Checks a single row against the passed filter, without using the indexes.
+     */
+    bool matches(int row, const Filter& filter) const;
+
+    /**
+     * @brief Returns the id of the message in the passed row.
+     * Ids grow with every appended message and stay valid until rows are inserted or removed in the middle of the model.
+     * The indexes are rebuilt afterwards and indexesRebuilt() is emitted.
+     */
+    qint64 messageId(int row) const;
+
+    /**
+     * @brief Returns all categories of the currently stored messages.
+     */
+    QStringList categories() const;
+
     ConsoleModel();
     int rowCount(const QModelIndex& parent) const;
     int columnCount(const QModelIndex& parent) const;
@@ -52,32 +118,106 @@ public:
 
 signals:
     /**
-     * @brief Internal signal, which is used to ensure that the new messages are inserted from the Object owning thread.
-     * Use appendMessage() instead of this signal.
-     * @param msg The new message to insert.
+     * @brief Emitted when a message with a new category was stored.
      */
-    void consoleMessageCreated(const ConsoleMessage msg);
+    void categoryAdded(const QString& category);
+
+    /**
+     * @brief Emitted after messages were inserted or removed in the middle of the model and the indexes were rebuilt.
+     * All message ids changed, so results of findMessages() have to be requested again.
+     * Late messages are rebuilt once per drain, removals once the event loop is reached.
+     */
+    void indexesRebuilt();
+
+private slots:
+    /**
+     * @brief Rebuilds the indexes from scratch if they are stale and emits indexesRebuilt()
+     */
+    void rebuildStaleIndexes();
+
+protected:
+    /**
+     * @brief Drains the message queue and inserts all pending messages at once
+     */
+    void timerEvent(QTimerEvent* event);
 
 private:
 
     /**
-     * @brief Comperator used with std::multiset to sort the ConsoleMessages by time (ascending)
+     * @brief Returns the message in the passed row in constant time. The row must be in bounds.
      */
-    struct MsgComperator : std::binary_function <ConsoleMessage, ConsoleMessage, bool> {
-        bool operator()(const ConsoleMessage& a, const ConsoleMessage& b)
-        {
-            return a.time() < b.time();
-        }
-    };
+    const ConsoleMessage& messageAt(int row) const;
 
     /**
-     * @brief Buffer for the Console Messages.
-     * Can be cleared by calling removeRows().
+     * @brief Maps a row to its slot in the ring buffer
      */
-    std::multiset<ConsoleMessage, MsgComperator> _msgs;
-    using set_iterator = std::multiset<ConsoleMessage, MsgComperator>::iterator;
-private slots:
+    int slotForRow(int row) const;
+
+    /**
+     * @brief Returns the row where a message with the passed time has to be inserted to keep the rows sorted by time (ascending)
+     */
+    int insertPosition(const QDateTime& time) const;
+
+    /**
+     * @brief Returns the text which is shown in the passed column for the passed message
+     */
+    static QString columnText(const ConsoleMessage& msg, int column);
+
+    /**
+     * @brief Returns whether the wildcard matches the text of one of the columns
+     */
+    static bool textMatches(const ConsoleMessage& msg, const QRegExp& rx);
+
+    /**
+     * @brief Adds the message in the passed row to the indexes. The row must be the newest one.
+     */
+    void indexRow(int row);
+
+    /**
+     * @brief Removes the entries of already removed messages from the indexes
+     */
+    void pruneIndexes();
+
+    /**
+     * @brief Marks the indexes as stale, after rows were inserted or removed in the middle of the model.
+     * They are rebuilt at the end of the current drain, or once control returns to the event loop.
+     */
+    void scheduleIndexRebuild();
+
+    /**
+     * @brief Ring buffer for the Console Messages, sorted by time (ascending).
+     * The oldest message is located at _first. Can be cleared by calling removeRows().
+     */
+    QVector<ConsoleMessage> _msgs;
+    int _first = 0;
+    int _count = 0;
+
+    /**
+     * @brief Number of messages removed from the front. The id of a message is _evicted + row.
+     */
+    qint64 _evicted = 0;
+    qint64 _prunedUntil = 0;
+
+    /**
+     * @brief Set while the indexes do not match the rows anymore. New rows are not indexed until the rebuild.
+     */
+    bool _indexesStale = false;
+
+    /**
+     * @brief Indexes mapping types, categories and lower case trigrams of the column texts to sorted message ids.
+     * They can contain ids of removed messages (< _evicted), which are pruned from time to time.
+     */
+    QHash<int, QVector<qint64>> _typeIndex;
+    QHash<QString, QVector<qint64>> _categoryIndex;
+    QHash<quint64, QVector<qint64>> _textIndex;
+
+    /**
+     * @brief Messages which were appended, but are not yet inserted into the model
+     */
+    ConsoleMessageQueue _pending;
+
     void insertMessageIntoModel(const ConsoleMessage msg);
+    void insertMessagesIntoModel(QVector<ConsoleMessage> msgs);
 };
 
 #endif // CONSOLEMODEL_H
@@ -6,13 +6,31 @@
 #include "console_message.h"
 #include "console_model.h"
 
-ConsoleWidget::ConsoleWidget(QAbstractTableModel* model):
-    ui(new Ui::ConsoleWidget)
+ConsoleWidget::ConsoleWidget(ConsoleModel* model):
+    ui(new Ui::ConsoleWidget),
+    _proxyModel(model)
 {
     ui->setupUi(this);
-    _proxyModel.setSourceModel(model);
-    _proxyModel.setFilterKeyColumn(-1); //filter on all columns
-    _proxyModel.setFilterCaseSensitivity(Qt::CaseInsensitive); //case intensitive
+
+    //Type filter: all types or a single one
+    ui->cbType->addItem(tr("All Types"));
+    const QMetaEnum& me = QMetaEnum::fromType<ConsoleMessage::MsgType>();
+
+    for (int i = 0; i < me.keyCount(); ++i) {
+        ui->cbType->addItem(me.key(i), me.value(i));
+    }
+
+    //Category filter: all categories or a single one. New categories are added as they appear.
+    ui->cbCategory->addItem(tr("All Categories"));
+
+    for (const QString& category : model->categories()) {
+        addCategory(category);
+    }
+
+    connect(model, &ConsoleModel::categoryAdded, this, &ConsoleWidget::addCategory);
+    connect(ui->cbType, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &ConsoleWidget::typeFilterChanged);
+    connect(ui->cbCategory, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &ConsoleWidget::categoryFilterChanged);
+
     ui->tvOutput->setModel(&_proxyModel);
     ui->tvOutput->horizontalHeader()->setSectionsMovable(true);
     ui->tvOutput->verticalHeader()->setDefaultSectionSize(15);
@@ -27,7 +45,35 @@ ConsoleWidget::~ConsoleWidget()
 
 void ConsoleWidget::filterChanged(QString text)
 {
-    _proxyModel.setFilterWildcard(text);
+    ConsoleModel::Filter filter = _proxyModel.filter();
+    filter.text = text;
+    _proxyModel.setFilter(filter);
+}
+
+void ConsoleWidget::typeFilterChanged(int index)
+{
+    ConsoleModel::Filter filter = _proxyModel.filter();
+    filter.types.clear();
+
+    if (index > 0) { //first entry is "All Types"
+        filter.types.append(static_cast<ConsoleMessage::MsgType>(ui->cbType->itemData(index).toInt()));
+    }
+
+    _proxyModel.setFilter(filter);
+}
+
+void ConsoleWidget::categoryFilterChanged(int index)
+{
+    ConsoleModel::Filter filter = _proxyModel.filter();
+    filter.category = (index > 0) ? ui->cbCategory->itemText(index) : QString(); //first entry is "All Categories"
+    _proxyModel.setFilter(filter);
+}
+
+void ConsoleWidget::addCategory(const QString& category)
+{
+    if (!category.isEmpty() && ui->cbCategory->findText(category, Qt::MatchExactly) < 0) {
+        ui->cbCategory->addItem(category);
+    }
 }
 
 void ConsoleWidget::clearPressed()
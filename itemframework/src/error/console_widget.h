@@ -2,8 +2,7 @@
 #define CONSOLE_WIDGET_H
 
 #include <QDockWidget>
-#include <QAbstractTableModel>
-#include <QSortFilterProxyModel>
+#include "console_filter_proxy_model.h"
 
 namespace Ui
 {
@@ -12,17 +11,20 @@ class ConsoleWidget;
 
 /**
  * @brief The ConsoleWidget shows the contents of ConsoleModel::instance() (an QAbstractTableModel) in a QTableView.
- * It also provides a lineedit to allow fulltext filtering.
+ * It also provides a lineedit to allow fulltext filtering and comboboxes to filter by type and category.
  */
 class ConsoleWidget : public QDockWidget
 {
     Q_OBJECT
 
 public:
-    explicit ConsoleWidget(QAbstractTableModel* model);
+    explicit ConsoleWidget(ConsoleModel* model);
     ~ConsoleWidget();
 private slots:
     void filterChanged(QString text);
+    void typeFilterChanged(int index);
+    void categoryFilterChanged(int index);
+    void addCategory(const QString& category);
     void clearPressed();
     void tableContextMenu(QPoint pos);
 
@@ -30,9 +32,9 @@ private:
     Ui::ConsoleWidget* ui;
 
     /**
-     * @brief Proxy Model used for fulltext filter
+     * @brief Proxy Model used for the type, category and fulltext filter
      */
-    QSortFilterProxyModel _proxyModel;
+    ConsoleFilterProxyModel _proxyModel;
 };
 
 #endif // CONSOLE_WIDGET_H
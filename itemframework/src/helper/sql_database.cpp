@@ -1,69 +1,176 @@
 #include "helper/sql_database_p.h"
 #include <QDebug>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QThread>
 
-DatabaseHolder::DatabaseHolder(SqlDatabase db) : _database(db)
+SqlDatabase::SqlDatabase()
 {
-    //qDebug() << "Creating DB holder to db with driver" << db.driver();
+
 }
 
-DatabaseHolder::~DatabaseHolder()
+SqlDatabase::SqlDatabase(const QString& type) : QSqlDatabase(type)
 {
-    //qDebug() << "Destroying DB holder to db with driver" << _database.driver();
+
 }
 
-//Custom deleter function for DatabaseHolder's
-static void deleteQObject(DatabaseHolder* p)
+
+SqlQuery SqlDatabase::exec(const QString& query) const
 {
-    if (p != nullptr) {
-        p->deleteLater(); //delete object when the eventloop regains control
-    }
+    return SqlQuery(query, *this);
 }
 
+SqlDatabase SqlDatabase::clone() const
+{
+    SqlDatabase database(driverName());
+    database.setDatabaseName(databaseName());
+    database.setHostName(hostName());
+    database.setPort(port());
+    database.setUserName(userName());
+    database.setPassword(password());
+    database.setConnectOptions(connectOptions());
+    database.setNumericalPrecisionPolicy(numericalPrecisionPolicy());
+    return database;
+}
 
-SqlDatabase::SqlDatabase()
+SqlQuery::SqlQuery()
 {
 
 }
 
-SqlDatabase::SqlDatabase(const QString& type) : QSqlDatabase(type)
+SqlQuery::~SqlQuery()
+{
+    //The database is released by the SqlQueryDatabase base, after the QSqlQuery base was destroyed
+}
+
+SqlQuery::SqlQuery(const QString& query, SqlDatabase db) :
+    SqlQueryDatabase(db),
+    QSqlQuery(query, db)
 {
 
 }
 
+SqlQuery::SqlQuery(SqlDatabase db) :
+    SqlQueryDatabase(db),
+    QSqlQuery(db)
+{
 
-SqlQuery SqlDatabase::exec(const QString& query) const
+}
+
+SqlDatabase SqlQuery::database() const
 {
-    return SqlQuery(query, *this);
+    return _database;
 }
 
-SqlQuery::SqlQuery()
+SqlThreadConnection::SqlThreadConnection(const SqlDatabase& database, int maxCachedStatements) :
+    _database(database),
+    _statements(maxCachedStatements)
 {
 
 }
 
-SqlQuery::~SqlQuery()
+SqlConnectionPoolPrivate::SqlConnectionPoolPrivate(const SqlDatabase& database, int maxCachedStatements) :
+    _database(database),
+    _maxCachedStatements(maxCachedStatements)
 {
-    //qDebug() << "Scheduling deletion of holder to db with driver" << _deleter->_database.driver();
+
 }
 
-SqlQuery::SqlQuery(const QString& query, SqlDatabase db) :
-    QSqlQuery(query, db),
-    _deleter(new DatabaseHolder{db}, &deleteQObject)
+SqlThreadConnection* SqlConnectionPoolPrivate::connection()
 {
+    QThread* thread = QThread::currentThread();
+    QMutexLocker locker(&_mutex);
+    SqlThreadConnection* threadConnection = _connections.value(thread);
+
+    if (threadConnection == nullptr) {
+        threadConnection = new SqlThreadConnection(_database.clone(), _maxCachedStatements);
+        _connections.insert(thread, threadConnection);
+
+        //The finished signal is emitted by the thread itself, so the connection is closed by the thread which opened it
+        QObject::connect(thread, &QThread::finished, &_context, [this, thread]() {
+            releaseConnection(thread);
+        }, Qt::DirectConnection);
+    }
+
+    locker.unlock();
+
+    if (!threadConnection->_database.isOpen() && !threadConnection->_database.open()) {
+        qWarning() << "Could not open database" << threadConnection->_database.databaseName()
+                   << threadConnection->_database.lastError().text();
+    }
 
+    return threadConnection;
 }
 
-SqlQuery::SqlQuery(SqlDatabase db) :
-    QSqlQuery(db),
-    _deleter(new DatabaseHolder{db}, &deleteQObject)
+SqlQuery SqlConnectionPoolPrivate::prepare(const QString& query, bool* isPrepared)
 {
+    SqlThreadConnection* threadConnection = connection();
+    SqlQuery* cachedStatement = threadConnection->_statements.object(query);
+
+    if (cachedStatement != nullptr) {
+        cachedStatement->finish();
+        *isPrepared = true;
+        return *cachedStatement;
+    }
+
+    SqlQuery statement(threadConnection->_database);
+    *isPrepared = statement.prepare(query);
 
+    //A failed statement is not cached, its lastError() tells why
+    if (*isPrepared) {
+        threadConnection->_statements.insert(query, new SqlQuery(statement));
+    }
+
+    return statement;
 }
 
-SqlDatabase SqlQuery::database() const
+void SqlConnectionPoolPrivate::releaseConnection(QThread* thread)
 {
-    return (!_deleter.isNull()) ? _deleter->_database : SqlDatabase();
+    QMutexLocker locker(&_mutex);
+    delete _connections.take(thread);
 }
 
+SqlConnectionPool::SqlConnectionPool(const SqlDatabase& database, int maxCachedStatements) :
+    d_ptr{new SqlConnectionPoolPrivate{database, maxCachedStatements}}
+{
 
+}
 
+SqlConnectionPool::~SqlConnectionPool()
+{
+    Q_D(SqlConnectionPool);
+    QMutexLocker locker(&d->_mutex);
+    qDeleteAll(d->_connections);
+    d->_connections.clear();
+}
+
+SqlDatabase SqlConnectionPool::database()
+{
+    Q_D(SqlConnectionPool);
+    return d->connection()->_database;
+}
+
+SqlQuery SqlConnectionPool::prepare(const QString& query)
+{
+    Q_D(SqlConnectionPool);
+    bool isPrepared;
+    return d->prepare(query, &isPrepared);
+}
+
+SqlQuery SqlConnectionPool::exec(const QString& query, const QVariantList& values)
+{
+    Q_D(SqlConnectionPool);
+    bool isPrepared;
+    SqlQuery statement = d->prepare(query, &isPrepared);
+
+    if (!isPrepared) {
+        return statement;
+    }
+
+    for (int i = 0; i < values.count(); i++) {
+        statement.bindValue(i, values.at(i));
+    }
+
+    statement.exec();
+    return statement;
+}
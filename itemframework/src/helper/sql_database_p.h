@@ -2,15 +2,47 @@
 #define SQL_DATABASE_P_H
 
 #include "helper/sql_database.h"
+#include <QCache>
+#include <QHash>
+#include <QMutex>
 
-class DatabaseHolder : public QObject
+class QThread;
+
+/**
+ * @brief The connection of one thread and its prepared statements
+ */
+struct SqlThreadConnection {
+    explicit SqlThreadConnection(const SqlDatabase& database, int maxCachedStatements);
+
+    SqlDatabase _database;
+    QCache<QString, SqlQuery> _statements; // by sql text
+};
+
+class SqlConnectionPoolPrivate
 {
-    Q_OBJECT
 public:
-    DatabaseHolder(SqlDatabase db);
-    ~DatabaseHolder();
-    SqlDatabase _database;
+    SqlConnectionPoolPrivate(const SqlDatabase& database, int maxCachedStatements);
+
+    /**
+     * @brief Returns the connection of the calling thread, it is created on first use.
+     */
+    SqlThreadConnection* connection();
+
+    /**
+     * @brief Returns the cached statement for \a query of the calling thread, or prepares and caches it.
+     */
+    SqlQuery prepare(const QString& query, bool* isPrepared);
+
+    /**
+     * @brief Deletes the connection of \a thread. Called by the finishing thread itself, which opened the connection.
+     */
+    void releaseConnection(QThread* thread);
+
+    SqlDatabase _database; // configured, only cloned
+    int _maxCachedStatements;
+    QMutex _mutex; // for _connections
+    QHash<QThread*, SqlThreadConnection*> _connections;
+    QObject _context; // disconnects the finished signals of the threads, once the pool is destroyed
 };
 
 #endif // SQL_DATABASE_P_H
-
@@ -0,0 +1,234 @@
+#include "helper/sql_query_worker_p.h"
+#include <QMutexLocker>
+#include <QPointer>
+
+//The number of undelivered batches a query may have, before fetching waits for the handle
+static const int MaxPendingBatches = 4;
+
+//Rows reserved for a batch up front, larger batches grow with the fetched rows
+static const int MaxReservedRows = 1024;
+
+SqlAsyncQuery::SqlAsyncQuery(const QSharedPointer<SqlAsyncQueryState>& state, QObject* requester) :
+    QObject(requester),
+    _state(state)
+{
+
+}
+
+SqlAsyncQuery::~SqlAsyncQuery()
+{
+    QMutexLocker locker(&_state->_mutex);
+    _state->_query = nullptr;
+    _state->_isCancelled.storeRelease(1);
+    _state->_delivered.wakeAll();
+}
+
+void SqlAsyncQuery::cancel()
+{
+    SqlQueryWorkerPrivate::cancel(_state.data());
+    deleteLater();
+}
+
+bool SqlAsyncQuery::isCancelled() const
+{
+    return _state->_isCancelled.loadAcquire() != 0;
+}
+
+void SqlAsyncQuery::deliver()
+{
+    QVector<QVector<QSqlRecord>> batches;
+    bool isFinished;
+    QSqlError error;
+
+    {
+        QMutexLocker locker(&_state->_mutex);
+        batches.swap(_state->_batches);
+        isFinished = _state->_isFinished;
+        error = _state->_error;
+        _state->_delivered.wakeAll();
+    }
+
+    //A receiver may cancel the query or delete its requester, and with it this handle
+    QPointer<SqlAsyncQuery> guard(this);
+
+    for (const QVector<QSqlRecord>& rows : batches) {
+        if (isCancelled()) {
+            return;
+        }
+
+        emit rowsFetched(rows);
+
+        if (guard.isNull()) {
+            return;
+        }
+    }
+
+    if (!isFinished || _isFinished || isCancelled()) {
+        return;
+    }
+
+    _isFinished = true;
+    emit finished(error);
+
+    if (!guard.isNull()) {
+        deleteLater();
+    }
+}
+
+SqlQueryWorkerPrivate::SqlQueryWorkerPrivate(const SqlDatabase& database) :
+    _pool(database)
+{
+
+}
+
+void SqlQueryWorkerPrivate::execute(const SqlQueryJob& job)
+{
+    SqlAsyncQueryState* state = job._state.data();
+
+    if (state->_isCancelled.loadAcquire() != 0) {
+        return;
+    }
+
+    SqlQuery query = _pool.exec(job._query, job._values);
+
+    if (!query.isActive()) {
+        post(state, QVector<QSqlRecord>(), true, query.lastError());
+        return;
+    }
+
+    QVector<QSqlRecord> rows;
+    rows.reserve(qMin(job._batchSize, MaxReservedRows));
+
+    while (state->_isCancelled.loadAcquire() == 0 && query.next()) {
+        rows.append(query.record());
+
+        if (rows.count() >= job._batchSize) {
+            if (!post(state, rows, false, QSqlError())) {
+                break;
+            }
+
+            rows.clear();
+        }
+    }
+
+    const QSqlError error = query.lastError();
+
+    //Releases the result set (e.g. the read lock of sqlite), the prepared statement stays cached in the pool
+    query.finish();
+    post(state, rows, true, error);
+}
+
+bool SqlQueryWorkerPrivate::post(SqlAsyncQueryState* state, const QVector<QSqlRecord>& rows, bool isFinished,
+                                 const QSqlError& error)
+{
+    QMutexLocker locker(&state->_mutex);
+
+    //Fetching waits until the handle caught up, so a large result is never kept in memory at once
+    while (!isFinished && state->_batches.count() >= MaxPendingBatches && state->_isCancelled.loadAcquire() == 0) {
+        state->_delivered.wait(&state->_mutex);
+    }
+
+    if (state->_query == nullptr || state->_isCancelled.loadAcquire() != 0) {
+        return false;
+    }
+
+    if (!rows.isEmpty()) {
+        state->_batches.append(rows);
+    }
+
+    state->_isFinished = isFinished;
+    state->_error = error;
+    QMetaObject::invokeMethod(state->_query, "deliver", Qt::QueuedConnection);
+    return true;
+}
+
+void SqlQueryWorkerPrivate::cancel(SqlAsyncQueryState* state)
+{
+    state->_isCancelled.storeRelease(1);
+
+    //Locking ensures the worker either sees the flag or already waits for the wake
+    QMutexLocker locker(&state->_mutex);
+    state->_batches.clear();
+    state->_delivered.wakeAll();
+}
+
+SqlQueryWorker::SqlQueryWorker(const SqlDatabase& database, QObject* parent) :
+    QThread(parent),
+    d_ptr{new SqlQueryWorkerPrivate{database}}
+{
+    start();
+}
+
+SqlQueryWorker::~SqlQueryWorker()
+{
+    Q_D(SqlQueryWorker);
+
+    {
+        QMutexLocker locker(&d->_mutex);
+        d->_stopRequested = true;
+
+        for (const SqlQueryJob& job : d->_jobs) {
+            SqlQueryWorkerPrivate::cancel(job._state.data());
+        }
+
+        d->_jobs.clear();
+
+        if (!d->_current.isNull()) {
+            SqlQueryWorkerPrivate::cancel(d->_current.data());
+        }
+
+        d->_jobAdded.wakeAll();
+    }
+
+    wait();
+}
+
+SqlAsyncQuery* SqlQueryWorker::exec(const QString& query, QObject* requester, const QVariantList& values, int batchSize)
+{
+    Q_D(SqlQueryWorker);
+    QSharedPointer<SqlAsyncQueryState> state(new SqlAsyncQueryState);
+    SqlAsyncQuery* asyncQuery = new SqlAsyncQuery(state, requester);
+    state->_query = asyncQuery;
+
+    SqlQueryJob job;
+    job._query = query;
+    job._values = values;
+    job._batchSize = qMax(1, batchSize);
+    job._state = state;
+
+    QMutexLocker locker(&d->_mutex);
+    d->_jobs.enqueue(job);
+    d->_jobAdded.wakeOne();
+    return asyncQuery;
+}
+
+void SqlQueryWorker::run()
+{
+    Q_D(SqlQueryWorker);
+
+    forever {
+        SqlQueryJob job;
+
+        {
+            QMutexLocker locker(&d->_mutex);
+
+            while (d->_jobs.isEmpty() && !d->_stopRequested) {
+                d->_jobAdded.wait(&d->_mutex);
+            }
+
+            if (d->_stopRequested) {
+                break;
+            }
+
+            job = d->_jobs.dequeue();
+            d->_current = job._state;
+        }
+
+        d->execute(job);
+
+        QMutexLocker locker(&d->_mutex);
+        d->_current.clear();
+    }
+
+    //The connection of this thread is closed by the pool, when the thread finished
+}
@@ -0,0 +1,60 @@
+#ifndef SQL_QUERY_WORKER_P_H
+#define SQL_QUERY_WORKER_P_H
+
+#include "helper/sql_query_worker.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+/**
+ * @brief The state of one query, shared by the worker thread and the handle in the requesting thread
+ */
+struct SqlAsyncQueryState {
+    QMutex _mutex; // for all members except _isCancelled
+    QWaitCondition _delivered; // woken when the handle took the pending batches, or the query was cancelled
+    SqlAsyncQuery* _query = nullptr; // null once the handle was destroyed
+    QAtomicInt _isCancelled;
+    QVector<QVector<QSqlRecord>> _batches; // fetched, but not delivered yet
+    bool _isFinished = false;
+    QSqlError _error;
+};
+
+struct SqlQueryJob {
+    QString _query;
+    QVariantList _values;
+    int _batchSize;
+    QSharedPointer<SqlAsyncQueryState> _state;
+};
+
+class SqlQueryWorkerPrivate
+{
+public:
+    explicit SqlQueryWorkerPrivate(const SqlDatabase& database);
+
+    /**
+     * @brief Executes \a job on the calling (worker) thread and posts its rows to the handle.
+     */
+    void execute(const SqlQueryJob& job);
+
+    /**
+     * @brief Appends \a rows to the pending batches of \a state and notifies the handle. Waits while the handle has
+     * too many pending batches.
+     * @return Returns \c false if the query was cancelled, otherwise returns \c true.
+     */
+    static bool post(SqlAsyncQueryState* state, const QVector<QSqlRecord>& rows, bool isFinished, const QSqlError& error);
+
+    /**
+     * @brief Cancels the query of \a state and wakes the worker, if it waits for the handle.
+     */
+    static void cancel(SqlAsyncQueryState* state);
+
+    SqlConnectionPool _pool; // only used by the worker thread
+    QMutex _mutex; // for the members below
+    QWaitCondition _jobAdded;
+    QQueue<SqlQueryJob> _jobs;
+    QSharedPointer<SqlAsyncQueryState> _current; // the state of the executing job
+    bool _stopRequested = false;
+};
+
+#endif // SQL_QUERY_WORKER_P_H
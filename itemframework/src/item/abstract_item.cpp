@@ -4,12 +4,15 @@
 #include "item/item_scene.h"
 #include "item/item_input.h"
 #include "item/item_output.h"
+#include "item_batch_p.h"
 #include "project/abstract_project.h"
 #include "res/resource.h"
+#include "res/theme.h"
 #include "helper/dom_helper.h"
 #include "project/project_gui.h"
 
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QGraphicsScene>
 #include <QGraphicsSceneContextMenuEvent>
 #include <QMenu>
@@ -18,6 +21,12 @@
 #include <QDomElement>
 #include <QBuffer>
 #include <QVariant>
+#include <qmath.h>
+
+#define FULL_DETAIL_THRESHOLD 0.5 // below this scale labels and ports are hardly readable
+#define LOW_DETAIL_THRESHOLD 0.25 // below this scale an item is only a few pixels large
+#define ITEM_BOX_CACHE_STEPS 4 // zoom buckets per doubling of the scale
+#define ITEM_BOX_CACHE_MAX_SCALE 8.0 // larger items are painted directly
 
 QHash<QString, int> AbstractItemPrivate::_itemTypesCount;
 
@@ -77,7 +86,8 @@ AbstractItem::AbstractItem(QString typeName) : QGraphicsObject(), d_ptr(new Abst
 
 AbstractItemPrivate::AbstractItemPrivate(AbstractItem* parent) :
     q_ptr(parent), _progress(-1), _autohide_timer(0), _is_autohide_active(false),
-    _settingsScope(NULL), _typeLabel(parent), _nameLabel(parent)
+    _settingsScope(NULL), _typeLabel(parent), _nameLabel(parent),
+    _itemBoxCacheBucket(0), _itemBoxCacheTheme(nullptr)
 {
 }
 
@@ -112,7 +122,7 @@ void AbstractItem::setProgress(int progr)
         d->_progress = progr;
     }
 
-    update();
+    invalidateItemBox();
 
     emit progressChanged();
 }
@@ -155,6 +165,12 @@ void AbstractItem::setName(QString name)
     Q_D(AbstractItem);
 
     if (name.trimmed().length() > 0 && name != d->_name) {
+        ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+        if (itemScene != nullptr) {
+            itemScene->journal().recordRename(this, d->_name, name);
+        }
+
         d->_name = name;
         d->_nameLabel.setText(d->_name);
         d->_nameLabel.setPos(-(d->_nameLabel.boundingRect().width() / 2), d->_shape.y() + d->_shape.height() + verticalOffset);
@@ -164,7 +180,10 @@ void AbstractItem::setName(QString name)
             d->_settingsScope->setName(name);
         }
 
-        update();
+        invalidateItemBox();
+
+        // The width of the name label is part of the bounds
+        ItemScene::updateItemBounds(this);
         emit nameChanged();
         emit changed();
     }
@@ -309,7 +328,9 @@ ItemInput* AbstractItem::addInput(int type, QString const& description)
     ItemInput* input = new ItemInput(this, type, description, shape);
     d->_inputs.append(input);
 
-    d->realignInputs();
+    if (!ItemBatchPrivate::deferRealign(d)) {
+        d->realignInputs();
+    }
 
     return input;
 }
@@ -322,7 +343,9 @@ ItemOutput* AbstractItem::addOutput(int type, QString const& description)
     ItemOutput* output = new ItemOutput(this, type, description, shape);
     d->_outputs.append(output);
 
-    d->realignOutputs();
+    if (!ItemBatchPrivate::deferRealign(d)) {
+        d->realignOutputs();
+    }
 
     return output;
 }
@@ -421,15 +444,25 @@ QVariant AbstractItem::itemChange(GraphicsItemChange change, const QVariant& val
 {
     Q_D(AbstractItem);
 
-    auto updateScenePosition = std::mem_fn(&AbstractItemInputOutputBase::updateScenePosition);
+    ItemScene::trackItemChange(this, change);
 
     switch (change) {
-    case QGraphicsItem::ItemScenePositionHasChanged:
-        std::for_each(d->_inputs.begin(), d->_inputs.end(), updateScenePosition);
-        std::for_each(d->_outputs.begin(), d->_outputs.end(), updateScenePosition);
+    case QGraphicsItem::ItemScenePositionHasChanged: {
+        ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+        if (itemScene != nullptr && itemScene->deferItemMove(this)) {
+            break; // part of a selection drag, the scene updates the ports and reports the change once per frame
+        }
+
+        updatePortPositions();
         emit changed();
 
         break;
+    }
+
+    case QGraphicsItem::ItemSelectedHasChanged:
+        invalidateItemBox();
+        break;
 
     case QGraphicsItem::ItemSceneHasChanged:
 
@@ -459,6 +492,15 @@ QVariant AbstractItem::itemChange(GraphicsItemChange change, const QVariant& val
     return value;
 }
 
+void AbstractItem::updatePortPositions()
+{
+    Q_D(AbstractItem);
+
+    auto updateScenePosition = std::mem_fn(&AbstractItemInputOutputBase::updateScenePosition);
+    std::for_each(d->_inputs.begin(), d->_inputs.end(), updateScenePosition);
+    std::for_each(d->_outputs.begin(), d->_outputs.end(), updateScenePosition);
+}
+
 bool AbstractItem::registerConnectorStyle(QColor const& color, int type)
 {
     return Resource::set<QPen>(QString("item_connector_pen%1").arg(type), QPen(color, connectorHeight()));
@@ -466,7 +508,7 @@ bool AbstractItem::registerConnectorStyle(QColor const& color, int type)
 
 QPen AbstractItem::connectorStyle(int type)
 {
-    return Resource::get(QString("item_connector_pen%1").arg(type), QPen(Qt::black, connectorHeight()));
+    return Theme::current().connectorPen(type, QPen(Qt::black, connectorHeight()));
 }
 
 void AbstractItem::disconnectConnections()
@@ -482,6 +524,8 @@ AbstractItem::~AbstractItem()
 {
     Q_D(AbstractItem);
 
+    ItemBatchPrivate::forget(d);
+
     auto disconnectItem=[this](QObject* sender){
         sender->disconnect(this);
     };
@@ -517,18 +561,67 @@ void AbstractItem::setImage(QImage const& image)
 
     d->_image = image;
 
+    invalidateItemBox();
+}
+
+void AbstractItem::invalidateItemBox()
+{
+    Q_D(AbstractItem);
+
+    QPixmapCache::remove(d->_itemBoxCacheKey);
+    d->_itemBoxCacheKey = QPixmapCache::Key();
+
     update();
 }
 
+void AbstractItemPrivate::paintCachedItemBox(QPainter* painter, qreal levelOfDetail)
+{
+    Q_Q(AbstractItem);
+
+    // Render with the next larger bucket scale, so the pixmap is never magnified
+    qreal const deviceScale = levelOfDetail * painter->device()->devicePixelRatioF();
+    int const bucket = qCeil(std::log2(deviceScale) * ITEM_BOX_CACHE_STEPS);
+    qreal const scale = std::pow(2.0, qreal(bucket) / ITEM_BOX_CACHE_STEPS);
+    QRectF const source = _boundingRect.adjusted(-1, -1, 1, 1); // include the selection box pen
+    void const* const theme = &Theme::current();
+    QPixmap pixmap;
+
+    if (bucket != _itemBoxCacheBucket || theme != _itemBoxCacheTheme || !QPixmapCache::find(_itemBoxCacheKey, &pixmap)) {
+        pixmap = QPixmap(qCeil(source.width() * scale), qCeil(source.height() * scale));
+        pixmap.fill(Qt::transparent);
+
+        QPainter cachePainter(&pixmap);
+        cachePainter.setRenderHints(painter->renderHints());
+        cachePainter.scale(scale, scale);
+        cachePainter.translate(-source.topLeft());
+        q->paintItemBox(&cachePainter);
+
+        if (q->isSelected()) {
+            cachePainter.setBrush(Qt::NoBrush);
+            cachePainter.setPen(Theme::current().itemBoxSelectedPen);
+            cachePainter.drawRect(_boundingRect);
+        }
+
+        cachePainter.end();
+
+        QPixmapCache::remove(_itemBoxCacheKey);
+        _itemBoxCacheKey = QPixmapCache::insert(pixmap);
+        _itemBoxCacheBucket = bucket;
+        _itemBoxCacheTheme = theme;
+    }
+
+    painter->drawPixmap(QRectF(source.topLeft(), QSizeF(pixmap.size()) / scale), pixmap, QRectF(pixmap.rect()));
+}
+
 void AbstractItem::paintItemBox(QPainter* painter)
 {
     Q_D(AbstractItem);
 
+    Theme const& theme = Theme::current();
+
     // Draw box
-    QColor bgcolor = Resource::get("item_box_bgcolor", QColor(0xF5, 0xF5, 0xF5));
-    QColor bcolor = Resource::get("item_box_bordercolor", QColor(Qt::gray));
-    painter->fillRect(d->_shape, bgcolor);
-    painter->setPen(bcolor);
+    painter->fillRect(d->_shape, theme.itemBoxBackground);
+    painter->setPen(theme.itemBoxBorder);
     painter->drawRect(d->_shape);
 
     //Draw Icon
@@ -548,22 +641,65 @@ void AbstractItem::paintItemBox(QPainter* painter)
         rec_pb.adjust(1, 1, 0, 0);
         rec_pb.setWidth(rec_pb.width() * (d->_progress) / 100);
         painter->setPen(Qt::NoPen);
-        painter->setBrush(Resource::get("item_box_progresscolor", QColor(Qt::green)));
+        painter->setBrush(theme.itemBoxProgress);
         painter->drawRect(rec_pb);
     }
 }
 
+AbstractItem::DetailLevel AbstractItem::detailLevel(QStyleOptionGraphicsItem const* option, QPainter const* painter)
+{
+    qreal const lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+    if (lod < LOW_DETAIL_THRESHOLD) {
+        return LowDetail;
+    } else if (lod < FULL_DETAIL_THRESHOLD) {
+        return ReducedDetail;
+    }
+
+    return FullDetail;
+}
+
+void AbstractItemLabel::paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget* widget)
+{
+    if (AbstractItem::detailLevel(option, painter) == AbstractItem::FullDetail) {
+        QGraphicsSimpleTextItem::paint(painter, option, widget);
+    }
+}
+
 void AbstractItem::paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget* widget)
 {
     Q_D(AbstractItem);
 
+    DetailLevel const level = detailLevel(option, painter);
+
+    if (level == LowDetail) {
+        // A single fill per item, the selection is shown by the color
+        if (isSelected()) {
+            painter->fillRect(d->_shape, Theme::current().itemBoxSelectedPen.color());
+        } else {
+            painter->fillRect(d->_shape, Theme::current().itemBoxBorder);
+        }
+
+        return;
+    }
+
     // paint inputs and output
-    for (ItemInput* e : d->_inputs) {
-        e->paint(painter, option, widget);
+    if (level == FullDetail) {
+        for (ItemInput* e : d->_inputs) {
+            e->paint(painter, option, widget);
+        }
+
+        for (ItemOutput* e : d->_outputs) {
+            e->paint(painter, option, widget);
+        }
     }
 
-    for (ItemOutput* e : d->_outputs) {
-        e->paint(painter, option, widget);
+    // Views blit the cached item box. Other devices (e.g. ItemScene::createPixmap) and very large zoom levels paint directly.
+    qreal const lod = option->levelOfDetailFromTransform(painter->worldTransform());
+
+    if (widget != nullptr && lod <= ITEM_BOX_CACHE_MAX_SCALE) {
+        d->paintCachedItemBox(painter, lod);
+        return;
     }
 
     //Paint the item with background and content
@@ -572,7 +708,7 @@ void AbstractItem::paint(QPainter* painter, QStyleOptionGraphicsItem const* opti
     // If plugin is selected draw surrounding box
     if (isSelected()) {
         painter->setBrush(Qt::NoBrush);
-        painter->setPen(Resource::get("item_box_selected_pen", QPen(Qt::black, 1, Qt::DashLine)));
+        painter->setPen(Theme::current().itemBoxSelectedPen);
         painter->drawRect(d->_boundingRect);
     }
 }
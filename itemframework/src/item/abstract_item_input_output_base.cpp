@@ -1,6 +1,8 @@
 #include "item/abstract_item_input_output_base.h"
 #include "item/abstract_item_input_output_base_p.h"
 #include "item/abstract_item.h"
+#include "item/item_scene.h"
+#include "item/item_port_index.h"
 #include "res/resource.h"
 #include <QPen>
 #include <QBrush>
@@ -18,6 +20,8 @@ AbstractItemInputOutputBase::AbstractItemInputOutputBase(AbstractItem* parent, i
 
 AbstractItemInputOutputBase::~AbstractItemInputOutputBase()
 {
+    Q_D(AbstractItemInputOutputBase);
+    d->updatePortIndex(scene(), false);
 }
 
 AbstractItemInputOutputBasePrivate::AbstractItemInputOutputBasePrivate(AbstractItemInputOutputBase* parent,
@@ -61,15 +65,57 @@ void AbstractItemInputOutputBase::setLocalPosition(QPointF const& position)
     Q_D(AbstractItemInputOutputBase);
 
     d->_shape.moveCenter(position);
+    d->updatePortIndex(scene(), true);
 
     emit positionChanged();
 }
 
 void AbstractItemInputOutputBase::updateScenePosition()
 {
+    Q_D(AbstractItemInputOutputBase);
+
+    d->updatePortIndex(scene(), true);
+
     emit positionChanged();
 }
 
+QVariant AbstractItemInputOutputBase::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    Q_D(AbstractItemInputOutputBase);
+
+    switch (change) {
+    case QGraphicsItem::ItemSceneChange:
+        d->updatePortIndex(scene(), false); // leave the old scene
+        break;
+
+    case QGraphicsItem::ItemSceneHasChanged:
+        d->updatePortIndex(scene(), true);
+        break;
+
+    default:
+        break;
+    }
+
+    return QGraphicsObject::itemChange(change, value);
+}
+
+void AbstractItemInputOutputBasePrivate::updatePortIndex(QGraphicsScene* scene, bool indexed)
+{
+    Q_Q(AbstractItemInputOutputBase);
+
+    ItemScene* itemScene = qobject_cast<ItemScene*>(scene);
+
+    if (itemScene == nullptr) {
+        return;
+    }
+
+    if (indexed) {
+        itemScene->portIndex().update(q);
+    } else {
+        itemScene->portIndex().remove(q);
+    }
+}
+
 QRectF AbstractItemInputOutputBase::boundingRect() const
 {
     Q_D(const AbstractItemInputOutputBase);
@@ -79,10 +125,15 @@ QRectF AbstractItemInputOutputBase::boundingRect() const
     return r;
 }
 
-void AbstractItemInputOutputBase::paint(QPainter* painter, QStyleOptionGraphicsItem const*, QWidget*)
+void AbstractItemInputOutputBase::paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget*)
 {
     Q_D(AbstractItemInputOutputBase);
 
+    // ports are too small to be seen when zoomed out
+    if (AbstractItem::detailLevel(option, painter) != AbstractItem::FullDetail) {
+        return;
+    }
+
     // fill shape
     painter->fillRect(d->_shape, AbstractItem::connectorStyle(transportType()).color());
 
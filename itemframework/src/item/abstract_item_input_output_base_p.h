@@ -15,6 +15,12 @@ public:
     AbstractItemInputOutputBase* const q_ptr;
     Q_DECLARE_PUBLIC(AbstractItemInputOutputBase)
 
+    /**
+     * @brief Adds/updates (\a indexed = true) or removes this object in the port index of \a scene,
+     * if it is an ItemScene.
+     */
+    void updatePortIndex(class QGraphicsScene* scene, bool indexed);
+
     AbstractItem* _parent;
     QRectF _shape;
     int _transportType;
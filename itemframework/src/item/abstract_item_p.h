@@ -7,6 +7,7 @@
 #include <QHash>
 #include <QDomElement>
 #include <QGraphicsSimpleTextItem>
+#include <QPixmapCache>
 #include "helper/settings_scope.h"
 
 class AbstractItemInputOutputBase;
@@ -14,6 +15,16 @@ class ItemInput;
 class ItemOutput;
 class AbstractItem;
 
+/**
+ * @brief Text label of an item, which is only painted at full detail
+ */
+class AbstractItemLabel : public QGraphicsSimpleTextItem
+{
+public:
+    using QGraphicsSimpleTextItem::QGraphicsSimpleTextItem;
+    void paint(QPainter* painter, QStyleOptionGraphicsItem const* option, QWidget* widget) override;
+};
+
 class AbstractItemPrivate
 {
 public:
@@ -32,6 +43,7 @@ public:
     float outputX(float x = 0) const;
     float outputY(float y = 0) const;
     float inputOutputY(float y) const;
+    void paintCachedItemBox(QPainter* painter, qreal levelOfDetail);
 
     QString _type;
     QString _name;
@@ -49,8 +61,13 @@ public:
     QRectF _shape;
     QRectF _boundingRect;
 
-    QGraphicsSimpleTextItem _typeLabel;
-    QGraphicsSimpleTextItem _nameLabel;
+    AbstractItemLabel _typeLabel;
+    AbstractItemLabel _nameLabel;
+
+    // Rendering of paintItemBox() and the selection box, valid for one zoom bucket and theme
+    QPixmapCache::Key _itemBoxCacheKey;
+    int _itemBoxCacheBucket;
+    void const* _itemBoxCacheTheme;
 
     static int const _connectorHeight = 5;
     static int const _connectorWidth = 15;
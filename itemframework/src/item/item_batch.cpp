@@ -0,0 +1,169 @@
+#include "item/item_batch.h"
+#include "item_batch_p.h"
+#include "abstract_item_p.h"
+#include "item_input_p.h"
+#include "item_output_p.h"
+#include "item_connector.h"
+
+#include <QSet>
+#include <QVector>
+
+namespace
+{
+
+// Objects in the order they were deferred, each one only once
+template <typename T>
+class DeferredQueue
+{
+public:
+    void add(T* object)
+    {
+        if (!_members.contains(object)) {
+            _members.insert(object);
+            _order.append(object);
+        }
+    }
+
+    bool remove(T* object)
+    {
+        if (!_members.remove(object)) {
+            return false;
+        }
+
+        _order.removeOne(object);
+        return true;
+    }
+
+    QVector<T*> take()
+    {
+        QVector<T*> order;
+        order.swap(_order);
+        _members.clear();
+        return order;
+    }
+
+    bool isEmpty() const
+    {
+        return _order.isEmpty();
+    }
+
+private:
+    QVector<T*> _order;
+    QSet<T*> _members;
+};
+
+int depth = 0;
+DeferredQueue<AbstractItemPrivate> realignedItems;
+DeferredQueue<ItemInputPrivate> connectedInputs;
+DeferredQueue<ItemOutputPrivate> connectedOutputs;
+DeferredQueue<Item_Connector> routedConnectors;
+
+} // namespace
+
+ItemBatch::ItemBatch()
+{
+    depth++;
+}
+
+ItemBatch::~ItemBatch()
+{
+    if (depth == 1) {
+        ItemBatchPrivate::commit();
+    }
+
+    depth--;
+}
+
+bool ItemBatch::isActive()
+{
+    return depth > 0;
+}
+
+void ItemBatchPrivate::commit()
+{
+    // The batch stays active while committing: realigned ports move their connectors and
+    // receivers of the signals may create further items, which are all deferred and handled in the next round
+    while (!realignedItems.isEmpty() || !connectedInputs.isEmpty() || !connectedOutputs.isEmpty()) {
+        for (AbstractItemPrivate* item : realignedItems.take()) {
+            item->realignInputs();
+            item->realignOutputs();
+        }
+
+        for (ItemOutputPrivate* output : connectedOutputs.take()) {
+            output->notifyConnected();
+        }
+
+        for (ItemInputPrivate* input : connectedInputs.take()) {
+            input->notifyConnected();
+        }
+    }
+
+    // Route last, when all ports are at their final positions
+    depth--;
+
+    for (Item_Connector* connector : routedConnectors.take()) {
+        connector->do_update();
+    }
+
+    depth++;
+}
+
+bool ItemBatchPrivate::deferRealign(AbstractItemPrivate* item)
+{
+    if (depth == 0) {
+        return false;
+    }
+
+    realignedItems.add(item);
+    return true;
+}
+
+bool ItemBatchPrivate::deferConnected(ItemInputPrivate* input)
+{
+    if (depth == 0) {
+        return false;
+    }
+
+    connectedInputs.add(input);
+    return true;
+}
+
+bool ItemBatchPrivate::deferConnected(ItemOutputPrivate* output)
+{
+    if (depth == 0) {
+        return false;
+    }
+
+    connectedOutputs.add(output);
+    return true;
+}
+
+bool ItemBatchPrivate::deferRouting(Item_Connector* connector)
+{
+    if (depth == 0) {
+        return false;
+    }
+
+    routedConnectors.add(connector);
+    return true;
+}
+
+void ItemBatchPrivate::forget(AbstractItemPrivate* item)
+{
+    realignedItems.remove(item);
+}
+
+bool ItemBatchPrivate::forget(ItemInputPrivate* input)
+{
+    return connectedInputs.remove(input);
+}
+
+bool ItemBatchPrivate::forget(ItemOutputPrivate* output)
+{
+    return connectedOutputs.remove(output);
+}
+
+void ItemBatchPrivate::forget(Item_Connector* connector)
+{
+    routedConnectors.remove(connector);
+}
@@ -0,0 +1,30 @@
+#ifndef ITEM_BATCH_P_H
+#define ITEM_BATCH_P_H
+
+class AbstractItemPrivate;
+class ItemInputPrivate;
+class ItemOutputPrivate;
+class Item_Connector;
+
+/**
+ * @brief Deferred work of the active ItemBatch.
+ * The defer functions return false if no batch is active, the caller then does the work immediately.
+ * Objects which are destroyed during a batch must be forgotten, forget() returns whether work was pending.
+ */
+class ItemBatchPrivate
+{
+public:
+    static bool deferRealign(AbstractItemPrivate* item);
+    static bool deferConnected(ItemInputPrivate* input);
+    static bool deferConnected(ItemOutputPrivate* output);
+    static bool deferRouting(Item_Connector* connector);
+
+    static void forget(AbstractItemPrivate* item);
+    static bool forget(ItemInputPrivate* input);
+    static bool forget(ItemOutputPrivate* output);
+    static void forget(Item_Connector* connector);
+
+    static void commit();
+};
+
+#endif // ITEM_BATCH_P_H
@@ -2,12 +2,14 @@
 #include "item/item_input.h"
 #include "item/item_output.h"
 #include "item/abstract_item.h"
+#include "item_scene.h"
+#include "item_batch_p.h"
 #include <QGraphicsScene>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDebug>
 #include <QPainter>
-#include "res/resource.h"
+#include "res/theme.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneHoverEvent>
 #include <QCursor>
@@ -20,18 +22,20 @@ Item_Connector::Item_Connector(ItemOutput* output, ItemInput* input)
     this->output = output;
     b_was_pressed = false;
     b_user_modified = false;
+    b_obstacles_changed = false;
     b_coords_start_hor = true;
     i_routing_mode = 0;
-    connect(input, SIGNAL(positionChanged()), this, SLOT(do_update()));
-    connect(output, SIGNAL(positionChanged()), this, SLOT(do_update()));
-    connect(input, SIGNAL(outputDisconnected()), this, SLOT(checkConnection()));
-    connect(output, SIGNAL(inputDisconnected()), this, SLOT(checkConnection()));
-    connect(output, SIGNAL(dataChanged()), this, SLOT(repaint()));
+    connect(input, &ItemInput::positionChanged, this, &Item_Connector::schedule_update);
+    connect(output, &ItemOutput::positionChanged, this, &Item_Connector::schedule_update);
+    connect(input, &ItemInput::outputDisconnected, this, &Item_Connector::checkConnection);
+    connect(output, &ItemOutput::inputDisconnected, this, &Item_Connector::checkConnection);
+    connect(output, &ItemOutput::dataChanged, this, &Item_Connector::repaint);
     pen = AbstractItem::connectorStyle(input->transportType());
 }
 
 Item_Connector::~Item_Connector()
 {
+    ItemBatchPrivate::forget(this);
     disconnect(input, 0, this, 0);
     disconnect(output, 0, this, 0);
 
@@ -41,6 +45,7 @@ Item_Connector::~Item_Connector()
 
     prepareGeometryChange(); //this and the following lines seem to be necessary, otherwise the scene will redraw the item after deletion..
     ppa_selpoints = ppa_line =  QPainterPath();
+    pol_line.clear();
 
     scene()->removeItem(this);
     emit changed();
@@ -77,8 +82,18 @@ void Item_Connector::do_update()
     //So you only need to add the changing coordinate, the rest is automatically calculated
 
     QList<qreal> coords;
+    ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+    b_obstacles_changed = false;
 
-    if (diff.y() == 0 && diff.x() > MIN_LIN_LEN) { //straight line
+    if (i_routing_mode == 5 && b_user_modified && !lis_cur_coords.isEmpty()) {
+        extend_user_routing();
+    } else if (!b_user_modified && itemScene != nullptr && itemScene->router().route(start, end, coords)) { //route around all items of the scene
+        lis_cur_coords = coords;
+
+        i_routing_mode = 5;
+        b_coords_start_hor = true;
+        b_user_modified = false;
+    } else if (diff.y() == 0 && diff.x() > MIN_LIN_LEN) { //straight line, the modes below only consider the two connected items
         if (i_routing_mode == 1 && b_user_modified && !lis_cur_coords.isEmpty()) {
             extend_user_routing();
         } else {
@@ -162,10 +177,74 @@ void Item_Connector::do_update()
         }
     }
 
+    poi_start = start;
     poi_end = end;
     recalc_pathes();
 }
 
+void Item_Connector::schedule_update()
+{
+    if (ItemBatchPrivate::deferRouting(this)) { //routed once when the batch commits
+        return;
+    }
+
+    ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+    if (itemScene == nullptr) { //nobody will flush, route immediately
+        do_update();
+        return;
+    }
+
+    itemScene->scheduleConnectorUpdate(this);
+}
+
+void Item_Connector::schedule_reroute()
+{
+    if (b_user_modified) { //the user's path is kept, wherever the other items are
+        return;
+    }
+
+    b_obstacles_changed = true;
+    schedule_update();
+}
+
+void Item_Connector::flush_update()
+{
+    QPointF delta_start = output->scenePosition() - poi_start;
+    QPointF delta_end = input->scenePosition() - poi_end;
+
+    if (i_routing_mode != 0 && !b_obstacles_changed && delta_start == delta_end) { //both items moved together (or nothing moved), the route keeps its shape
+        if (!delta_start.isNull()) {
+            translate_pathes(delta_start);
+        }
+    } else {
+        do_update();
+    }
+}
+
+void Item_Connector::translate_pathes(QPointF const& delta)
+{
+    prepareGeometryChange();
+    bool horizontal = b_coords_start_hor;
+
+    for (int i = 0; i < lis_cur_coords.length(); i++) { //horizontal segments store a x coordinate, vertical ones a y coordinate
+        lis_cur_coords[i] += horizontal ? delta.x() : delta.y();
+        horizontal = !horizontal;
+    }
+
+    for (int i = 0; i < lis_cur_selpoints.length(); i++) {
+        lis_cur_selpoints[i].first.translate(delta);
+    }
+
+    ppa_line.translate(delta);
+    ppa_selpoints.translate(delta);
+    pol_line.translate(delta);
+    poi_start += delta;
+    poi_end += delta;
+
+    ItemScene::updateItemBounds(this);
+}
+
 void Item_Connector::recalc_pathes()
 {
     prepareGeometryChange();
@@ -180,6 +259,8 @@ void Item_Connector::recalc_pathes()
     bool horizontal = b_coords_start_hor;
 
     ppa_line.moveTo(start);
+    pol_line.clear();
+    pol_line.append(start);
     lis_cur_selpoints.append(qMakePair(MAKE_SEL_POINT_RECT(start.x(), start.y()),
                                        horizontal ? Item_Connector::vertical : Item_Connector::horizontal));
 
@@ -201,6 +282,7 @@ void Item_Connector::recalc_pathes()
         }
 
         ppa_line.lineTo(cur);
+        pol_line.append(cur);
         lis_cur_selpoints.append(qMakePair(MAKE_SEL_POINT_RECT(half.x(), half.y()),
                                            horizontal ? Item_Connector::vertical : Item_Connector::horizontal));
 
@@ -215,6 +297,7 @@ void Item_Connector::recalc_pathes()
     }
 
     ppa_line.lineTo(end);
+    pol_line.append(end);
     lis_cur_selpoints.append(qMakePair(MAKE_SEL_POINT_RECT((lastpoint.x() + end.x()) / 2, (lastpoint.y() + end.y()) / 2),
                                        horizontal ? Item_Connector::vertical : Item_Connector::horizontal));
     lis_cur_selpoints.append(qMakePair(MAKE_SEL_POINT_RECT(end.x(), end.y()),
@@ -239,6 +322,26 @@ void Item_Connector::recalc_pathes()
         ppa_selpoints.addRect(selpoint.first);
     }
 
+    ItemScene::updateItemBounds(this);
+}
+
+QVariant Item_Connector::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    ItemScene::trackItemChange(this, change);
+
+    if (change == QGraphicsItem::ItemSceneChange) { //a pending update would not be flushed anymore
+        ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+        if (itemScene != nullptr) {
+            itemScene->cancelConnectorUpdate(this);
+        }
+    } else if (change == QGraphicsItem::ItemSceneHasChanged) { //loaded connectors were routed before, without the obstacles of the scene
+        if (qobject_cast<ItemScene*>(scene()) != nullptr) {
+            schedule_reroute();
+        }
+    }
+
+    return QGraphicsObject::itemChange(change, value);
 }
 
 //extends a user modified path with the minimal changes
@@ -332,6 +435,12 @@ void Item_Connector::mousePressEvent(QGraphicsSceneMouseEvent* e)
         } else if (i_selected_selpoint == lis_cur_selpoints.length() - 1) { //clicked end
             i_selected_selpoint = lis_cur_selpoints.length() - 2; //behave like user clicked selpoint in the middle of the last segment
         }
+
+        ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+        if (itemScene != nullptr) {
+            itemScene->journal().beginPathEdit(this); //the path before the edit, for undo
+        }
     }
 
     QGraphicsObject::mousePressEvent(e);
@@ -444,6 +553,12 @@ void Item_Connector::mouseReleaseEvent(QGraphicsSceneMouseEvent* e)
                 recalc_pathes();
             }
         }
+
+        ItemScene* itemScene = qobject_cast<ItemScene*>(scene());
+
+        if (itemScene != nullptr) {
+            itemScene->journal().endPathEdit(this);
+        }
     }
 
     QGraphicsObject::mouseReleaseEvent(e);
@@ -529,21 +644,26 @@ QPainterPath Item_Connector::shape() const
     return ppa_line;
 }
 
-void Item_Connector::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
+void Item_Connector::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*)
 {
 
     //painter->fillRect(boundingRect(),Qt::green);
     //painter->fillPath(shape(),Qt::yellow);
 
+    if (AbstractItem::detailLevel(option, painter) != AbstractItem::FullDetail) { //zoomed out: one cosmetic polyline, no pattern or selpoints
+        painter->setPen(QPen(pen.color(), 0));
+        painter->drawPolyline(pol_line);
+        return;
+    }
 
     painter->fillPath(ppa_line, pen.color());
 
     if (output->data() == NULL) {
-        painter->fillPath(ppa_line, Resource::get("item_connector_inactive", QBrush(Qt::white, Qt::BDiagPattern)));
+        painter->fillPath(ppa_line, Theme::current().connectorInactiveBrush);
     }
 
     if (isSelected()) {
-        painter->fillPath(ppa_selpoints, Resource::get("item_connector_selpoint_color", QColor(Qt::black)));
+        painter->fillPath(ppa_selpoints, Theme::current().connectorSelpointColor);
     }
 }
 
@@ -4,6 +4,7 @@
 #include <QGraphicsLineItem>
 #include <QObject>
 #include <QPen>
+#include <QPolygonF>
 
 #include "appcore.h"
 
@@ -30,6 +31,7 @@ public:
     void mouseMoveEvent(QGraphicsSceneMouseEvent* e);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent* e);
     void hoverMoveEvent(QGraphicsSceneHoverEvent* e);
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value);
 
 private:
     ItemOutput* output;
@@ -37,14 +39,18 @@ private:
     QPen pen;
     QPainterPath ppa_line;
     QPainterPath ppa_selpoints;
+    QPolygonF pol_line; //the plain route, painted instead of ppa_line when zoomed out
     bool b_was_pressed; //whether or not a selection Point was selected before the mouse-move event occoured
     int i_selected_selpoint; //the index of the selected selpoint in lis_cur_selpoints
     int i_routing_mode; //the currently applied routing mode
     bool b_user_modified; //whether or not the user modified the path
+    bool b_obstacles_changed; //whether an item was moved onto the route, so it has to be recalculated even if the end points did not move
+    QPointF poi_start; //last start point
     QPointF poi_end; //last end point
     void recalc_pathes(); //recalculates all painter pathes and selpoints based on lis_current_coords.
     void extend_user_routing(); //tries to merge the movement into the user modified path
     void move_line_segment(int seg, qreal len); //moves a line segment to the specified x or y cordinate
+    void translate_pathes(QPointF const& delta); //moves the whole route, used when both end points moved by the same distance
     bool b_coords_start_hor; //whether the first line segment branchs out horiontally or vertically of the start item.
     enum Selpoint_Type {vertical, horizontal, topright, topleft};
     QList<qreal> lis_cur_coords; //all current line segment coordinates
@@ -57,6 +63,11 @@ private slots:
 
 public slots:
     void do_update();
+    void schedule_update(); //marks the route as dirty. The ItemScene calls flush_update() once before the next frame.
+
+public:
+    void schedule_reroute(); //like schedule_update(), but the route is recalculated even if the end points did not move
+    void flush_update(); //reroutes if necessary, or only translates the route if both end points moved together
 
 signals:
     void changed();
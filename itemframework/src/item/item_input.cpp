@@ -3,6 +3,7 @@
 #include "item/item_output.h"
 #include "item_output_p.h"
 #include "item/abstract_item.h"
+#include "item_batch_p.h"
 
 ItemInput::ItemInput(AbstractItem* owner, int type, QString const& description, QRectF const& shape)
     : AbstractItemInputOutputBase(owner, type, description, shape), d_ptr(new ItemInputPrivate(this))
@@ -11,6 +12,7 @@ ItemInput::ItemInput(AbstractItem* owner, int type, QString const& description,
 
 ItemInput::~ItemInput()
 {
+    ItemBatchPrivate::forget(d_ptr.data());
 }
 
 ItemInputPrivate::ItemInputPrivate(ItemInput* parent) :
@@ -48,6 +50,10 @@ void ItemInputPrivate::disconnectOutput()
 
     _output = NULL;
 
+    if (ItemBatchPrivate::forget(this)) {
+        return; // the connection was not reported yet, so neither is its removal
+    }
+
     emit q->outputDisconnected();
 
     updateData();
@@ -77,10 +83,17 @@ bool ItemInput::connectOutput(ItemOutput* output)
 
 void ItemInputPrivate::connectOutput(ItemOutput* output)
 {
-    Q_Q(ItemInput);
-
     _output = output;
 
+    if (!ItemBatchPrivate::deferConnected(this)) {
+        notifyConnected();
+    }
+}
+
+void ItemInputPrivate::notifyConnected()
+{
+    Q_Q(ItemInput);
+
     emit q->outputConnected();
 
     updateData();
@@ -16,6 +16,7 @@ public:
 
     void disconnectOutput();
     void connectOutput(ItemOutput* output);
+    void notifyConnected(); // emits outputConnected() and propagates the data, possibly deferred by an ItemBatch
     void updateData();
 
     ItemOutput* _output = nullptr;
@@ -0,0 +1,769 @@
+#include "item_journal.h"
+#include "item/abstract_item.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "item/item_batch.h"
+#include "item/item_serializer.h"
+#include "item_connector.h"
+#include "item_note.h"
+#include "item_scene.h"
+#include "helper/settings_scope.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+
+#define ENTRY_OVERHEAD 64 // [byte] estimated size of an entry without its data
+#define PATH_SIZE 64 // [byte] estimated size of a saved connector path
+#define SETTING_MERGE_INTERVAL 1000 // [ms] changes of the same setting within this time are undone together
+
+// Milliseconds since the first call, not affected by changes of the system time
+static qint64 elapsedTime()
+{
+    static QElapsedTimer clock;
+
+    if (!clock.isValid()) {
+        clock.start();
+    }
+
+    return clock.elapsed();
+}
+
+static bool samePath(QDomElement const& a, QDomElement const& b)
+{
+    QDomNamedNodeMap const attributes = a.attributes();
+
+    if (attributes.count() != b.attributes().count()) {
+        return false;
+    }
+
+    for (int i = 0; i < attributes.count(); i++) {
+        QDomAttr const attribute = attributes.item(i).toAttr();
+
+        if (b.attribute(attribute.name()) != attribute.value()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+class ItemJournal::Entry
+{
+public:
+    virtual ~Entry() {}
+
+    virtual void undo(ItemJournal& journal) = 0;
+    virtual void redo(ItemJournal& journal) = 0;
+
+    /**
+     * @return The estimated size of the entry in bytes
+     */
+    virtual int cost() const = 0;
+
+    /**
+     * @brief Merges \a next, which was recorded directly after this entry, into this entry
+     * @return true if merged, \a next is dropped then
+     */
+    virtual bool merge(Entry const* next)
+    {
+        Q_UNUSED(next);
+        return false;
+    }
+};
+
+/**
+ * @brief Items, notes and connectors which were added or removed. Removed ones are kept as XML.
+ */
+class ItemJournal::ItemsEntry : public ItemJournal::Entry
+{
+public:
+    ItemsEntry(ItemJournal& journal, QList<QGraphicsItem*> const& items, bool added);
+
+    void undo(ItemJournal& journal) override;
+    void redo(ItemJournal& journal) override;
+    int cost() const override;
+
+private:
+    struct Link {
+        int connector;
+        int output; // owner of the output
+        int outputIndex;
+        int input; // owner of the input
+        int inputIndex;
+        QDomElement path;
+    };
+
+    void capture(ItemJournal& journal);
+    void remove(ItemJournal& journal);
+    void restore(ItemJournal& journal);
+
+    bool _added;
+    QVector<int> _objects; // items and notes, in the order of _xml
+    QVector<int> _connectors;
+    QVector<Link> _links;
+    QByteArray _xml; // compressed, only kept while the items are removed
+};
+
+ItemJournal::ItemsEntry::ItemsEntry(ItemJournal& journal, QList<QGraphicsItem*> const& items, bool added)
+    : _added(added)
+{
+    for (QGraphicsItem* item : items) {
+        if (item == nullptr || item->type() == QGraphicsLineItem::Type) { // temporary connection line
+            continue;
+        }
+
+        QGraphicsObject* object = item->toGraphicsObject();
+
+        if (qobject_cast<Item_Connector*>(object) != nullptr) {
+            _connectors.append(journal.idOf(item));
+        } else if (qobject_cast<AbstractItem*>(object) != nullptr || qobject_cast<ItemNote*>(object) != nullptr) {
+            _objects.append(journal.idOf(item));
+        }
+    }
+
+    if (!_added) {
+        capture(journal);
+    }
+}
+
+void ItemJournal::ItemsEntry::undo(ItemJournal& journal)
+{
+    if (_added) {
+        remove(journal);
+    } else {
+        restore(journal);
+    }
+}
+
+void ItemJournal::ItemsEntry::redo(ItemJournal& journal)
+{
+    if (_added) {
+        restore(journal);
+    } else {
+        remove(journal);
+    }
+}
+
+int ItemJournal::ItemsEntry::cost() const
+{
+    return ENTRY_OVERHEAD + _xml.size() + (_objects.size() + _connectors.size()) * int(sizeof(int)) +
+           _links.size() * int(sizeof(Link) + PATH_SIZE);
+}
+
+void ItemJournal::ItemsEntry::capture(ItemJournal& journal)
+{
+    QList<QGraphicsItem const*> objects;
+    QVector<int> objectIds;
+    QSet<AbstractItem*> owners;
+
+    for (int id : _objects) {
+        QGraphicsItem* item = journal.resolve(id);
+
+        if (item == nullptr) {
+            continue;
+        }
+
+        objects.append(item);
+        objectIds.append(id);
+
+        AbstractItem* abstractItem = qobject_cast<AbstractItem*>(item->toGraphicsObject());
+
+        if (abstractItem != nullptr) {
+            owners.insert(abstractItem);
+        }
+    }
+
+    _objects = objectIds;
+
+    QList<Item_Connector*> connectors;
+
+    for (int id : _connectors) {
+        QGraphicsItem* item = journal.resolve(id);
+
+        if (item != nullptr) {
+            connectors.append(static_cast<Item_Connector*>(item->toGraphicsObject()));
+        }
+    }
+
+    // The connectors of the items are deleted together with them
+    if (!owners.isEmpty()) {
+        for (QGraphicsItem* item : journal._scene->items()) {
+            Item_Connector* connector = qobject_cast<Item_Connector*>(item->toGraphicsObject());
+
+            if (connector != nullptr && !connectors.contains(connector) &&
+                    (owners.contains(connector->get_output()->owner()) || owners.contains(connector->get_input()->owner()))) {
+                connectors.append(connector);
+            }
+        }
+    }
+
+    _connectors.clear();
+    _links.clear();
+
+    for (Item_Connector* connector : connectors) {
+        ItemOutput* output = connector->get_output();
+        ItemInput* input = connector->get_input();
+        Link link;
+        link.connector = journal.idOf(connector);
+        link.output = journal.idOf(output->owner());
+        link.outputIndex = output->owner()->outputs().indexOf(output);
+        link.input = journal.idOf(input->owner());
+        link.inputIndex = input->owner()->inputs().indexOf(input);
+        link.path = journal.pathOf(connector);
+
+        _connectors.append(link.connector);
+        _links.append(link);
+    }
+
+    _xml.clear();
+
+    if (!objects.isEmpty()) {
+        QDomDocument document;
+        QDomElement root = document.createElement("items");
+        ItemSerializer::saveToXml(document, root, objects);
+        document.appendChild(root);
+        _xml = qCompress(document.toByteArray(-1));
+    }
+}
+
+void ItemJournal::ItemsEntry::remove(ItemJournal& journal)
+{
+    capture(journal);
+
+    QList<QGraphicsItem*> items;
+
+    for (int id : _connectors + _objects) {
+        QGraphicsItem* item = journal.resolve(id);
+
+        if (item != nullptr) {
+            items.append(item);
+        }
+    }
+
+    journal.remove(items);
+}
+
+void ItemJournal::ItemsEntry::restore(ItemJournal& journal)
+{
+    // Realign and route once, after all items and connections exist again
+    ItemBatch batch;
+
+    if (!_xml.isEmpty()) {
+        QDomDocument document;
+        QList<QGraphicsItem*> items;
+
+        if (!document.setContent(qUncompress(_xml)) ||
+                !ItemSerializer::loadFromXml(document.documentElement(), &items, ProgressReporter{nullptr, false})) {
+            qWarning() << "Couldn't restore the removed items";
+        }
+
+        items.removeAll(nullptr);
+
+        if (items.size() != _objects.size()) {
+            qWarning() << "Restored" << items.size() << "of" << _objects.size() << "removed items";
+        }
+
+        for (int i = 0; i < items.size(); i++) {
+            journal.adopt(items.at(i));
+
+            if (i < _objects.size()) {
+                journal.bind(_objects.at(i), items.at(i));
+            }
+        }
+    }
+
+    for (Link const& link : _links) {
+        QGraphicsItem* from = journal.resolve(link.output);
+        QGraphicsItem* to = journal.resolve(link.input);
+        AbstractItem* outputOwner = (from != nullptr) ? qobject_cast<AbstractItem*>(from->toGraphicsObject()) : nullptr;
+        AbstractItem* inputOwner = (to != nullptr) ? qobject_cast<AbstractItem*>(to->toGraphicsObject()) : nullptr;
+
+        if (outputOwner == nullptr || inputOwner == nullptr) {
+            qWarning() << "Couldn't find the items of a removed connection";
+            continue;
+        }
+
+        ItemOutput* output = outputOwner->outputs().value(link.outputIndex);
+        ItemInput* input = inputOwner->inputs().value(link.inputIndex);
+
+        if (output == nullptr || input == nullptr || input->isConnected()) {
+            qWarning() << "Couldn't restore the connection between" << outputOwner->name() << "and" << inputOwner->name();
+            continue;
+        }
+
+        Item_Connector* connector = new Item_Connector(output, input);
+        connector->load_additional(link.path);
+        input->connectOutput(output); // data connection
+        journal.adopt(connector);
+        connector->schedule_update();
+        journal.bind(link.connector, connector);
+    }
+
+    _xml.clear(); // captured again by the next remove()
+}
+
+/**
+ * @brief The positions of items before and after a drag
+ */
+class ItemJournal::MoveEntry : public ItemJournal::Entry
+{
+public:
+    MoveEntry(QVector<int> const& ids, QVector<QPointF> const& from, QVector<QPointF> const& to)
+        : _ids(ids), _from(from), _to(to)
+    {
+    }
+
+    void undo(ItemJournal& journal) override
+    {
+        apply(journal, _from);
+    }
+
+    void redo(ItemJournal& journal) override
+    {
+        apply(journal, _to);
+    }
+
+    int cost() const override
+    {
+        return ENTRY_OVERHEAD + _ids.size() * int(sizeof(int) + 2 * sizeof(QPointF));
+    }
+
+private:
+    void apply(ItemJournal& journal, QVector<QPointF> const& positions)
+    {
+        for (int i = 0; i < _ids.size(); i++) {
+            QGraphicsItem* item = journal.resolve(_ids.at(i));
+
+            if (item != nullptr) {
+                item->setPos(positions.at(i));
+            }
+        }
+    }
+
+    QVector<int> _ids;
+    QVector<QPointF> _from;
+    QVector<QPointF> _to;
+};
+
+class ItemJournal::RenameEntry : public ItemJournal::Entry
+{
+public:
+    RenameEntry(int id, QString const& oldName, QString const& newName)
+        : _id(id), _oldName(oldName), _newName(newName)
+    {
+    }
+
+    void undo(ItemJournal& journal) override
+    {
+        apply(journal, _oldName);
+    }
+
+    void redo(ItemJournal& journal) override
+    {
+        apply(journal, _newName);
+    }
+
+    int cost() const override
+    {
+        return ENTRY_OVERHEAD + (_oldName.size() + _newName.size()) * int(sizeof(QChar));
+    }
+
+private:
+    void apply(ItemJournal& journal, QString const& name)
+    {
+        QGraphicsItem* item = journal.resolve(_id);
+
+        if (item != nullptr) {
+            static_cast<AbstractItem*>(item->toGraphicsObject())->setName(name);
+        }
+    }
+
+    int _id;
+    QString _oldName;
+    QString _newName;
+};
+
+/**
+ * @brief A value of the settings scope of an item. Consecutive changes of the same setting are merged,
+ * as long as each one follows the previous one within SETTING_MERGE_INTERVAL, e.g. while a slider is dragged.
+ */
+class ItemJournal::SettingEntry : public ItemJournal::Entry
+{
+public:
+    SettingEntry(int id, QString const& key, QVariant const& oldValue, QVariant const& newValue)
+        : _id(id), _key(key), _oldValue(oldValue), _newValue(newValue), _time(elapsedTime())
+    {
+    }
+
+    void undo(ItemJournal& journal) override
+    {
+        apply(journal, _oldValue);
+    }
+
+    void redo(ItemJournal& journal) override
+    {
+        apply(journal, _newValue);
+    }
+
+    int cost() const override
+    {
+        return ENTRY_OVERHEAD + _key.size() * int(sizeof(QChar)) + 2 * int(sizeof(QVariant));
+    }
+
+    bool merge(Entry const* next) override
+    {
+        SettingEntry const* setting = dynamic_cast<SettingEntry const*>(next);
+
+        if (setting == nullptr || setting->_id != _id || setting->_key != _key ||
+                setting->_time - _time > SETTING_MERGE_INTERVAL) {
+            return false;
+        }
+
+        _newValue = setting->_newValue;
+        _time = setting->_time;
+        return true;
+    }
+
+private:
+    void apply(ItemJournal& journal, QVariant const& value)
+    {
+        QGraphicsItem* item = journal.resolve(_id);
+
+        if (item != nullptr) {
+            static_cast<AbstractItem*>(item->toGraphicsObject())->settingsScope()->setValue(_key, value);
+        }
+    }
+
+    int _id;
+    QString _key;
+    QVariant _oldValue; // invalid if the setting was not defined
+    QVariant _newValue;
+    qint64 _time; // of the latest merged change
+};
+
+/**
+ * @brief The path of a connector before and after the user edited it
+ */
+class ItemJournal::PathEntry : public ItemJournal::Entry
+{
+public:
+    PathEntry(int id, QDomElement const& oldPath, QDomElement const& newPath)
+        : _id(id), _oldPath(oldPath), _newPath(newPath)
+    {
+    }
+
+    void undo(ItemJournal& journal) override
+    {
+        apply(journal, _oldPath);
+    }
+
+    void redo(ItemJournal& journal) override
+    {
+        apply(journal, _newPath);
+    }
+
+    int cost() const override
+    {
+        return ENTRY_OVERHEAD + 2 * PATH_SIZE;
+    }
+
+private:
+    void apply(ItemJournal& journal, QDomElement const& path)
+    {
+        QGraphicsItem* item = journal.resolve(_id);
+
+        if (item != nullptr) {
+            Item_Connector* connector = static_cast<Item_Connector*>(item->toGraphicsObject());
+            connector->load_additional(path);
+            connector->do_update();
+        }
+    }
+
+    int _id;
+    QDomElement _oldPath;
+    QDomElement _newPath;
+};
+
+ItemJournal::ItemJournal(ItemScene* scene, int memoryLimit)
+    : _scene(scene), _memoryLimit(memoryLimit)
+{
+}
+
+ItemJournal::~ItemJournal()
+{
+    qDeleteAll(_entries);
+
+    for (Watch const& watch : _watched) {
+        QObject::disconnect(watch.connection);
+    }
+}
+
+bool ItemJournal::canUndo() const
+{
+    return _index > 0;
+}
+
+bool ItemJournal::canRedo() const
+{
+    return _index < _entries.size();
+}
+
+void ItemJournal::undo()
+{
+    if (!canUndo()) {
+        return;
+    }
+
+    Entry* entry = _entries.at(--_index);
+    int const cost = entry->cost();
+
+    _replaying = true;
+    entry->undo(*this);
+    _replaying = false;
+
+    _totalCost += entry->cost() - cost; // removed items are kept as XML
+}
+
+void ItemJournal::redo()
+{
+    if (!canRedo()) {
+        return;
+    }
+
+    Entry* entry = _entries.at(_index++);
+    int const cost = entry->cost();
+
+    _replaying = true;
+    entry->redo(*this);
+    _replaying = false;
+
+    _totalCost += entry->cost() - cost;
+}
+
+void ItemJournal::clear()
+{
+    qDeleteAll(_entries);
+    _entries.clear();
+    _index = 0;
+    _totalCost = 0;
+    _ids.clear();
+    _items.clear();
+    _moveStart.clear();
+    _editedConnector = nullptr;
+}
+
+void ItemJournal::recordAdded(QList<QGraphicsItem*> const& items)
+{
+    if (!_replaying) {
+        push(new ItemsEntry(*this, items, true));
+    }
+}
+
+void ItemJournal::recordRemoval(QList<QGraphicsItem*> const& items)
+{
+    if (!_replaying) {
+        push(new ItemsEntry(*this, items, false));
+    }
+}
+
+void ItemJournal::beginMove(QList<QGraphicsItem*> const& items)
+{
+    _moveStart.clear();
+
+    for (QGraphicsItem* item : items) {
+        QGraphicsObject* object = item->toGraphicsObject();
+
+        if (qobject_cast<AbstractItem*>(object) != nullptr || qobject_cast<ItemNote*>(object) != nullptr) {
+            _moveStart.insert(item, item->pos());
+        }
+    }
+}
+
+void ItemJournal::endMove()
+{
+    QVector<int> ids;
+    QVector<QPointF> from;
+    QVector<QPointF> to;
+
+    for (auto it = _moveStart.constBegin(); it != _moveStart.constEnd(); ++it) {
+        if (it.key()->pos() != it.value()) {
+            ids.append(idOf(it.key()));
+            from.append(it.value());
+            to.append(it.key()->pos());
+        }
+    }
+
+    _moveStart.clear();
+
+    if (!ids.isEmpty() && !_replaying) {
+        push(new MoveEntry(ids, from, to));
+    }
+}
+
+void ItemJournal::recordRename(AbstractItem* item, QString const& oldName, QString const& newName)
+{
+    if (!_replaying) {
+        push(new RenameEntry(idOf(item), oldName, newName));
+    }
+}
+
+void ItemJournal::beginPathEdit(Item_Connector* connector)
+{
+    _editedConnector = connector;
+    _editedPath = pathOf(connector);
+}
+
+void ItemJournal::endPathEdit(Item_Connector* connector)
+{
+    if (connector != _editedConnector) {
+        return;
+    }
+
+    _editedConnector = nullptr;
+    QDomElement const path = pathOf(connector);
+
+    if (!_replaying && !samePath(path, _editedPath)) {
+        push(new PathEntry(idOf(connector), _editedPath, path));
+    }
+}
+
+void ItemJournal::watch(AbstractItem* item)
+{
+    SettingsScope* scope = item->settingsScope();
+
+    if (scope == nullptr || _watched.contains(item)) {
+        return;
+    }
+
+    Watch watch;
+    watch.settings = scope->allSettings(false);
+    watch.connection = QObject::connect(scope, &SettingsScope::valueChanged, _scene, [this, item](QString const & key) {
+        settingChanged(item, key);
+    });
+    _watched.insert(item, watch);
+}
+
+void ItemJournal::settingChanged(AbstractItem* item, QString const& key)
+{
+    auto watch = _watched.find(item);
+
+    if (watch == _watched.end()) {
+        return;
+    }
+
+    QVariant const value = item->settingsScope()->value(key, QVariant(), false);
+    QVariant const oldValue = watch->settings.value(key);
+
+    // Share the settings with the scope again, the copy the scope detached for this change is released
+    watch->settings = item->settingsScope()->allSettings(false);
+
+    if (value == oldValue) {
+        return; // a parent scope changed, or the value was set again
+    }
+
+    if (!_replaying) {
+        push(new SettingEntry(idOf(item), key, oldValue, value));
+    }
+}
+
+void ItemJournal::forget(QGraphicsItem* item)
+{
+    auto id = _ids.find(item);
+
+    if (id != _ids.end()) {
+        _items.remove(*id);
+        _ids.erase(id);
+    }
+
+    auto watch = _watched.find(item);
+
+    if (watch != _watched.end()) {
+        QObject::disconnect(watch->connection);
+        _watched.erase(watch);
+    }
+
+    _moveStart.remove(item);
+
+    if (_editedConnector != nullptr && static_cast<QGraphicsItem*>(_editedConnector) == item) {
+        _editedConnector = nullptr;
+    }
+}
+
+int ItemJournal::idOf(QGraphicsItem* item)
+{
+    auto it = _ids.find(item);
+
+    if (it != _ids.end()) {
+        return *it;
+    }
+
+    int const id = _nextId++;
+    bind(id, item);
+
+    return id;
+}
+
+QGraphicsItem* ItemJournal::resolve(int id) const
+{
+    return _items.value(id);
+}
+
+void ItemJournal::bind(int id, QGraphicsItem* item)
+{
+    _ids.insert(item, id);
+    _items.insert(id, item);
+}
+
+void ItemJournal::adopt(QGraphicsItem* item)
+{
+    _scene->adoptItem(item);
+}
+
+void ItemJournal::remove(QList<QGraphicsItem*> const& items)
+{
+    _scene->deleteItems(items);
+}
+
+QDomElement ItemJournal::pathOf(Item_Connector* connector)
+{
+    QDomElement path = _pathDocument.createElement("path");
+    connector->save_additional(_pathDocument, path);
+
+    return path;
+}
+
+void ItemJournal::push(Entry* entry)
+{
+    // A new edit makes the undone entries unreachable
+    while (_entries.size() > _index) {
+        Entry* undone = _entries.takeLast();
+        _totalCost -= undone->cost();
+        delete undone;
+    }
+
+    Entry* last = _entries.isEmpty() ? nullptr : _entries.last();
+    int const lastCost = last != nullptr ? last->cost() : 0;
+
+    if (last != nullptr && last->merge(entry)) {
+        _totalCost += last->cost() - lastCost;
+        delete entry;
+    } else {
+        _entries.append(entry);
+        _totalCost += entry->cost();
+        _index++;
+    }
+
+    trim();
+}
+
+void ItemJournal::trim()
+{
+    // Keep at least the latest entry, even if it is larger than the limit
+    while (_totalCost > _memoryLimit && _entries.size() > 1) {
+        Entry* oldest = _entries.takeFirst();
+        _totalCost -= oldest->cost();
+        delete oldest;
+        _index = qMax(0, _index - 1);
+    }
+}
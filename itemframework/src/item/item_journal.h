@@ -0,0 +1,141 @@
+#ifndef ITEM_JOURNAL_H
+#define ITEM_JOURNAL_H
+
+#include "appcore.h"
+
+#include <QDomDocument>
+#include <QHash>
+#include <QList>
+#include <QMetaObject>
+#include <QPointF>
+#include <QVariant>
+#include <QVector>
+
+class QGraphicsItem;
+class AbstractItem;
+class Item_Connector;
+class ItemScene;
+
+/**
+ * @brief The ItemJournal class records the edits of an ItemScene as deltas and undoes/redoes them.
+ *
+ * Every entry only stores what changed: the ids and positions of moved items, the old and new name of a renamed item,
+ * the old and new value of a setting, the old and new path of a connector. Removed items are kept as the XML of just
+ * these items, their connections as (item, port) pairs.
+ * Entries refer to items by journal ids instead of pointers, so they stay valid while an undo deletes an item and
+ * a redo creates it again.
+ * The entries are dropped oldest first once their estimated size exceeds the memory limit.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemJournal
+{
+public:
+    /**
+     * @param scene The scene whose edits are recorded
+     * @param memoryLimit The estimated size of all entries, in bytes
+     */
+    ItemJournal(ItemScene* scene, int memoryLimit);
+    ~ItemJournal();
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /**
+     * @brief Reverts the last recorded or redone edit
+     */
+    void undo();
+
+    /**
+     * @brief Repeats the last undone edit
+     */
+    void redo();
+
+    /**
+     * @brief Drops all entries, e.g. because the scene was cleared or loaded
+     */
+    void clear();
+
+    /**
+     * @brief Records that the user added \a items (items, notes and connectors) to the scene
+     */
+    void recordAdded(QList<QGraphicsItem*> const& items);
+
+    /**
+     * @brief Records that the user is about to delete \a items. Must be called before deleting them.
+     * The connectors of the items are recorded as well, as they are deleted together with them.
+     */
+    void recordRemoval(QList<QGraphicsItem*> const& items);
+
+    /**
+     * @brief Remembers the positions of \a items when a drag starts. endMove() records all of their moves as one entry.
+     */
+    void beginMove(QList<QGraphicsItem*> const& items);
+    void endMove();
+
+    /**
+     * @brief Records a rename of \a item
+     */
+    void recordRename(AbstractItem* item, QString const& oldName, QString const& newName);
+
+    /**
+     * @brief Remembers the path of \a connector when the user starts to edit it. endPathEdit() records the change.
+     */
+    void beginPathEdit(Item_Connector* connector);
+    void endPathEdit(Item_Connector* connector);
+
+    /**
+     * @brief Starts to record the setting changes of \a item. Called when the item enters the scene.
+     */
+    void watch(AbstractItem* item);
+
+    /**
+     * @brief Called when \a item leaves the scene. Entries referring to it stay, its id is bound again if it is recreated.
+     */
+    void forget(QGraphicsItem* item);
+
+private:
+    class Entry;
+    class ItemsEntry;
+    class MoveEntry;
+    class RenameEntry;
+    class SettingEntry;
+    class PathEntry;
+
+    // The settings are an implicitly shared copy of the local settings of the item, to know the old value of a change.
+    // They only take memory of their own while the scope changes a value, so they are not counted as entries.
+    struct Watch {
+        QMetaObject::Connection connection;
+        QHash<QString, QVariant> settings;
+    };
+
+    int idOf(QGraphicsItem* item);
+    QGraphicsItem* resolve(int id) const;
+    void bind(int id, QGraphicsItem* item);
+
+    void adopt(QGraphicsItem* item);
+    void remove(QList<QGraphicsItem*> const& items);
+
+    void push(Entry* entry);
+    void trim();
+    void settingChanged(AbstractItem* item, QString const& key);
+    QDomElement pathOf(Item_Connector* connector);
+
+    ItemScene* _scene;
+    int _memoryLimit;
+    bool _replaying = false;
+
+    QList<Entry*> _entries;
+    int _index = 0; // entries before the index are undoable, the others redoable
+    int _totalCost = 0; // of all entries, kept up to date by every change of an entry
+
+    int _nextId = 1;
+    QHash<QGraphicsItem*, int> _ids;
+    QHash<int, QGraphicsItem*> _items;
+
+    QHash<QGraphicsItem*, Watch> _watched;
+    QHash<QGraphicsItem*, QPointF> _moveStart;
+    Item_Connector* _editedConnector = nullptr;
+    QDomElement _editedPath;
+    QDomDocument _pathDocument; // owns the saved connector paths
+};
+
+#endif // ITEM_JOURNAL_H
@@ -0,0 +1,188 @@
+#include "item_mime_data.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+char const* const ItemMimeData::BinaryMimeType = "application/x-itemframework-items-binary";
+
+static quint32 const BinaryMagic = 0x49464954; // "IFIT"
+static quint16 const BinaryVersion = 1;
+static int const MaxBinaryDepth = 256; // the items are nested only a few levels, deeper data is corrupt
+
+enum BinaryNodeKind : quint8 {
+    ElementNode,
+    TextNode
+};
+
+static void encodeElement(QDataStream& stream, QDomElement const& element)
+{
+    QDomNamedNodeMap const attributes = element.attributes();
+    stream << element.tagName() << quint32(attributes.count());
+
+    for (int i = 0; i < attributes.count(); i++) {
+        QDomAttr const attribute = attributes.item(i).toAttr();
+        stream << attribute.name() << attribute.value();
+    }
+
+    QDomNodeList const children = element.childNodes();
+    stream << quint32(children.count());
+
+    for (int i = 0; i < children.count(); i++) {
+        QDomNode const child = children.at(i);
+
+        if (child.isElement()) {
+            stream << quint8(ElementNode);
+            encodeElement(stream, child.toElement());
+        } else {
+            stream << quint8(TextNode) << child.nodeValue(); // text and CDATA
+        }
+    }
+}
+
+static bool decodeElement(QDataStream& stream, QDomDocument& document, QDomNode& parent, int depth, QString* error)
+{
+    if (depth > MaxBinaryDepth) {
+        if (error != nullptr) {
+            *error = "Binary item data is nested too deeply";
+        }
+
+        return false;
+    }
+
+    QString tagName;
+    quint32 attributeCount = 0;
+    stream >> tagName >> attributeCount;
+
+    if (stream.status() != QDataStream::Ok) {
+        if (error != nullptr) {
+            *error = "Truncated binary item data";
+        }
+
+        return false;
+    }
+
+    QDomElement element = document.createElement(tagName);
+
+    for (quint32 i = 0; i < attributeCount && stream.status() == QDataStream::Ok; i++) {
+        QString name;
+        QString value;
+        stream >> name >> value;
+        element.setAttribute(name, value);
+    }
+
+    quint32 childCount = 0;
+    stream >> childCount;
+
+    for (quint32 i = 0; i < childCount && stream.status() == QDataStream::Ok; i++) {
+        quint8 kind = 0;
+        stream >> kind;
+
+        if (kind == ElementNode) {
+            if (!decodeElement(stream, document, element, depth + 1, error)) {
+                return false;
+            }
+        } else {
+            QString text;
+            stream >> text;
+            element.appendChild(document.createTextNode(text));
+        }
+    }
+
+    parent.appendChild(element);
+
+    if (stream.status() != QDataStream::Ok) {
+        if (error != nullptr) {
+            *error = "Truncated binary item data";
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+ItemMimeData::ItemMimeData(QDomDocument const& document, QString const& xmlMimeType)
+    : _document(document), _xmlMimeType(xmlMimeType)
+{
+}
+
+QStringList ItemMimeData::formats() const
+{
+    return { QString(BinaryMimeType), _xmlMimeType };
+}
+
+QVariant ItemMimeData::retrieveData(QString const& mimeType, QVariant::Type) const
+{
+    if (mimeType == _xmlMimeType) {
+        if (_xml.isNull()) {
+            _xml = _document.toByteArray();
+        }
+
+        return _xml;
+    }
+
+    if (mimeType == BinaryMimeType) {
+        if (_binary.isNull()) {
+            QDataStream stream(&_binary, QIODevice::WriteOnly);
+            stream.setVersion(QDataStream::Qt_5_0);
+            stream << BinaryMagic << BinaryVersion << _document.doctype().name();
+            encodeElement(stream, _document.documentElement());
+        }
+
+        return _binary;
+    }
+
+    return {};
+}
+
+QDomDocument ItemMimeData::document(QMimeData const& mimeData, QString const& xmlMimeType, QString* error)
+{
+    // Our own clipboard content, nothing to decode
+    ItemMimeData const* itemMimeData = qobject_cast<ItemMimeData const*>(&mimeData);
+
+    if (itemMimeData != nullptr) {
+        return itemMimeData->_document.cloneNode(true).toDocument();
+    }
+
+    static QByteArray lastData;
+    static QDomDocument lastDocument;
+
+    bool const binary = mimeData.hasFormat(BinaryMimeType);
+    QByteArray const data = mimeData.data(binary ? QString(BinaryMimeType) : xmlMimeType);
+
+    if (!lastDocument.isNull() && data == lastData) {
+        return lastDocument.cloneNode(true).toDocument();
+    }
+
+    QDomDocument document;
+
+    if (binary) {
+        QDataStream stream(data);
+        stream.setVersion(QDataStream::Qt_5_0);
+        quint32 magic = 0;
+        quint16 version = 0;
+        QString docType;
+        stream >> magic >> version >> docType;
+
+        if (magic != BinaryMagic || version != BinaryVersion) {
+            if (error != nullptr) {
+                *error = "Unknown binary item format";
+            }
+
+            return {};
+        }
+
+        document = QDomDocument(docType);
+
+        if (!decodeElement(stream, document, document, 0, error)) {
+            return {};
+        }
+    } else if (!document.setContent(data, error)) {
+        return {};
+    }
+
+    lastData = data;
+    lastDocument = document.cloneNode(true).toDocument();
+
+    return document;
+}
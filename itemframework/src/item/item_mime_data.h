@@ -0,0 +1,55 @@
+#ifndef ITEM_MIME_DATA_H
+#define ITEM_MIME_DATA_H
+
+#include "appcore.h"
+
+#include <QDomDocument>
+#include <QMimeData>
+
+/**
+ * @brief The ItemMimeData class puts serialized items on the clipboard without converting them up front.
+ *
+ * It keeps the QDomDocument written by ItemSerializer::saveToXml(). A paste within the application reads this document
+ * directly. Other applications can request two formats, which are only encoded when requested:
+ * - the XML mime type passed to the constructor, the document as XML text,
+ * - BinaryMimeType, a compact binary encoding of the document. It is read without parsing XML text, e.g. by another
+ *   instance of this application.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    static char const* const BinaryMimeType;
+
+    /**
+     * @param document The serialized items
+     * @param xmlMimeType The mime type of the XML representation
+     */
+    ItemMimeData(QDomDocument const& document, QString const& xmlMimeType);
+
+    QStringList formats() const override;
+
+    /**
+     * @brief Returns the serialized items of \a mimeData.
+     * The document of an ItemMimeData is used directly, otherwise the binary or XML representation is decoded.
+     * The last decoded document is cached, so pasting the same clipboard content again does not decode it again.
+     * The returned document is always a deep copy, changing it neither changes the clipboard content nor the cache.
+     * @param mimeData The clipboard or drag & drop data
+     * @param xmlMimeType The mime type of the XML representation
+     * @param error Receives a description if the data could not be decoded
+     * @return The document, or a null document on failure
+     */
+    static QDomDocument document(QMimeData const& mimeData, QString const& xmlMimeType, QString* error = nullptr);
+
+protected:
+    QVariant retrieveData(QString const& mimeType, QVariant::Type type) const override;
+
+private:
+    QDomDocument const _document;
+    QString const _xmlMimeType;
+    mutable QByteArray _xml;
+    mutable QByteArray _binary;
+};
+
+#endif // ITEM_MIME_DATA_H
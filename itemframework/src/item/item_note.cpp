@@ -11,7 +11,8 @@
 #include <QGraphicsScene>
 #include <QTextCursor>
 #include <QColorDialog>
-#include "res/resource.h"
+#include "res/theme.h"
+#include "item_scene.h"
 
 #define BOUNDING_SPACE 10
 #define TEXT_MARGIN QPointF(5,5)
@@ -25,7 +26,7 @@ ItemNote::ItemNote() : QGraphicsObject()
     setAcceptHoverEvents(true);
     _resizeMode = false;
     _editMode = false;
-    _color = Resource::get("item_note_bgcolor", QColor(249, 238, 122));
+    _color = Theme::current().itemNoteBackground;
 
     _textItem = new QGraphicsTextItem("This is a Note.\nDouble-Click to edit.", this);
     _textItem->setDefaultTextColor(Qt::black);
@@ -42,6 +43,8 @@ ItemNote::~ItemNote()
 
 QVariant ItemNote::itemChange(GraphicsItemChange change, QVariant const& value)
 {
+    ItemScene::trackItemChange(this, change);
+
     if (change == QGraphicsItem::ItemSelectedHasChanged) {
         if (!isSelected()) {
             stopEdit();
@@ -147,6 +150,7 @@ void ItemNote::updateSize()
     _shape.setHeight(_textItem->boundingRect().height() + 2 * TEXT_MARGIN.y());
     _shape.setWidth(_textItem->boundingRect().width() + 2 * TEXT_MARGIN.x());
     _boundingRect = _shape.adjusted(-BOUNDING_SPACE, -BOUNDING_SPACE, BOUNDING_SPACE, BOUNDING_SPACE);
+    ItemScene::updateItemBounds(this);
     emit changed();
 }
 
@@ -176,7 +180,7 @@ void ItemNote::paint(QPainter* painter, QStyleOptionGraphicsItem const*, QWidget
 
     if (isSelected()) {
         painter->setBrush(Qt::NoBrush);
-        painter->setPen(Resource::get("item_box_selected_pen", QPen(Qt::black, 1, Qt::DashLine)));
+        painter->setPen(Theme::current().itemBoxSelectedPen);
         painter->drawRect(_boundingRect);
 
     }
@@ -3,6 +3,7 @@
 #include "item/item_input.h"
 #include "item_input_p.h"
 #include "item/abstract_item.h"
+#include "item_batch_p.h"
 
 ItemOutput::ItemOutput(AbstractItem* owner, int type, QString const& description, QRectF const& shape)
     : AbstractItemInputOutputBase(owner, type, description, shape), d_ptr(new ItemOutputPrivate(this))
@@ -11,7 +12,7 @@ ItemOutput::ItemOutput(AbstractItem* owner, int type, QString const& description
 
 ItemOutput::~ItemOutput()
 {
-
+    ItemBatchPrivate::forget(d_ptr.data());
 }
 
 ItemOutputPrivate::ItemOutputPrivate(ItemOutput* parent) :
@@ -67,6 +68,15 @@ void ItemOutputPrivate::disconnectInput(ItemInput* input)
     Q_Q(ItemOutput);
 
     _inputs.removeOne(input);
+
+    if (_pendingInputs.removeOne(input)) {
+        if (_pendingInputs.isEmpty()) {
+            ItemBatchPrivate::forget(this);
+        }
+
+        return; // the connection was not reported yet, so neither is its removal
+    }
+
     emit q->inputDisconnected();
 }
 
@@ -97,12 +107,26 @@ bool ItemOutput::connectInput(ItemInput* input)
 }
 
 void ItemOutputPrivate::connectInput(ItemInput* input)
+{
+    _inputs.append(input);
+    _pendingInputs.append(input);
+
+    if (!ItemBatchPrivate::deferConnected(this)) {
+        notifyConnected();
+    }
+}
+
+void ItemOutputPrivate::notifyConnected()
 {
     Q_Q(ItemOutput);
 
-    _inputs.append(input);
+    // Take the list first, receivers may connect further inputs
+    QList<ItemInput*> pendingInputs;
+    pendingInputs.swap(_pendingInputs);
 
-    emit q->inputConnected();
+    for (int i = 0; i < pendingInputs.size(); i++) {
+        emit q->inputConnected();
+    }
 }
 
 void ItemOutput::setData(QObject* data)
@@ -17,8 +17,10 @@ public:
 
     void disconnectInput(ItemInput* input);
     void connectInput(ItemInput* input);
+    void notifyConnected(); // emits inputConnected() once per pending input, possibly deferred by an ItemBatch
 
     QList<ItemInput*> _inputs;
+    QList<ItemInput*> _pendingInputs; // connected, but not reported yet
     QObject* _data = nullptr;
 };
 
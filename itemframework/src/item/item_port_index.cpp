@@ -0,0 +1,125 @@
+#include "item_port_index.h"
+#include "item/abstract_item_input_output_base.h"
+#include "item/item_input.h"
+
+#include <qmath.h>
+
+ItemPortIndex::ItemPortIndex(qreal cellSize)
+    : _cellSize(cellSize)
+{
+}
+
+ItemPortIndex::Cell ItemPortIndex::cellAt(QPointF const& position) const
+{
+    return Cell(qFloor(position.x() / _cellSize), qFloor(position.y() / _cellSize));
+}
+
+void ItemPortIndex::update(AbstractItemInputOutputBase* port)
+{
+    QPointF const position = port->scenePosition();
+    Cell const cell = cellAt(position);
+    auto it = _entries.find(port);
+
+    if (it == _entries.end()) {
+        // The direction never changes, so the cast is only done once per port
+        Direction const direction = (qobject_cast<ItemInput*>(port) != nullptr) ? Input : Output;
+        Entry const entry{GridKey(direction, port->transportType()), cell, position};
+        _entries.insert(port, entry);
+        _grids[entry.key][cell].append(port);
+        return;
+    }
+
+    it->position = position;
+
+    if (it->cell != cell) {
+        Grid& grid = _grids[it->key];
+        auto oldCell = grid.find(it->cell);
+
+        if (oldCell != grid.end()) {
+            oldCell->removeOne(port);
+
+            if (oldCell->isEmpty()) {
+                grid.erase(oldCell);
+            }
+        }
+
+        grid[cell].append(port);
+        it->cell = cell;
+    }
+}
+
+void ItemPortIndex::remove(AbstractItemInputOutputBase* port)
+{
+    auto it = _entries.find(port);
+
+    if (it == _entries.end()) {
+        return;
+    }
+
+    Grid& grid = _grids[it->key];
+    auto cell = grid.find(it->cell);
+
+    if (cell != grid.end()) {
+        cell->removeOne(port);
+
+        if (cell->isEmpty()) {
+            grid.erase(cell);
+        }
+    }
+
+    _entries.erase(it);
+}
+
+void ItemPortIndex::nearestInGrid(Grid const& grid, QPointF const& position, Filter const& filter,
+                                  qreal& smallestDistance, AbstractItemInputOutputBase*& result) const
+{
+    Cell const from = cellAt(position - QPointF(smallestDistance, smallestDistance));
+    Cell const to = cellAt(position + QPointF(smallestDistance, smallestDistance));
+
+    for (int x = from.first; x <= to.first; x++) {
+        for (int y = from.second; y <= to.second; y++) {
+            auto cell = grid.constFind(Cell(x, y));
+
+            if (cell == grid.constEnd()) {
+                continue;
+            }
+
+            for (AbstractItemInputOutputBase* port : *cell) {
+                QPointF const delta = _entries.value(port).position - position;
+                qreal const distance = qSqrt(delta.x() * delta.x() + delta.y() * delta.y());
+
+                if (distance < smallestDistance && (!filter || filter(port))) {
+                    smallestDistance = distance;
+                    result = port;
+                }
+            }
+        }
+    }
+}
+
+AbstractItemInputOutputBase* ItemPortIndex::nearest(QPointF const& position, qreal maxDistance, Direction direction,
+        int transportType, Filter const& filter) const
+{
+    AbstractItemInputOutputBase* result = nullptr;
+    auto grid = _grids.constFind(GridKey(direction, transportType));
+
+    if (grid != _grids.constEnd()) {
+        nearestInGrid(*grid, position, filter, maxDistance, result);
+    }
+
+    return result;
+}
+
+AbstractItemInputOutputBase* ItemPortIndex::nearest(QPointF const& position, qreal maxDistance, Direction direction,
+        Filter const& filter) const
+{
+    AbstractItemInputOutputBase* result = nullptr;
+
+    for (auto grid = _grids.constBegin(); grid != _grids.constEnd(); ++grid) {
+        if (grid.key().first == direction) {
+            nearestInGrid(*grid, position, filter, maxDistance, result);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,89 @@
+#ifndef ITEM_PORT_INDEX_H
+#define ITEM_PORT_INDEX_H
+
+#include "appcore.h"
+
+#include <QHash>
+#include <QPointF>
+#include <QVector>
+#include <functional>
+
+class AbstractItemInputOutputBase;
+
+/**
+ * @brief The ItemPortIndex class is a spatial index over all inputs and outputs of an ItemScene.
+ *
+ * The ports are kept in a uniform grid, separated by direction and transport type. A nearest port
+ * query only visits the grid cells around the query position of the requested direction and type,
+ * so it never touches other graphics items of the scene.
+ * The index caches the scene position of every port. The ports keep it up to date
+ * (see AbstractItemInputOutputBase::updateScenePosition()).
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemPortIndex
+{
+public:
+    enum Direction {
+        Input,
+        Output
+    };
+
+    /**
+     * @brief A predicate which decides whether a port found by a query is acceptable
+     */
+    using Filter = std::function<bool(AbstractItemInputOutputBase*)>;
+
+    /**
+     * @brief Constructs an empty index
+     * @param cellSize The edge length of a grid cell. Should be in the range of the typical query distance.
+     */
+    explicit ItemPortIndex(qreal cellSize = 60);
+
+    /**
+     * @brief Adds \a port to the index or updates its position if it is already indexed
+     */
+    void update(AbstractItemInputOutputBase* port);
+
+    /**
+     * @brief Removes \a port from the index. Does nothing if it was not indexed.
+     */
+    void remove(AbstractItemInputOutputBase* port);
+
+    /**
+     * @brief Returns the port closest to \a position
+     * @param position The query position in scene coordinates
+     * @param maxDistance Only ports closer than this distance are considered
+     * @param direction Whether inputs or outputs are searched
+     * @param transportType The transport type of the port
+     * @param filter Optional predicate the port must fulfill
+     * @return The closest matching port or nullptr
+     */
+    AbstractItemInputOutputBase* nearest(QPointF const& position, qreal maxDistance, Direction direction,
+                                         int transportType, Filter const& filter = Filter()) const;
+
+    /**
+     * @brief Same as above, but considers ports of all transport types
+     */
+    AbstractItemInputOutputBase* nearest(QPointF const& position, qreal maxDistance, Direction direction,
+                                         Filter const& filter = Filter()) const;
+
+private:
+    using Cell = QPair<int, int>;
+    using Grid = QHash<Cell, QVector<AbstractItemInputOutputBase*>>;
+    using GridKey = QPair<int, int>; // (direction, transport type)
+
+    struct Entry {
+        GridKey key;
+        Cell cell;
+        QPointF position;
+    };
+
+    Cell cellAt(QPointF const& position) const;
+    void nearestInGrid(Grid const& grid, QPointF const& position, Filter const& filter,
+                       qreal& smallestDistance, AbstractItemInputOutputBase*& result) const;
+
+    qreal _cellSize;
+    QHash<GridKey, Grid> _grids;
+    QHash<AbstractItemInputOutputBase*, Entry> _entries;
+};
+
+#endif // ITEM_PORT_INDEX_H
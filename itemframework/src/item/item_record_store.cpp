@@ -0,0 +1,222 @@
+#include "item_record_store.h"
+#include "item_serializer.h"
+
+#include <qmath.h>
+
+#define ITEM_EXTENT 60 // [px] estimated distance from the position to the edges of an item, including its labels
+
+ItemRecordStore::ItemRecordStore(qreal cellSize)
+    : _cellSize(cellSize), _count(0), _boundsValid(true)
+{
+}
+
+QVector<ItemRecordStore::Cell> ItemRecordStore::cellsOf(QRectF const& rect) const
+{
+    QVector<Cell> cells;
+    int const left = qFloor(rect.left() / _cellSize);
+    int const right = qFloor(rect.right() / _cellSize);
+    int const top = qFloor(rect.top() / _cellSize);
+    int const bottom = qFloor(rect.bottom() / _cellSize);
+
+    for (int x = left; x <= right; x++) {
+        for (int y = top; y <= bottom; y++) {
+            cells.append(Cell(x, y));
+        }
+    }
+
+    return cells;
+}
+
+void ItemRecordStore::clear()
+{
+    _document = QDomDocument();
+    _components.clear();
+    _cells.clear();
+    _count = 0;
+    _bounds = QRectF();
+    _boundsValid = true;
+}
+
+QDomElement ItemRecordStore::load(QDomElement const& items, QDomDocument& remaining)
+{
+    clear();
+    _rootTag = items.tagName();
+
+    QDomElement remainingRoot = remaining.createElement(_rootTag);
+    QList<QDomElement> itemElements;
+    QList<QDomElement> connectorElements;
+    QHash<qint32, qint32> parents; // union find over the item ids
+
+    auto find = [&parents](qint32 id) {
+        while (parents.value(id, id) != id) {
+            id = parents.value(id);
+        }
+
+        return id;
+    };
+
+    for (QDomNode node = items.firstChild(); !node.isNull(); node = node.nextSibling()) {
+        QDomElement const element = node.toElement();
+
+        if (element.isNull()) {
+            continue;
+        }
+
+        if (ItemSerializer::isItemElement(element)) {
+            itemElements.append(_document.importNode(element, true).toElement());
+            parents.insert(ItemSerializer::itemId(element), ItemSerializer::itemId(element));
+        } else if (ItemSerializer::isConnectorElement(element)) {
+            connectorElements.append(_document.importNode(element, true).toElement());
+            QPair<qint32, qint32> const ends = ItemSerializer::connectorItemIds(element);
+
+            if (parents.contains(ends.first) && parents.contains(ends.second)) {
+                parents.insert(find(ends.first), find(ends.second));
+            }
+        } else {
+            remainingRoot.appendChild(remaining.importNode(element, true));
+        }
+    }
+
+    // Number the components in document order
+    QHash<qint32, int> componentOfRoot;
+
+    for (QDomElement const& element : itemElements) {
+        qint32 const root = find(ItemSerializer::itemId(element));
+
+        if (!componentOfRoot.contains(root)) {
+            componentOfRoot.insert(root, componentOfRoot.size());
+        }
+
+        QPointF const position = ItemSerializer::itemPosition(element);
+        Component& component = _components[componentOfRoot.value(root)];
+        component.items.append(element);
+        component.bounds |= QRectF(position - QPointF(ITEM_EXTENT, ITEM_EXTENT), QSizeF(2 * ITEM_EXTENT, 2 * ITEM_EXTENT));
+        _count++;
+    }
+
+    for (QDomElement const& element : connectorElements) {
+        // Dangling connectors stay with the item they reference, ItemSerializer reports them once they are loaded
+        QPair<qint32, qint32> const ends = ItemSerializer::connectorItemIds(element);
+        qint32 const end = parents.contains(ends.first) ? ends.first : ends.second;
+
+        if (parents.contains(end)) {
+            _components[componentOfRoot.value(find(end))].connectors.append(element);
+        }
+    }
+
+    for (auto it = _components.constBegin(); it != _components.constEnd(); ++it) {
+        for (Cell const& cell : cellsOf(it->bounds)) {
+            _cells[cell].append(it.key());
+        }
+    }
+
+    _boundsValid = false;
+
+    return remainingRoot;
+}
+
+bool ItemRecordStore::isEmpty() const
+{
+    return _components.isEmpty();
+}
+
+int ItemRecordStore::count() const
+{
+    return _count;
+}
+
+QRectF ItemRecordStore::bounds() const
+{
+    if (!_boundsValid) {
+        _bounds = QRectF();
+
+        for (Component const& component : _components) {
+            _bounds |= component.bounds;
+        }
+
+        _boundsValid = true;
+    }
+
+    return _bounds;
+}
+
+QDomElement ItemRecordStore::take(QRectF const& rect, QDomDocument& document)
+{
+    QList<int> components;
+
+    for (Cell const& c : cellsOf(rect)) {
+        auto cell = _cells.constFind(c);
+
+        if (cell == _cells.constEnd()) {
+            continue;
+        }
+
+        for (int component : *cell) {
+            if (!components.contains(component) && _components.value(component).bounds.intersects(rect)) {
+                components.append(component);
+            }
+        }
+    }
+
+    return takeComponents(components, document);
+}
+
+QDomElement ItemRecordStore::takeComponents(QList<int> const& components, QDomDocument& document)
+{
+    QDomElement root = document.createElement(_rootTag);
+    QList<QDomElement> connectors;
+
+    for (int id : components) {
+        Component const component = _components.take(id);
+
+        for (Cell const& c : cellsOf(component.bounds)) {
+            auto cell = _cells.find(c);
+
+            if (cell != _cells.end()) {
+                cell->removeOne(id);
+
+                if (cell->isEmpty()) {
+                    _cells.erase(cell);
+                }
+            }
+        }
+
+        // The items must precede the connectors which reference them
+        for (QDomElement const& element : component.items) {
+            root.appendChild(document.importNode(element, true));
+        }
+
+        connectors.append(component.connectors);
+        _count -= component.items.size();
+        _boundsValid = false;
+    }
+
+    for (QDomElement const& element : connectors) {
+        root.appendChild(document.importNode(element, true));
+    }
+
+    return root;
+}
+
+void ItemRecordStore::saveToXml(QDomDocument& document, QDomElement& xml, qint32 firstId) const
+{
+    qint32 nextId = firstId;
+
+    for (Component const& component : _components) {
+        QHash<qint32, qint32> ids; // id in the store -> saved id
+
+        for (QDomElement const& record : component.items) {
+            QDomElement element = document.importNode(record, true).toElement();
+            ids.insert(ItemSerializer::itemId(record), nextId);
+            ItemSerializer::setItemId(element, nextId++);
+            xml.appendChild(element);
+        }
+
+        for (QDomElement const& record : component.connectors) {
+            QDomElement element = document.importNode(record, true).toElement();
+            QPair<qint32, qint32> const ends = ItemSerializer::connectorItemIds(record);
+            ItemSerializer::setConnectorItemIds(element, ids.value(ends.first, -1), ids.value(ends.second, -1));
+            xml.appendChild(element);
+        }
+    }
+}
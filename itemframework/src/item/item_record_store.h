@@ -0,0 +1,96 @@
+#ifndef ITEM_RECORD_STORE_H
+#define ITEM_RECORD_STORE_H
+
+#include "appcore.h"
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * @brief The ItemRecordStore class keeps items of a virtualized ItemScene as lightweight XML records.
+ *
+ * A record is the serialized form of an item (type, position, name and item data) as written by ItemSerializer.
+ * Items which are linked by connectors form a component. Components are only taken out of the store as a whole,
+ * so a created item always has all of its connections and the data flow between created items stays intact.
+ * The components are kept in a uniform grid, so the components in a viewport are found without visiting all records.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemRecordStore
+{
+public:
+    /**
+     * @brief Constructs an empty store
+     * @param cellSize The edge length of a grid cell, should be in the range of a viewport
+     */
+    explicit ItemRecordStore(qreal cellSize = 500);
+
+    /**
+     * @brief Replaces the content of the store by all items and connectors of \a items
+     * @param items An element in the format of ItemSerializer::saveToXml()
+     * @param remaining Receives an element with all other children of \a items (e.g. notes), which must be loaded directly
+     * @return The element with the remaining children, created in the document \a remaining
+     */
+    QDomElement load(QDomElement const& items, QDomDocument& remaining);
+
+    /**
+     * @brief Removes all records
+     */
+    void clear();
+
+    /**
+     * @return true if there are no records
+     */
+    bool isEmpty() const;
+
+    /**
+     * @return The number of item records
+     */
+    int count() const;
+
+    /**
+     * @return The estimated scene area covered by all records
+     */
+    QRectF bounds() const;
+
+    /**
+     * @brief Removes all components which intersect \a rect from the store
+     * @param rect An area in scene coordinates
+     * @param document The document to create the returned element in
+     * @return An element with the items and connectors of the removed components, which can be loaded with ItemSerializer::loadFromXml()
+     */
+    QDomElement take(QRectF const& rect, QDomDocument& document);
+
+    /**
+     * @brief Appends all records to \a xml in the format of ItemSerializer::saveToXml()
+     * @param firstId The item id of the first record. Ids below are used by the items saved before.
+     */
+    void saveToXml(QDomDocument& document, QDomElement& xml, qint32 firstId) const;
+
+private:
+    using Cell = QPair<int, int>;
+
+    struct Component {
+        QList<QDomElement> items;
+        QList<QDomElement> connectors;
+        QRectF bounds;
+    };
+
+    QVector<Cell> cellsOf(QRectF const& rect) const;
+    QDomElement takeComponents(QList<int> const& components, QDomDocument& document);
+
+    qreal _cellSize;
+    QString _rootTag;
+    QDomDocument _document; // owns the records
+    QMap<int, Component> _components; // ordered, so saving is deterministic
+    QHash<Cell, QVector<int>> _cells;
+    int _count;
+
+    mutable QRectF _bounds;
+    mutable bool _boundsValid;
+};
+
+#endif // ITEM_RECORD_STORE_H
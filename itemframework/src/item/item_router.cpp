@@ -0,0 +1,393 @@
+#include "item_router.h"
+
+#include <QtGlobal>
+#include <qmath.h>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#define BEND_PENALTY 40 // [px] a bend costs as much as this length
+#define SEARCH_MARGIN 150 // [px] the first search only uses the graph around the end points
+#define MAX_SEARCH_NODES 40000 // larger searches are not interactive anymore
+
+ItemRouter::ItemRouter(qreal clearance, qreal stub)
+    : _clearance(clearance), _stub(stub), _cellSize(200)
+{
+}
+
+QVector<ItemRouter::Cell> ItemRouter::cellsOf(QRectF const& rect) const
+{
+    QVector<Cell> cells;
+    int const left = qFloor(rect.left() / _cellSize);
+    int const right = qFloor(rect.right() / _cellSize);
+    int const top = qFloor(rect.top() / _cellSize);
+    int const bottom = qFloor(rect.bottom() / _cellSize);
+
+    for (int x = left; x <= right; x++) {
+        for (int y = top; y <= bottom; y++) {
+            cells.append(Cell(x, y));
+        }
+    }
+
+    return cells;
+}
+
+void ItemRouter::addLines(QRectF const& box)
+{
+    _xLines[box.left()]++;
+    _xLines[box.right()]++;
+    _yLines[box.top()]++;
+    _yLines[box.bottom()]++;
+}
+
+static void releaseLine(QMap<qreal, int>& lines, qreal coordinate)
+{
+    auto it = lines.find(coordinate);
+
+    if (it != lines.end() && --it.value() <= 0) {
+        lines.erase(it);
+    }
+}
+
+void ItemRouter::removeLines(QRectF const& box)
+{
+    releaseLine(_xLines, box.left());
+    releaseLine(_xLines, box.right());
+    releaseLine(_yLines, box.top());
+    releaseLine(_yLines, box.bottom());
+}
+
+void ItemRouter::addToCells(Cells& cells, QGraphicsItem const* item, QRectF const& box)
+{
+    for (Cell const& cell : cellsOf(box)) {
+        cells[cell].append(item);
+    }
+}
+
+void ItemRouter::removeFromCells(Cells& cells, QGraphicsItem const* item, QRectF const& box)
+{
+    for (Cell const& cell : cellsOf(box)) {
+        auto it = cells.find(cell);
+
+        if (it != cells.end()) {
+            it->removeOne(item);
+
+            if (it->isEmpty()) {
+                cells.erase(it);
+            }
+        }
+    }
+}
+
+void ItemRouter::updateObstacle(QGraphicsItem const* item, QRectF const& box)
+{
+    QRectF const inflated = box.adjusted(-_clearance, -_clearance, _clearance, _clearance);
+    auto it = _obstacles.find(item);
+
+    if (it != _obstacles.end()) {
+        if (*it == inflated) {
+            return;
+        }
+
+        removeLines(*it);
+        removeFromCells(_cells, item, *it);
+        *it = inflated;
+    } else {
+        _obstacles.insert(item, inflated);
+    }
+
+    addLines(inflated);
+    addToCells(_cells, item, inflated);
+}
+
+void ItemRouter::removeObstacle(QGraphicsItem const* item)
+{
+    auto it = _obstacles.find(item);
+
+    if (it == _obstacles.end()) {
+        return;
+    }
+
+    removeLines(*it);
+    removeFromCells(_cells, item, *it);
+    _obstacles.erase(it);
+}
+
+void ItemRouter::updateRoute(QGraphicsItem const* connector, QRectF const& bounds)
+{
+    auto it = _routes.find(connector);
+
+    if (it != _routes.end()) {
+        if (*it == bounds) {
+            return;
+        }
+
+        removeFromCells(_routeCells, connector, *it);
+        *it = bounds;
+    } else {
+        _routes.insert(connector, bounds);
+    }
+
+    addToCells(_routeCells, connector, bounds);
+}
+
+void ItemRouter::removeRoute(QGraphicsItem const* connector)
+{
+    auto it = _routes.find(connector);
+
+    if (it == _routes.end()) {
+        return;
+    }
+
+    removeFromCells(_routeCells, connector, *it);
+    _routes.erase(it);
+}
+
+QList<QGraphicsItem const*> ItemRouter::routesIntersecting(QRectF const& box) const
+{
+    QList<QGraphicsItem const*> result;
+
+    for (Cell const& c : cellsOf(box)) {
+        auto cell = _routeCells.constFind(c);
+
+        if (cell == _routeCells.constEnd()) {
+            continue;
+        }
+
+        // A route spanning several cells is listed in each of them
+        for (QGraphicsItem const* connector : *cell) {
+            if (_routes[connector].intersects(box) && !result.contains(connector)) {
+                result.append(connector);
+            }
+        }
+    }
+
+    return result;
+}
+
+bool ItemRouter::isFree(QPointF const& point) const
+{
+    auto cell = _cells.constFind(Cell(qFloor(point.x() / _cellSize), qFloor(point.y() / _cellSize)));
+
+    if (cell == _cells.constEnd()) {
+        return true;
+    }
+
+    for (QGraphicsItem const* item : *cell) {
+        QRectF const& box = _obstacles[item];
+
+        // Only the interior is blocked, routes may run along the (inflated) border
+        if (point.x() > box.left() && point.x() < box.right() && point.y() > box.top() && point.y() < box.bottom()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ItemRouter::isFree(QPointF const& from, QPointF const& to) const
+{
+    QRectF const segment = QRectF(from, to).normalized();
+
+    for (Cell const& c : cellsOf(segment)) {
+        auto cell = _cells.constFind(c);
+
+        if (cell == _cells.constEnd()) {
+            continue;
+        }
+
+        for (QGraphicsItem const* item : *cell) {
+            QRectF const& box = _obstacles[item];
+
+            // The segment is either horizontal or vertical, so it crosses the interior if it overlaps in both dimensions
+            bool const overlapsX = qMax(segment.left(), box.left()) < qMin(segment.right(), box.right()) ||
+                                   (segment.width() == 0 && segment.left() > box.left() && segment.left() < box.right());
+            bool const overlapsY = qMax(segment.top(), box.top()) < qMin(segment.bottom(), box.bottom()) ||
+                                   (segment.height() == 0 && segment.top() > box.top() && segment.top() < box.bottom());
+
+            if (overlapsX && overlapsY) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static QVector<qreal> linesInRange(QMap<qreal, int> const& lines, qreal from, qreal to, qreal a, qreal b)
+{
+    QVector<qreal> result;
+
+    for (auto it = lines.lowerBound(from); it != lines.constEnd() && it.key() <= to; ++it) {
+        result.append(it.key());
+    }
+
+    result.append(a);
+    result.append(b);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+bool ItemRouter::search(QPointF const& from, QPointF const& to, QRectF const& window, QVector<QPointF>& path) const
+{
+    QVector<qreal> const xs = linesInRange(_xLines, window.left(), window.right(), from.x(), to.x());
+    QVector<qreal> const ys = linesInRange(_yLines, window.top(), window.bottom(), from.y(), to.y());
+    int const columns = xs.size();
+    int const rows = ys.size();
+
+    if (columns * rows > MAX_SEARCH_NODES) {
+        return false;
+    }
+
+    auto nodeAt = [columns](int x, int y) {
+        return y * columns + x;
+    };
+    auto position = [&](int node) {
+        return QPointF(xs.at(node % columns), ys.at(node / columns));
+    };
+    auto heuristic = [&](int node) {
+        QPointF const p = position(node);
+        return qAbs(p.x() - to.x()) + qAbs(p.y() - to.y());
+    };
+
+    int const startNode = nodeAt(std::lower_bound(xs.begin(), xs.end(), from.x()) - xs.begin(),
+                                 std::lower_bound(ys.begin(), ys.end(), from.y()) - ys.begin());
+    int const goalNode = nodeAt(std::lower_bound(xs.begin(), xs.end(), to.x()) - xs.begin(),
+                                std::lower_bound(ys.begin(), ys.end(), to.y()) - ys.begin());
+
+    // A state is a node plus the axis it was entered on (0 = horizontal, 1 = vertical)
+    qreal const infinity = std::numeric_limits<qreal>::max();
+    QVector<qreal> cost(columns * rows * 2, infinity);
+    QVector<int> previous(columns * rows * 2, -1);
+
+    using QueueEntry = QPair<qreal, int>; // (estimated total cost, state)
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+    int const startState = startNode * 2; // the route leaves the output horizontally
+    cost[startState] = 0;
+    open.push(QueueEntry(heuristic(startNode), startState));
+
+    qreal bestCost = infinity;
+    int bestState = -1;
+
+    while (!open.empty()) {
+        QueueEntry const entry = open.top();
+        open.pop();
+
+        if (entry.first >= bestCost) {
+            break; // no remaining state can beat the best route
+        }
+
+        int const state = entry.second;
+        int const node = state / 2;
+        int const axis = state % 2;
+        qreal const currentCost = cost[state];
+
+        if (entry.first > currentCost + heuristic(node)) {
+            continue; // outdated entry
+        }
+
+        if (node == goalNode) {
+            // The route enters the input horizontally
+            qreal const total = currentCost + (axis == 1 ? BEND_PENALTY : 0);
+
+            if (total < bestCost) {
+                bestCost = total;
+                bestState = state;
+            }
+
+            continue;
+        }
+
+        int const x = node % columns;
+        int const y = node / columns;
+        int const neighbors[4][3] = {{x - 1, y, 0}, {x + 1, y, 0}, {x, y - 1, 1}, {x, y + 1, 1}};
+
+        for (auto const& neighbor : neighbors) {
+            if (neighbor[0] < 0 || neighbor[0] >= columns || neighbor[1] < 0 || neighbor[1] >= rows) {
+                continue;
+            }
+
+            int const nextNode = nodeAt(neighbor[0], neighbor[1]);
+            int const nextState = nextNode * 2 + neighbor[2];
+            QPointF const p = position(node);
+            QPointF const q = position(nextNode);
+            qreal const nextCost = currentCost + qAbs(q.x() - p.x()) + qAbs(q.y() - p.y()) +
+                                   (neighbor[2] != axis ? BEND_PENALTY : 0);
+
+            if (nextCost >= cost[nextState] || !isFree(q) || !isFree(p, q)) {
+                continue;
+            }
+
+            cost[nextState] = nextCost;
+            previous[nextState] = state;
+            open.push(QueueEntry(nextCost + heuristic(nextNode), nextState));
+        }
+    }
+
+    if (bestState < 0) {
+        return false;
+    }
+
+    path.clear();
+
+    for (int state = bestState; state >= 0; state = previous[state]) {
+        path.prepend(position(state / 2));
+    }
+
+    return true;
+}
+
+bool ItemRouter::route(QPointF const& start, QPointF const& end, QList<qreal>& coords) const
+{
+    // The stubs are part of every route, the search runs between their ends
+    QPointF const from = start + QPointF(_stub, 0);
+    QPointF const to = end - QPointF(_stub, 0);
+
+    if (!isFree(from) || !isFree(to)) {
+        return false;
+    }
+
+    QVector<QPointF> path;
+    QRectF const window = QRectF(from, to).normalized().adjusted(-SEARCH_MARGIN, -SEARCH_MARGIN, SEARCH_MARGIN, SEARCH_MARGIN);
+
+    if (!search(from, to, window, path)) {
+        if (_xLines.isEmpty() || _yLines.isEmpty()) {
+            return false;
+        }
+
+        // Retry on the whole graph, maybe the route has to go around a large group of items
+        QRectF const all = QRectF(QPointF(_xLines.firstKey(), _yLines.firstKey()), QPointF(_xLines.lastKey(), _yLines.lastKey()));
+
+        if (!search(from, to, all | window, path)) {
+            return false;
+        }
+    }
+
+    path.prepend(start);
+    path.append(end);
+
+    // Drop points in the middle of straight lines, so the segments alternate between horizontal and vertical
+    for (int i = path.size() - 2; i > 0; i--) {
+        QPointF const& a = path.at(i - 1);
+        QPointF const& b = path.at(i);
+        QPointF const& c = path.at(i + 1);
+
+        if ((a.x() == b.x() && b.x() == c.x()) || (a.y() == b.y() && b.y() == c.y())) {
+            path.remove(i);
+        }
+    }
+
+    // Every corner contributes the coordinate of the segment that leads to it
+    coords.clear();
+
+    for (int i = 1; i < path.size() - 1; i++) {
+        bool const horizontal = (path.at(i - 1).y() == path.at(i).y());
+        coords.append(horizontal ? path.at(i).x() : path.at(i).y());
+    }
+
+    return true;
+}
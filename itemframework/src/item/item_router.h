@@ -0,0 +1,99 @@
+#ifndef ITEM_ROUTER_H
+#define ITEM_ROUTER_H
+
+#include "appcore.h"
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+class QGraphicsItem;
+
+/**
+ * @brief The ItemRouter class calculates orthogonal connector routes which avoid all item boxes of a scene.
+ *
+ * The router keeps the obstacles incrementally: the x and y coordinates of all (inflated) item boxes are reference
+ * counted grid lines and the boxes are kept in a uniform grid, so moving an item only updates the entries of this item.
+ * The visibility graph itself is not kept. Every route query builds the nodes at the intersections of the grid lines
+ * around the two end points (at most MAX_SEARCH_NODES) and searches them with A*, bends are penalized.
+ * The bounds of the routes are kept in a second grid of the same cells, so the routes crossing a moved box
+ * are found without a query of the scene.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemRouter
+{
+public:
+    /**
+     * @brief Constructs an empty router
+     * @param clearance The distance a route keeps from the item boxes
+     * @param stub The length of the horizontal segments leaving the output and entering the input
+     */
+    explicit ItemRouter(qreal clearance = 10, qreal stub = 25);
+
+    /**
+     * @brief Adds \a item as obstacle or updates its box if it is already known
+     * @param box The box of the item in scene coordinates
+     */
+    void updateObstacle(QGraphicsItem const* item, QRectF const& box);
+
+    /**
+     * @brief Removes the obstacle of \a item. Does nothing if it is not known.
+     */
+    void removeObstacle(QGraphicsItem const* item);
+
+    /**
+     * @brief Adds the route of \a connector or updates its bounds if it is already known
+     * @param bounds The bounding rect of the route in scene coordinates
+     */
+    void updateRoute(QGraphicsItem const* connector, QRectF const& bounds);
+
+    /**
+     * @brief Removes the route of \a connector. Does nothing if it is not known.
+     */
+    void removeRoute(QGraphicsItem const* connector);
+
+    /**
+     * @brief Returns the connectors whose route bounds intersect \a box
+     */
+    QList<QGraphicsItem const*> routesIntersecting(QRectF const& box) const;
+
+    /**
+     * @brief Searches a route from an output at \a start to an input at \a end.
+     * The route leaves the start and enters the end horizontally.
+     * @param start The scene position of the output
+     * @param end The scene position of the input
+     * @param coords Receives the route in the format of Item_Connector: alternating x (horizontal segment)
+     * and y (vertical segment) coordinates, starting with a horizontal segment.
+     * @return true if a route was found
+     */
+    bool route(QPointF const& start, QPointF const& end, QList<qreal>& coords) const;
+
+private:
+    using Cell = QPair<int, int>;
+    using Cells = QHash<Cell, QVector<QGraphicsItem const*>>;
+
+    void addLines(QRectF const& box);
+    void removeLines(QRectF const& box);
+    void addToCells(Cells& cells, QGraphicsItem const* item, QRectF const& box);
+    void removeFromCells(Cells& cells, QGraphicsItem const* item, QRectF const& box);
+    QVector<Cell> cellsOf(QRectF const& rect) const;
+
+    bool isFree(QPointF const& point) const;
+    bool isFree(QPointF const& from, QPointF const& to) const;
+    bool search(QPointF const& from, QPointF const& to, QRectF const& window, QVector<QPointF>& path) const;
+
+    qreal _clearance;
+    qreal _stub;
+    qreal _cellSize;
+
+    QHash<QGraphicsItem const*, QRectF> _obstacles; // inflated boxes
+    Cells _cells;
+    QMap<qreal, int> _xLines; // coordinate -> reference count
+    QMap<qreal, int> _yLines;
+    QHash<QGraphicsItem const*, QRectF> _routes; // route bounds
+    Cells _routeCells;
+};
+
+#endif // ITEM_ROUTER_H
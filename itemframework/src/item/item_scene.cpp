@@ -14,10 +14,13 @@
 #include "helper/settings_scope.h"
 #include "helper/progress_reporter.h"
 #include "item/item_serializer.h"
+#include "item/item_batch.h"
+#include "item_mime_data.h"
 
 #include <QGraphicsSceneMouseEvent>
 #include <QKeyEvent>
 #include <QGraphicsRectItem>
+#include <QPainterPath>
 #include <QMimeData>
 #include <QDebug>
 #include <QMenu>
@@ -32,9 +35,15 @@
 #include <QStyleOptionGraphicsItem>
 #include <qmath.h>
 #include <functional>
+#include <algorithm>
 
 #define RASTER 50.0 // [px]
 #define AUTOCONNECT_DISTANCE  30 // [px]
+#define ROUTE_CLEARANCE 10 // [px] distance between routed connectors and items
+#define ROUTE_STUB 25 // [px] length of the straight connector segments at the inputs and outputs
+#define JOURNAL_MEMORY_LIMIT (8 * 1024 * 1024) // [byte] estimated size of all undo entries
+
+static const char* const VirtualSceneThresholdKey = "VirtualSceneThreshold";
 
 static const char* const DragDropMimeType = "application/x-itemframework-item";
 static const char* const CopyPasteMimeType = "application/x-itemframework-items";
@@ -47,79 +56,477 @@ inline QList<T const*> const& constList(QList<T*> const& list)
     return reinterpret_cast<QList<T const*> const&>(list);
 }
 
-ItemScene::ItemScene(QSharedPointer<ProjectGui> projectGui, QObject* parent) : QGraphicsScene(parent)
+ItemScene::ItemScene(QSharedPointer<ProjectGui> projectGui, QObject* parent)
+    : QGraphicsScene(parent), _portIndex(2 * AUTOCONNECT_DISTANCE),
+      _router(ROUTE_CLEARANCE, ROUTE_STUB), _journal(this, JOURNAL_MEMORY_LIMIT)
 {
     _projectGui = projectGui;
+
+    _connectorUpdateTimer.setSingleShot(true);
+    _connectorUpdateTimer.setInterval(0);
+    connect(&_connectorUpdateTimer, &QTimer::timeout, this, &ItemScene::flushPendingUpdates);
 }
 
 ItemScene::~ItemScene()
 {
+    // Delete the items while this is still an ItemScene, so that the inputs and outputs can leave the port index
+    clearContent();
 }
 
-void ItemScene::updateConnectionLine()
+ItemPortIndex& ItemScene::portIndex()
 {
-    // endPoint changed due to mouse movement. Realign the connection line, possibly
-    // connecting the end of the connection line to a nearby input or output
+    return _portIndex;
+}
 
-    QPointF mousePosition = _endPoint;
+ItemRouter const& ItemScene::router() const
+{
+    return _router;
+}
 
-    //Find all items which boundingrect intersects with a HitTestBox around the mouseposition
-    //Note that the background is also in the collection!
-    QList<QGraphicsItem*> nearbyItems = items(QRectF(mousePosition - QPointF(AUTOCONNECT_DISTANCE, AUTOCONNECT_DISTANCE), QSizeF(2 * AUTOCONNECT_DISTANCE, 2 * AUTOCONNECT_DISTANCE)), Qt::IntersectsItemBoundingRect, Qt::DescendingOrder);
+ItemJournal& ItemScene::journal()
+{
+    return _journal;
+}
 
-    qreal smallestDistance = AUTOCONNECT_DISTANCE;
-    bool found = false;
+void ItemScene::undo()
+{
+    flushPendingUpdates(); // the journal has to see the current routes
+    _journal.undo();
+    updateBoundingRect();
+    emit sceneRealChanged();
+}
 
-    for (auto i : nearbyItems) {
-        if (i->type() == QGraphicsLineItem::Type) {
-            continue;
-        }
+void ItemScene::redo()
+{
+    flushPendingUpdates();
+    _journal.redo();
+    updateBoundingRect();
+    emit sceneRealChanged();
+}
+
+bool ItemScene::canUndo() const
+{
+    return _journal.canUndo();
+}
+
+bool ItemScene::canRedo() const
+{
+    return _journal.canRedo();
+}
 
-        // TODO: DRY!
+void ItemScene::scheduleConnectorUpdate(Item_Connector* connector)
+{
+    _dirtyConnectors.insert(connector);
 
-        if (! _reversed) { // connection starts with an input, we need an output
-            auto output = qobject_cast<ItemOutput*>(i->toGraphicsObject());
+    if (!_connectorUpdateTimer.isActive()) {
+        _connectorUpdateTimer.start();
+    }
+}
 
-            if (output != nullptr) {
-                if (output->transportType() != _type) {
-                    continue;
-                }
+void ItemScene::cancelConnectorUpdate(Item_Connector* connector)
+{
+    _dirtyConnectors.remove(connector);
+}
+
+bool ItemScene::deferItemMove(AbstractItem* item)
+{
+    if (!_inMoveTransaction) {
+        return false;
+    }
 
-                qreal d = distance(mousePosition, output->scenePosition());
+    _movedItems.insert(item);
 
-                if (d < smallestDistance) {
-                    smallestDistance = d;
-                    _endPoint = output->scenePosition();
-                    _output = output;
-                    found = true;
-                }
+    if (!_connectorUpdateTimer.isActive()) {
+        _connectorUpdateTimer.start();
+    }
+
+    return true;
+}
+
+void ItemScene::flushMovedItems()
+{
+    if (_movedItems.isEmpty()) {
+        return;
+    }
+
+    QSet<AbstractItem*> movedItems;
+    movedItems.swap(_movedItems);
+
+    // The ports schedule their connectors, which are routed by the following connector flush
+    for (AbstractItem* item : movedItems) {
+        updateItemBounds(item);
+        item->updatePortPositions();
+    }
+
+    emit sceneRealChanged();
+}
+
+void ItemScene::flushPendingUpdates()
+{
+    flushMovedItems();
+    rerouteCrossedConnectors();
+    flushConnectorUpdates();
+}
+
+void ItemScene::flushConnectorUpdates()
+{
+    // Take the set first, flushing may schedule further updates
+    QSet<Item_Connector*> dirtyConnectors;
+    dirtyConnectors.swap(_dirtyConnectors);
+
+    for (Item_Connector* connector : dirtyConnectors) {
+        connector->flush_update();
+    }
+}
+
+// Returns whether one of the edges of bounds was defined by oldRect, but is not reached by newRect anymore
+static bool shrinksBounds(QRectF const& bounds, QRectF const& oldRect, QRectF const& newRect)
+{
+    return (oldRect.left() <= bounds.left() && (newRect.isNull() || newRect.left() > bounds.left())) ||
+           (oldRect.top() <= bounds.top() && (newRect.isNull() || newRect.top() > bounds.top())) ||
+           (oldRect.right() >= bounds.right() && (newRect.isNull() || newRect.right() < bounds.right())) ||
+           (oldRect.bottom() >= bounds.bottom() && (newRect.isNull() || newRect.bottom() < bounds.bottom()));
+}
+
+void ItemScene::trackItemChange(QGraphicsItem* item, QGraphicsItem::GraphicsItemChange change)
+{
+    switch (change) {
+    case QGraphicsItem::ItemSceneChange: { // item leaves its current scene
+        ItemScene* itemScene = qobject_cast<ItemScene*>(item->scene());
+
+        if (itemScene != nullptr && itemScene->_itemBounds.contains(item)) {
+            QRectF const oldRect = itemScene->_itemBounds.take(item);
+
+            if (itemScene->_contentBoundsValid && shrinksBounds(itemScene->_contentBounds, oldRect, QRectF())) {
+                itemScene->_contentBoundsValid = false;
             }
-        } else { // connection starts with an output, we need an input
-            auto input = qobject_cast<ItemInput*>(i->toGraphicsObject());
-
-            if (input != nullptr) {
-                if (input->transportType() != _type || input->isConnected()) {
-                    continue;
-                }
-
-                qreal d = distance(mousePosition, input->scenePosition());
-
-                if (d < smallestDistance) {
-                    smallestDistance = d;
-                    _endPoint = input->scenePosition();
-                    _input = input;
-                    found = true;
-                }
+        }
+
+        if (itemScene != nullptr) {
+            itemScene->_router.removeObstacle(item);
+            itemScene->_router.removeRoute(item);
+            itemScene->_movedItems.remove(qobject_cast<AbstractItem*>(item->toGraphicsObject()));
+            itemScene->_crossingItems.remove(qobject_cast<AbstractItem*>(item->toGraphicsObject()));
+            itemScene->_journal.forget(item);
+            itemScene->trackContent(item, false);
+        }
+
+        break;
+    }
+
+    case QGraphicsItem::ItemSceneHasChanged: {
+        ItemScene* itemScene = qobject_cast<ItemScene*>(item->scene());
+        AbstractItem* abstractItem = qobject_cast<AbstractItem*>(item->toGraphicsObject());
+
+        if (itemScene != nullptr && abstractItem != nullptr) {
+            itemScene->_journal.watch(abstractItem); // record its setting changes
+        }
+
+        if (itemScene != nullptr) {
+            itemScene->trackContent(item, true);
+        }
+
+        updateItemBounds(item);
+        break;
+    }
+
+    case QGraphicsItem::ItemScenePositionHasChanged: {
+        ItemScene* itemScene = qobject_cast<ItemScene*>(item->scene());
+        AbstractItem* abstractItem = qobject_cast<AbstractItem*>(item->toGraphicsObject());
+
+        if (itemScene != nullptr) {
+            itemScene->markContentChanged(item);
+        }
+
+        if (itemScene != nullptr && abstractItem != nullptr && itemScene->deferItemMove(abstractItem)) {
+            break; // the bounds and the obstacle are updated by flushMovedItems()
+        }
+
+        updateItemBounds(item);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void ItemScene::updateItemBounds(QGraphicsItem* item)
+{
+    ItemScene* itemScene = qobject_cast<ItemScene*>(item->scene());
+
+    if (itemScene == nullptr) {
+        return;
+    }
+
+    // Same area as itemsBoundingRect() would use for this item
+    QRectF const newRect = item->sceneBoundingRect() | item->mapRectToScene(item->childrenBoundingRect());
+    auto it = itemScene->_itemBounds.find(item);
+
+    if (it == itemScene->_itemBounds.end()) {
+        itemScene->_itemBounds.insert(item, newRect);
+    } else {
+        if (itemScene->_contentBoundsValid && shrinksBounds(itemScene->_contentBounds, *it, newRect)) {
+            itemScene->_contentBoundsValid = false;
+        }
+
+        *it = newRect;
+    }
+
+    if (itemScene->_contentBoundsValid) {
+        itemScene->_contentBounds |= newRect;
+    }
+
+    // Connectors are routed around the items themselves, not around notes or other connectors
+    QGraphicsObject* object = item->toGraphicsObject();
+    AbstractItem* abstractItem = qobject_cast<AbstractItem*>(object);
+
+    if (abstractItem != nullptr) {
+        itemScene->_router.updateObstacle(item, item->sceneBoundingRect());
+        itemScene->_crossingItems.insert(abstractItem);
+
+        if (!itemScene->_connectorUpdateTimer.isActive()) {
+            itemScene->_connectorUpdateTimer.start();
+        }
+    } else if (qobject_cast<Item_Connector*>(object) != nullptr) {
+        itemScene->_router.updateRoute(item, item->sceneBoundingRect());
+    }
+}
+
+void ItemScene::rerouteCrossedConnectors()
+{
+    if (_crossingItems.isEmpty()) {
+        return;
+    }
+
+    QSet<AbstractItem*> crossingItems;
+    crossingItems.swap(_crossingItems);
+
+    for (AbstractItem* item : crossingItems) {
+        QRectF const box = item->sceneBoundingRect();
+        QPainterPath boxPath;
+        boxPath.addRect(box);
+
+        // The router only knows the bounds of the routes, the shape decides whether the route really crosses the box.
+        // The connectors of the item itself are scheduled by its ports.
+        for (QGraphicsItem const* route : _router.routesIntersecting(box)) {
+            QGraphicsObject* object = const_cast<QGraphicsItem*>(route)->toGraphicsObject();
+            Item_Connector* connector = qobject_cast<Item_Connector*>(object);
+
+            if (connector != nullptr && connector->get_output()->owner() != item &&
+                connector->get_input()->owner() != item && connector->collidesWithPath(connector->mapFromScene(boxPath))) {
+                connector->schedule_reroute();
             }
         }
     }
+}
 
-    // TODO: redundant?
-    if (! found) {
-        if (_reversed) {
-            _input = nullptr;
-        } else {
-            _output = nullptr;
+void ItemScene::trackContent(QGraphicsItem* item, bool inScene)
+{
+    QGraphicsObject* object = item->toGraphicsObject();
+
+    if (object == nullptr) {
+        return;
+    }
+
+    Item_Connector* connector = qobject_cast<Item_Connector*>(object);
+
+    if (!inScene) {
+        if (_contentKeys.contains(item)) {
+            QString const key = _contentKeys.take(item);
+            _contentItems.remove(key, item);
+            _changedKeys.insert(key); // other items may share the leaf
+        }
+
+        _changedContent.remove(item);
+        disconnect(object, SIGNAL(changed()), this, SLOT(onItemContentChanged()));
+
+        if (connector != nullptr) {
+            _itemConnectors.remove(connector->get_output()->owner(), connector);
+            _itemConnectors.remove(connector->get_input()->owner(), connector);
+        }
+
+        return;
+    }
+
+    // Data and setting changes of the items are only reported by their changed() signal
+    connect(object, SIGNAL(changed()), this, SLOT(onItemContentChanged()));
+
+    if (connector != nullptr) {
+        _itemConnectors.insert(connector->get_output()->owner(), connector);
+
+        if (connector->get_input()->owner() != connector->get_output()->owner()) {
+            _itemConnectors.insert(connector->get_input()->owner(), connector);
+        }
+    }
+
+    if (_loadingItems) {
+        QString const key = contentKey(item);
+        _contentKeys.insert(item, key);
+        _contentItems.insert(key, item);
+    } else {
+        markContentChanged(item);
+    }
+}
+
+void ItemScene::onItemContentChanged()
+{
+    QGraphicsObject* object = qobject_cast<QGraphicsObject*>(sender());
+
+    if (object != nullptr && object->scene() == this) {
+        markContentChanged(object);
+    }
+}
+
+void ItemScene::markContentChanged(QGraphicsItem* item)
+{
+    _changedContent.insert(item);
+
+    // The keys of the connectors contain the name of the item
+    AbstractItem* abstractItem = qobject_cast<AbstractItem*>(item->toGraphicsObject());
+
+    if (abstractItem != nullptr) {
+        for (Item_Connector* connector : _itemConnectors.values(abstractItem)) {
+            _changedContent.insert(connector);
+        }
+    }
+}
+
+ProjectHash const& ItemScene::contentHash()
+{
+    flushPendingUpdates(); // hash the current routes
+
+    // The key of a changed item may have changed as well (e.g. renamed), so the old and the new leaf are outdated
+    for (QGraphicsItem* item : _changedContent) {
+        if (_contentKeys.contains(item)) {
+            QString const oldKey = _contentKeys.take(item);
+            _contentItems.remove(oldKey, item);
+            _changedKeys.insert(oldKey);
+        }
+
+        QString const key = contentKey(item);
+        _contentKeys.insert(item, key);
+        _contentItems.insert(key, item);
+        _changedKeys.insert(key);
+    }
+
+    _changedContent.clear();
+
+    for (QString const& key : _changedKeys) {
+        updateContentHash(key);
+    }
+
+    _changedKeys.clear();
+
+    return _contentHash;
+}
+
+void ItemScene::updateContentHash(QString const& key)
+{
+    // Same grouping as ProjectHash::insertChildren(), so the hash equals the one of the saved project.
+    // Only the created items are grouped: a virtual item which shares the key is left out until it is created.
+    QList<QByteArray> leaves;
+
+    for (QGraphicsItem* item : _contentItems.values(key)) {
+        leaves.append(contentLeaf(item));
+    }
+
+    if (leaves.isEmpty()) {
+        _contentHash.remove(key);
+    } else {
+        _contentHash.insert(key, ProjectHash::groupLeaf(leaves));
+    }
+}
+
+QByteArray ItemScene::contentLeaf(QGraphicsItem* item) const
+{
+    // A connector is saved together with its items, which define its key
+    QList<QGraphicsItem const*> items;
+    Item_Connector* connector = qobject_cast<Item_Connector*>(item->toGraphicsObject());
+
+    if (connector != nullptr) {
+        items.append(connector->get_output()->owner());
+
+        if (connector->get_input()->owner() != connector->get_output()->owner()) {
+            items.append(connector->get_input()->owner());
+        }
+    }
+
+    items.append(item);
+
+    QDomDocument document;
+    QDomElement parent = document.createElement(CopyPasteRootTag);
+    ItemSerializer::saveToXml(document, parent, items);
+
+    return ProjectHash::leaf(parent.lastChildElement(), ProjectHash::itemNames(parent)).second;
+}
+
+QString ItemScene::contentKey(QGraphicsItem* item) const
+{
+    QGraphicsObject* object = item->toGraphicsObject();
+    AbstractItem* abstractItem = qobject_cast<AbstractItem*>(object);
+
+    if (abstractItem != nullptr) {
+        return ProjectHash::itemKey(abstractItem->name());
+    }
+
+    Item_Connector* connector = qobject_cast<Item_Connector*>(object);
+
+    if (connector != nullptr) {
+        ItemOutput* output = connector->get_output();
+        ItemInput* input = connector->get_input();
+
+        return ProjectHash::connectorKey(output->owner()->name(), output->owner()->outputs().indexOf(output),
+                                         input->owner()->name(), input->owner()->inputs().indexOf(input));
+    }
+
+    return ProjectHash::noteKey(item->pos());
+}
+
+QRectF ItemScene::contentBounds()
+{
+    // The bounds of the items dragged since the last frame are not updated yet
+    for (AbstractItem* item : _movedItems) {
+        updateItemBounds(item);
+    }
+
+    if (!_contentBoundsValid) {
+        _contentBounds = QRectF();
+
+        for (QRectF const& rect : _itemBounds) {
+            _contentBounds |= rect;
+        }
+
+        _contentBounds |= _virtualItems.bounds();
+
+        _contentBoundsValid = true;
+    }
+
+    return _contentBounds;
+}
+
+void ItemScene::updateConnectionLine()
+{
+    // endPoint changed due to mouse movement. Realign the connection line, possibly
+    // connecting the end of the connection line to a nearby input or output
+
+    QPointF mousePosition = _endPoint;
+
+    //Look up the closest compatible port in the port index. Other graphics items are not touched.
+    if (! _reversed) { // connection starts with an input, we need an output
+        _output = static_cast<ItemOutput*>(_portIndex.nearest(mousePosition, AUTOCONNECT_DISTANCE, ItemPortIndex::Output, _type));
+
+        if (_output != nullptr) {
+            _endPoint = _output->scenePosition();
+        }
+    } else { // connection starts with an output, we need an input
+        auto unconnected = [](AbstractItemInputOutputBase * port) {
+            return !port->isConnected();
+        };
+        _input = static_cast<ItemInput*>(_portIndex.nearest(mousePosition, AUTOCONNECT_DISTANCE, ItemPortIndex::Input, _type, unconnected));
+
+        if (_input != nullptr) {
+            _endPoint = _input->scenePosition();
         }
     }
 
@@ -141,12 +548,10 @@ QList<QGraphicsItem*> ItemScene::readItems(QDomDocument const& document, bool sh
 
 QList<QGraphicsItem*> ItemScene::readItems(QMimeData const& mimeData, char const* const mimeType, char const* const docType)
 {
-    QByteArray bar = mimeData.data(mimeType);
-    QDomDocument doc;
     QString parserError;
+    QDomDocument doc = ItemMimeData::document(mimeData, mimeType, &parserError);
 
-
-    if (!doc.setContent(bar, &parserError)) {
+    if (doc.isNull()) {
         qDebug() << "Error while trying to load items:" << parserError;
         return {};
     }
@@ -163,8 +568,6 @@ void ItemScene::insertItems(QList<QGraphicsItem*> items, QPointF const& scenePos
 {
     //Add items to scene, and move them to the cursor
     for (QGraphicsItem* itm : items) { //foreach item, connector and note
-        addItem(itm);
-
         if (qobject_cast<Item_Connector*>(itm->toGraphicsObject()) == nullptr) {
             //only for notes and items, but not connectors (as they will auto-update their position)
             auto const itemPositionAtCursor = itm->pos() - boundingBox.center() + scenePos; //move to cursor
@@ -189,8 +592,11 @@ void ItemScene::insertItems(QList<QGraphicsItem*> items, QPointF const& scenePos
 
             aitm->setName(name); //set name of the new item with current copy count
         }
+
+        addItem(itm); //after renaming, so the journal only records the insertion
     }
 
+    _journal.recordAdded(items);
     updateBoundingRect(); //realgin items/scene by recalulating the bounding box
     emit sceneRealChanged();
 }
@@ -234,6 +640,8 @@ void ItemScene::paste()
         return;
     }
 
+    // The connectors are routed once, after the items were moved to the cursor
+    ItemBatch batch;
     QList<QGraphicsItem*> copiedItems = readItems(*mimeData, CopyPasteMimeType, CopyPasteDocType);
 
     //Calculate the boundingBox for the selected items
@@ -324,27 +732,27 @@ void ItemScene::cut()
     deleteItems(selItems);
 }
 
-void ItemScene::copy() const
+void ItemScene::copy()
 {
     copy(copyableItems());
 }
 
-void ItemScene::copy(QList<QGraphicsItem*> itms) const
+void ItemScene::copy(QList<QGraphicsItem*> itms)
 {
     if (itms.isEmpty()) {
         return;
     }
 
+    flushPendingUpdates(); // copy the current routes, also of items which are still dragged
+
     //Create an xml document and save the selected items to it (using their save method)
     QDomDocument doc(CopyPasteDocType);
     QDomElement root = doc.createElement(CopyPasteRootTag);
     ItemSerializer::saveToXml(doc, root, constList(itms));
     doc.appendChild(root);
 
-    //Create mime data and push it to clipboard
-    QMimeData* md = new QMimeData();
-    md->setData(CopyPasteMimeType, doc.toByteArray());
-    QApplication::clipboard()->setMimeData(md);
+    //Push the document to the clipboard, the xml and binary representations are only created on request
+    QApplication::clipboard()->setMimeData(new ItemMimeData(doc, CopyPasteMimeType));
 }
 
 QPixmap ItemScene::createPixmap(QDomDocument const& itemsDocument)
@@ -441,6 +849,8 @@ bool ItemScene::notesInInsertMode()
 
 void ItemScene::deleteItems(QList<QGraphicsItem*> items)
 {
+    _journal.recordRemoval(items);
+
     //remove the connectors first!!
     for (int i = items.count() - 1; i >= 0; i--) {
         Item_Connector* con = qobject_cast<Item_Connector*>(items.at(i)->toGraphicsObject());
@@ -484,6 +894,11 @@ void ItemScene::keyPressEvent(QKeyEvent* event)
         paste();
     } else if (event->key() == Qt::Key_X && event->modifiers() == Qt::ControlModifier) {
         cut();
+    } else if (event->key() == Qt::Key_Z && event->modifiers() == Qt::ControlModifier) {
+        undo();
+    } else if ((event->key() == Qt::Key_Y && event->modifiers() == Qt::ControlModifier) ||
+               (event->key() == Qt::Key_Z && event->modifiers() == (Qt::ControlModifier | Qt::ShiftModifier))) {
+        redo();
     }
 
     QGraphicsScene::keyPressEvent(event);
@@ -502,6 +917,11 @@ void ItemScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
     QAction* actionNote  = menu.addAction(tr("Add Note"));
     QAction* actionPaste  = menu.addAction(tr("Paste Items"));
     actionPaste->setEnabled(QApplication::clipboard()->mimeData()->hasFormat(CopyPasteMimeType));
+    menu.addSeparator();
+    QAction* actionUndo = menu.addAction(tr("Undo"));
+    actionUndo->setEnabled(canUndo());
+    QAction* actionRedo = menu.addAction(tr("Redo"));
+    actionRedo->setEnabled(canRedo());
 
     QAction* actionSel = menu.exec(event->screenPos());
 
@@ -515,9 +935,14 @@ void ItemScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
         note->setPos(posItemNew);
         connect(note, SIGNAL(changed()), this, SIGNAL(sceneRealChanged()));
         addItem(note);
+        _journal.recordAdded({note});
         emit sceneRealChanged();
     } else if (actionSel == actionPaste) {
         paste();
+    } else if (actionSel == actionUndo) {
+        undo();
+    } else if (actionSel == actionRedo) {
+        redo();
     }
 }
 
@@ -543,53 +968,48 @@ bool ItemScene::startMove(QGraphicsSceneMouseEvent* event)
         break;
     }
 
+    // Dragging several items moves each of them, their changes are collected per frame
+    _inMoveTransaction = _inMovingMode && items.count() > 1;
+
     return _inMovingMode;
 }
 
 bool ItemScene::startConnection(QGraphicsSceneMouseEvent* mouseEvent)
 {
-    qreal smallestDistance = AUTOCONNECT_DISTANCE;
-    QRectF maskRect(mouseEvent->scenePos() - QPointF(AUTOCONNECT_DISTANCE, AUTOCONNECT_DISTANCE),
-                    QSizeF(2 * AUTOCONNECT_DISTANCE, 2 * AUTOCONNECT_DISTANCE));
-    auto nearbyItems = items(maskRect, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder);
+    QPointF mousePosition = mouseEvent->scenePos();
 
-    // Check if one of the target is an input or output.
-    // If so, set it as the start of the connection we're building
-    for (auto item : nearbyItems) {
-        auto input = qobject_cast<ItemInput*>(item->toGraphicsObject());
-        auto output = qobject_cast<ItemOutput*>(item->toGraphicsObject());
-
-        if (input != nullptr) {
-            if (input->isConnected()) { // An input can only be connected to one output
-                continue;
-            }
-
-            qreal d = distance(mouseEvent->scenePos(), input->scenePosition());
+    // Check if there is an input or output nearby.
+    // If so, set the closest one as the start of the connection we're building
+    auto unconnected = [](AbstractItemInputOutputBase * port) {
+        return !port->isConnected(); // An input can only be connected to one output
+    };
+    auto input = static_cast<ItemInput*>(_portIndex.nearest(mousePosition, AUTOCONNECT_DISTANCE, ItemPortIndex::Input, unconnected));
+    auto output = static_cast<ItemOutput*>(_portIndex.nearest(mousePosition, AUTOCONNECT_DISTANCE, ItemPortIndex::Output));
 
-            if (d < smallestDistance) {
-                smallestDistance = d;
-                _inConnectionMode = true;
-                _reversed = false;
-                _input = input;
-                _output = nullptr;
-                _type = input->transportType();
-                _startPoint = input->scenePosition();
-            }
-        } else if (output != nullptr) {
-            qreal d = distance(mouseEvent->scenePos(), output->scenePosition());
-
-            if (d < smallestDistance) {
-                smallestDistance = d;
-                _inConnectionMode = true;
-                _reversed = true;
-                _output = output;
-                _input = nullptr;
-                _type = output->transportType();
-                _startPoint = output->scenePosition();
-            }
+    if (input != nullptr && output != nullptr) { // keep only the closer one
+        if (distance(mousePosition, output->scenePosition()) < distance(mousePosition, input->scenePosition())) {
+            input = nullptr;
+        } else {
+            output = nullptr;
         }
     }
 
+    if (input != nullptr) {
+        _inConnectionMode = true;
+        _reversed = false;
+        _input = input;
+        _output = nullptr;
+        _type = input->transportType();
+        _startPoint = input->scenePosition();
+    } else if (output != nullptr) {
+        _inConnectionMode = true;
+        _reversed = true;
+        _output = output;
+        _input = nullptr;
+        _type = output->transportType();
+        _startPoint = output->scenePosition();
+    }
+
     return _inConnectionMode;
 }
 
@@ -604,6 +1024,7 @@ void ItemScene::mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent)
     // Left mouse down starts to move an item
     if (itemAt(mouseEvent->scenePos(), QTransform())) { //there is an item underneath
         QGraphicsScene::mousePressEvent(mouseEvent); //redirect the event call to update selected items etc
+        _journal.beginMove(selectedItems()); // a drag is recorded as one move
 
         if (startMove(mouseEvent)) {
             return;
@@ -656,6 +1077,7 @@ void ItemScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* mouseEvent)
                 addItem(connector);
                 connect(connector, SIGNAL(changed()), this, SIGNAL(sceneRealChanged()));
                 _input->connectOutput(_output); //data connection
+                _journal.recordAdded({connector});
                 emit sceneRealChanged();
             }
         }
@@ -663,6 +1085,13 @@ void ItemScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* mouseEvent)
         QGraphicsScene::mouseReleaseEvent(mouseEvent);
         _inMovingMode = false;
 
+        if (_inMoveTransaction) {
+            _inMoveTransaction = false;
+            flushPendingUpdates(); // the final positions
+        }
+
+        _journal.endMove();
+
         if (mouseEvent->button() == Qt::LeftButton) {
             updateBoundingRect(); //Recalc the scene bounding
         }
@@ -672,7 +1101,7 @@ void ItemScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* mouseEvent)
 
 void ItemScene::updateBoundingRect()
 {
-    QRectF rec_current_size = itemsBoundingRect(); //bounding of all items (expensiv call!)
+    QRectF rec_current_size = contentBounds(); //bounding of all items (maintained incrementally)
     qreal x = rec_current_size.x();
     qreal y = rec_current_size.y();
     qreal w = rec_current_size.width();
@@ -772,6 +1201,7 @@ void ItemScene::insertItem(QString const& name, QPointF const& position)
         QPointF posItemNew = QPointF(RASTER * round(position.x() / RASTER), RASTER * round(position.y() / RASTER)); // raster again
         newItem->setPos(posItemNew);
         connect(newItem, SIGNAL(changed()), this, SIGNAL(sceneRealChanged()));
+        _journal.recordAdded({newItem});
         emit sceneRealChanged();
     } else {
         qDebug() << QString("Couldn't create an instance of %1 (Item_Scene)").arg(name);
@@ -791,8 +1221,6 @@ QSharedPointer<ProjectGui> ItemScene::projectGui() const
 
 bool ItemScene::loadFromXml(QDomElement& dom)
 {
-    QList<QGraphicsItem*> newItems;
-
     auto setupProgressReporter = [this]() {
         using std::placeholders::_1;
         using std::placeholders::_2;
@@ -803,33 +1231,106 @@ bool ItemScene::loadFromXml(QDomElement& dom)
     };
 
     auto reporter = setupProgressReporter();
-    if (!ItemSerializer::loadFromXml(dom, &newItems, reporter)) {
-        return false;
+
+    int const threshold = SettingsScope::globalScope()->value(VirtualSceneThresholdKey, 0).toInt();
+    int itemCount = 0;
+
+    for (QDomElement element = dom.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (ItemSerializer::isItemElement(element)) {
+            itemCount++;
+        }
     }
 
-    auto processItem = [this](QGraphicsItem* graphicsItem) {
-        auto shouldConnect = [](QGraphicsObject* graphicsObject) {
-            return
-                    qobject_cast<AbstractItem*>  (graphicsObject) != nullptr
-                 || qobject_cast<ItemNote*>      (graphicsObject) != nullptr
-                 || qobject_cast<Item_Connector*>(graphicsObject) != nullptr;
-        };
+    _journal.clear(); // the loaded items are no edits
 
-        auto graphicsObject = graphicsItem->toGraphicsObject();
+    // The loaded xml already is the content, including the items which stay virtual
+    _contentHash = ProjectHash();
+    _contentHash.insertChildren(dom, ProjectHash::isItemContent);
 
-        if (shouldConnect(graphicsObject)) {
-            connect(graphicsObject, SIGNAL(changed()), this, SIGNAL(sceneRealChanged()));
-        }
+    if (threshold <= 0 || itemCount <= threshold) {
+        return addItemsFromXml(dom, reporter);
+    }
 
-        addItem(graphicsItem);
-    };
+    // Only keep records of the items, the views create the visible ones
+    QDomDocument remainingDocument;
+    QDomElement const remaining = _virtualItems.load(dom, remainingDocument);
+    _contentBoundsValid = false;
+    bool const success = addItemsFromXml(remaining, reporter);
 
-    std::for_each(newItems.begin(), newItems.end(), processItem);
+    for (QGraphicsView* view : views()) {
+        materialize(view->mapToScene(view->viewport()->rect()).boundingRect());
+    }
+
+    return success;
+}
+
+void ItemScene::materialize(QRectF const& rect)
+{
+    if (_virtualItems.isEmpty()) {
+        return;
+    }
+
+    QDomDocument document;
+    QDomElement const items = _virtualItems.take(rect, document);
+
+    if (items.hasChildNodes()) {
+        addItemsFromXml(items, ProgressReporter{nullptr, false});
+    }
+}
+
+bool ItemScene::isVirtualized() const
+{
+    return !_virtualItems.isEmpty();
+}
+
+void ItemScene::clearContent()
+{
+    _journal.clear();
+    _virtualItems.clear();
+    _contentHash = ProjectHash();
+    _contentKeys.clear();
+    _contentItems.clear();
+    _changedContent.clear();
+    _changedKeys.clear();
+    _itemConnectors.clear();
+    _contentBoundsValid = false;
+    QGraphicsScene::clear();
+}
+
+bool ItemScene::addItemsFromXml(QDomElement const& dom, ProgressReporter const& reporter)
+{
+    QList<QGraphicsItem*> newItems;
+
+    if (!ItemSerializer::loadFromXml(dom, &newItems, reporter)) {
+        return false;
+    }
+
+    _loadingItems = true;
+    std::for_each(newItems.begin(), newItems.end(), std::bind(&ItemScene::adoptItem, this, std::placeholders::_1));
+    _loadingItems = false;
 
     updateBoundingRect();
     return true;
 }
 
+void ItemScene::adoptItem(QGraphicsItem* graphicsItem)
+{
+    auto shouldConnect = [](QGraphicsObject* graphicsObject) {
+        return
+                qobject_cast<AbstractItem*>  (graphicsObject) != nullptr
+             || qobject_cast<ItemNote*>      (graphicsObject) != nullptr
+             || qobject_cast<Item_Connector*>(graphicsObject) != nullptr;
+    };
+
+    auto graphicsObject = graphicsItem->toGraphicsObject();
+
+    if (shouldConnect(graphicsObject)) {
+        connect(graphicsObject, SIGNAL(changed()), this, SIGNAL(sceneRealChanged()));
+    }
+
+    addItem(graphicsItem);
+}
+
 // This is a template because even though ItemNote has a similar interface to
 // the common AbstractItem base class, it does not inherit from it, so
 // polymorphism does not work.
@@ -860,8 +1361,20 @@ bool loadItemData(QDomElement const& element, T* item, char const* const tag)
     return true;
 }
 
-bool ItemScene::saveToXml(QDomDocument& document, QDomElement& xml) const
+bool ItemScene::saveToXml(QDomDocument& document, QDomElement& xml)
 {
+    flushPendingUpdates(); // save the current routes, also of items which are still dragged
     QList<QGraphicsItem*> itms = items();
-    return ItemSerializer::saveToXml(document, xml, constList(itms));
+
+    if (!ItemSerializer::saveToXml(document, xml, constList(itms))) {
+        return false;
+    }
+
+    // The virtual items get the ids after the created ones
+    qint32 const itemCount = std::count_if(itms.begin(), itms.end(), [](QGraphicsItem * item) {
+        return qobject_cast<AbstractItem*>(item->toGraphicsObject()) != nullptr;
+    });
+    _virtualItems.saveToXml(document, xml, itemCount);
+
+    return true;
 }
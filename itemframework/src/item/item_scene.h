@@ -3,12 +3,22 @@
 
 #include <QGraphicsScene>
 #include <QDomDocument>
+#include <QSet>
+#include <QTimer>
 
 #include "appcore.h"
+#include "item_port_index.h"
+#include "item_router.h"
+#include "item_record_store.h"
+#include "item_journal.h"
+#include "project/project_hash.h"
 
 class ProjectGui;
 class ItemOutput;
 class ItemInput;
+class Item_Connector;
+class AbstractItem;
+struct ProgressReporter;
 
 class ITEMFRAMEWORK_TEST_EXPORT ItemScene : public QGraphicsScene
 {
@@ -19,19 +29,66 @@ public:
     ~ItemScene();
 
     /**
-     * @brief Load the current scene from the passed xml element
+     * @brief Load the current scene from the passed xml element.
+     * If the element contains more items than the setting "VirtualSceneThreshold" (0 disables the limit),
+     * the scene is virtualized: the items are kept as records and only created by materialize().
+     * Until then, they do not take part in the data flow. Connected items are always created together,
+     * so this only delays the data flow of whole groups of connected items which were never visible.
      * @param dom the element to load the scene from
      * @return true on success
      */
     bool loadFromXml(QDomElement& dom);
 
+    /**
+     * @brief Creates the virtual items in \a rect, together with all items they are connected to.
+     * The views call this for their visible area.
+     * @param rect An area in scene coordinates
+     */
+    void materialize(QRectF const& rect);
+
+    /**
+     * @return true if some items of this scene are only kept as records
+     */
+    bool isVirtualized() const;
+
+    /**
+     * @brief Removes and deletes all items, including the virtual ones, and forgets the undo history
+     */
+    void clearContent();
+
     /**
      * @brief Save the current scene with all items and their config to xml
      * @param document the document which can be used to create elements on it
      * @param xml the DomElement to save the scene to
      * @return true on success
      */
-    bool saveToXml(QDomDocument& document, QDomElement& xml) const;
+    bool saveToXml(QDomDocument& document, QDomElement& xml);
+
+    /**
+     * @brief Reverts the last edit of the user: adding or removing items and connections, moving items,
+     * renaming items, changing item settings or editing a connector path
+     */
+    void undo();
+
+    /**
+     * @brief Repeats the last undone edit
+     */
+    void redo();
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /**
+     * @return The journal of the edits, used by the items to record renames and path edits
+     */
+    ItemJournal& journal();
+
+    /**
+     * @brief Returns the structural hash of all items, connectors and notes of the scene, including the virtual ones.
+     * The hash is taken from the loaded xml and kept up to date per item: only the items which were added or changed
+     * since the last call are serialized and hashed again.
+     */
+    ProjectHash const& contentHash();
 
     /**
      * @brief Resets the bounding rect. Call this method after resizing the view. The sceneRect will be shrinked if possible
@@ -64,7 +121,7 @@ public:
     /**
      * @brief copies the selected items & connections to clipboard
      */
-    void copy() const;
+    void copy();
 
     /**
      * @brief Creates a template using the currently selected items.
@@ -75,7 +132,7 @@ public:
      * @brief Copy the passed items to clipboard
      * @param itms the items, connectors & notes to copy to clipboard
      */
-    void copy(QList<QGraphicsItem*> itms) const;
+    void copy(QList<QGraphicsItem*> itms);
 
     /**
      * @return Returns the associated project gui, which renders/owns this view/scene
@@ -95,6 +152,56 @@ public:
      */
     QPixmap createPixmap(QList<QGraphicsItem*> items, const QRectF& bounding) const;
 
+    /**
+     * @return The spatial index of all inputs and outputs in this scene. It is maintained by the inputs and outputs themselves.
+     */
+    ItemPortIndex& portIndex();
+
+    /**
+     * @return The connector router of this scene. Its obstacles are the boxes of all items, kept up to date by trackItemChange().
+     */
+    ItemRouter const& router() const;
+
+    /**
+     * @return The bounding rect of all items, notes and connectors (including the virtual ones), like itemsBoundingRect()
+     * without the other graphics items. It is maintained incrementally and only recalculated after it shrank.
+     */
+    QRectF contentBounds();
+
+    /**
+     * @brief Keeps the cached content bounds of the scene of \a item up to date.
+     * Top level items (items, notes & connectors) call this from their itemChange() for every change.
+     * Entering a scene and moving expand the bounds, leaving a scene marks them for recalculation if necessary.
+     * The boxes of AbstractItems are also passed to the router as obstacles.
+     * @param item The item that changed
+     * @param change The kind of change
+     */
+    static void trackItemChange(QGraphicsItem* item, QGraphicsItem::GraphicsItemChange change);
+
+    /**
+     * @brief Updates the cached bounds of \a item in its scene. Call this when the item changed its geometry.
+     */
+    static void updateItemBounds(QGraphicsItem* item);
+
+    /**
+     * @brief Marks the route of \a connector as dirty. All dirty connectors are flushed together
+     * once the event loop is idle again, i.e. at most once per frame, no matter how often their items moved.
+     */
+    void scheduleConnectorUpdate(Item_Connector* connector);
+
+    /**
+     * @brief Removes \a connector from the dirty connectors, e.g. because it leaves the scene
+     */
+    void cancelConnectorUpdate(Item_Connector* connector);
+
+    /**
+     * @brief Called by \a item when its scene position changed. While a selection of several items is dragged,
+     * the scene collects the moved items and updates their bounds, ports and routes together once per frame and on release,
+     * followed by a single sceneRealChanged() instead of one change per item.
+     * @return true if the move was deferred, false if the item has to handle it itself
+     */
+    bool deferItemMove(AbstractItem* item);
+
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent);
     void mouseMoveEvent(QGraphicsSceneMouseEvent* mouseEvent);
@@ -105,17 +212,33 @@ protected:
     void dropEvent(QGraphicsSceneDragDropEvent* event);
     void dragMoveEvent(QGraphicsSceneDragDropEvent* event);
 
+private slots:
+    void flushPendingUpdates();
+    void onItemContentChanged();
+
 signals:
     void sceneRealChanged();
     void loadingProgress(const int progress, const QString& loadcomment = "", const QString& loadinfo = "Loading Project");
 
 private:
+    friend class ItemJournal;
+
     bool notesInInsertMode();
     void deleteItems(QList<QGraphicsItem*> items);
     void insertItem(QString const& name, QPointF const& position);
+    void adoptItem(QGraphicsItem* item);
 
     void updateConnectionLine();
     void updateBoundingRect();
+    void flushMovedItems();
+    void flushConnectorUpdates();
+    void rerouteCrossedConnectors();
+    void trackContent(QGraphicsItem* item, bool inScene);
+    void markContentChanged(QGraphicsItem* item);
+    void updateContentHash(QString const& key);
+    QString contentKey(QGraphicsItem* item) const;
+    QByteArray contentLeaf(QGraphicsItem* item) const;
+    bool addItemsFromXml(QDomElement const& dom, ProgressReporter const& reporter);
 
     bool startMove(QGraphicsSceneMouseEvent* event);
     bool startConnection(QGraphicsSceneMouseEvent* mouseEvent);
@@ -138,6 +261,7 @@ private:
     bool _startItemIsInput;
     bool _recalculateBoundingRect = true;
     bool _inMovingMode = false;
+    bool _inMoveTransaction = false; // a selection of several items is dragged
 
     bool _reversed = false;
     ItemInput* _input = nullptr;
@@ -147,6 +271,29 @@ private:
     int _type;
     QRectF _sceneRect;
     QPointF _mouseItemDiff;
+    ItemPortIndex _portIndex;
+    ItemRouter _router;
+    ItemRecordStore _virtualItems;
+    ItemJournal _journal;
+
+    // Cached scene bounds of all top level items and their union. The union is only recalculated
+    // if an item which defined one of its edges moved inward or was removed.
+    QHash<QGraphicsItem*, QRectF> _itemBounds;
+    QRectF _contentBounds;
+    bool _contentBoundsValid = true;
+
+    QSet<Item_Connector*> _dirtyConnectors; // flushed before saving and copying
+    QTimer _connectorUpdateTimer;
+    QSet<AbstractItem*> _movedItems; // deferred by the move transaction
+    QSet<AbstractItem*> _crossingItems; // moved boxes, the connectors crossing them are rerouted by the next flush
+
+    ProjectHash _contentHash;
+    QHash<QGraphicsItem*, QString> _contentKeys; // the key of every item in _contentHash
+    QMultiHash<QString, QGraphicsItem*> _contentItems; // the items of every key, several ones share a leaf
+    QSet<QGraphicsItem*> _changedContent; // items whose leaf in _contentHash is outdated
+    QSet<QString> _changedKeys; // keys whose leaf in _contentHash is outdated, e.g. because an item was removed
+    QMultiHash<AbstractItem*, Item_Connector*> _itemConnectors; // their keys contain the item names
+    bool _loadingItems = false; // the loaded items are already part of _contentHash
 };
 
 #endif // ITEM_SCENE_H
@@ -4,6 +4,7 @@
 #include "item/item_output.h"
 #include "item/item_note.h"
 #include "item/item_connector.h"
+#include "item/item_batch.h"
 #include "plugin/plugin_manager.h"
 
 #include <QDebug>
@@ -77,6 +78,9 @@ bool ItemSerializer::loadFromXml(QDomElement const& items,
         return true;
     }
 
+    // Realign, propagate and route once after all items and connections exist
+    ItemBatch batch;
+
     auto countChildrenIf = [](QDomElement const& parent,
                               std::function<bool(QDomElement const&)> predicate) {
         int count = 0;
@@ -132,7 +136,7 @@ bool ItemSerializer::loadFromXml(QDomElement const& items,
         auto loadConnector = [](QDomElement const& element, ItemInput* input, ItemOutput* output) {
             auto connector = new Item_Connector(output, input);
             connector->load_additional(element); // Load user modified path or custom routing
-            connector->do_update();
+            connector->schedule_update(); // routed when the batch commits
             return connector;
         };
 
@@ -377,3 +381,64 @@ bool ItemSerializer::saveToXml(QDomDocument& document,
 
     return true;
 }
+
+bool ItemSerializer::isItemElement(QDomElement const& element)
+{
+    return element.tagName() == GraphicsItemTag;
+}
+
+bool ItemSerializer::isConnectorElement(QDomElement const& element)
+{
+    return element.tagName() == GraphicsItemConnectorTag;
+}
+
+bool ItemSerializer::isNoteElement(QDomElement const& element)
+{
+    return element.tagName() == GraphicsItemNoteTag;
+}
+
+QString ItemSerializer::itemName(QDomElement const& element)
+{
+    return element.attribute(NameAttrTag);
+}
+
+QString ItemSerializer::itemType(QDomElement const& element)
+{
+    return element.attribute(TypeAttrTag);
+}
+
+qint32 ItemSerializer::itemId(QDomElement const& element)
+{
+    return element.attribute(IdAttrTag).toInt();
+}
+
+void ItemSerializer::setItemId(QDomElement& element, qint32 id)
+{
+    element.setAttribute(IdAttrTag, id);
+}
+
+QPointF ItemSerializer::itemPosition(QDomElement const& element)
+{
+    return QPointF(element.attribute(XPosAttrTag).toDouble(), element.attribute(YPosAttrTag).toDouble());
+}
+
+QPair<qint32, qint32> ItemSerializer::connectorItemIds(QDomElement const& element)
+{
+    return qMakePair(element.attribute(FromItemAttrTag).toInt(), element.attribute(ToItemAttrTag).toInt());
+}
+
+void ItemSerializer::setConnectorItemIds(QDomElement& element, qint32 from, qint32 to)
+{
+    element.setAttribute(FromItemAttrTag, from);
+    element.setAttribute(ToItemAttrTag, to);
+}
+
+QPair<qint32, qint32> ItemSerializer::connectorPortIndexes(QDomElement const& element)
+{
+    return qMakePair(element.attribute(FromIndexAttrTag).toInt(), element.attribute(ToIndexAttrTag).toInt());
+}
+
+QStringList ItemSerializer::positionalAttributes()
+{
+    return {IdAttrTag, FromItemAttrTag, ToItemAttrTag};
+}
@@ -7,6 +7,9 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QStringList>
 
 struct ITEMFRAMEWORK_TEST_EXPORT ItemSerializer
 {
@@ -18,6 +21,20 @@ struct ITEMFRAMEWORK_TEST_EXPORT ItemSerializer
                             QList<class QGraphicsItem*>* itemsOut,
                             ProgressReporter progressReporter,
                             bool shouldConnectIO = true);
+
+    // Accessors for the serialized form, used to keep items as XML records without creating them (see ItemRecordStore)
+    static bool isItemElement(QDomElement const& element);
+    static bool isConnectorElement(QDomElement const& element);
+    static bool isNoteElement(QDomElement const& element);
+    static QString itemName(QDomElement const& element);
+    static QString itemType(QDomElement const& element);
+    static qint32 itemId(QDomElement const& element);
+    static void setItemId(QDomElement& element, qint32 id);
+    static QPointF itemPosition(QDomElement const& element);
+    static QPair<qint32, qint32> connectorItemIds(QDomElement const& element); // (from, to)
+    static void setConnectorItemIds(QDomElement& element, qint32 from, qint32 to);
+    static QPair<qint32, qint32> connectorPortIndexes(QDomElement const& element); // (output of from, input of to)
+    static QStringList positionalAttributes(); // attributes which only refer to the position of an element in its list
 };
 
 #endif // ITEM_SERIALIZER_H
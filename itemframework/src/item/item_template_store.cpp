@@ -0,0 +1,235 @@
+#include "item_template_store.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUuid>
+
+static const char* const IndexFileName = "index.xml";
+static const char* const IndexDocType = "ItemTemplatesIndex";
+static const char* const IndexRootTag = "ItemTemplates";
+static const char* const IndexVersionAttrTag = "version";
+static const char* const TemplateTag = "Template";
+static const char* const IdAttrTag = "id";
+static const char* const NameAttrTag = "name";
+static const char* const BodyFileExt = ".xml";
+static const char* const PreviewFileExt = ".png";
+
+ItemTemplateStore::ItemTemplateStore(QString const& directory)
+    : _directory{directory}
+{
+    readIndex();
+}
+
+QString ItemTemplateStore::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+           + QDir::separator() + "templates";
+}
+
+QVector<ItemTemplateStore::Entry> const& ItemTemplateStore::entries() const
+{
+    return _entries;
+}
+
+QString ItemTemplateStore::add(QString const& name, QDomDocument const& items, QPixmap const& preview)
+{
+    if (!ensureDirectory()) {
+        return {};
+    }
+
+    QString const id = QString::fromLatin1(QUuid::createUuid().toRfc4122().toHex());
+
+    QSaveFile body(bodyFilePath(id));
+
+    if (!body.open(QIODevice::WriteOnly) || body.write(items.toByteArray()) < 0 || !body.commit()) {
+        qWarning() << "Failed to write template" << name << ":" << body.errorString();
+        return {};
+    }
+
+    if (!preview.isNull() && !preview.save(previewFilePath(id), "PNG")) {
+        qWarning() << "Failed to write preview for template" << name;
+    }
+
+    _entries.append(Entry{id, name});
+
+    if (!writeIndex()) {
+        _entries.removeLast();
+        QFile::remove(bodyFilePath(id));
+        QFile::remove(previewFilePath(id));
+        return {};
+    }
+
+    return id;
+}
+
+bool ItemTemplateStore::remove(QString const& id)
+{
+    int const index = indexOf(id);
+
+    if (index < 0) {
+        return false;
+    }
+
+    Entry const removed = _entries.takeAt(index);
+
+    if (!writeIndex()) {
+        _entries.insert(index, removed);
+        return false;
+    }
+
+    // The index does not reference the files anymore, so failing to delete them only leaves garbage behind
+    QFile::remove(bodyFilePath(id));
+    QFile::remove(previewFilePath(id));
+
+    return true;
+}
+
+bool ItemTemplateStore::rename(QString const& id, QString const& name)
+{
+    int const index = indexOf(id);
+
+    if (index < 0) {
+        return false;
+    }
+
+    QString const oldName = _entries[index].name;
+    _entries[index].name = name;
+
+    if (!writeIndex()) {
+        _entries[index].name = oldName;
+        return false;
+    }
+
+    return true;
+}
+
+QString ItemTemplateStore::bodyFilePath(QString const& id) const
+{
+    return QDir(_directory).absoluteFilePath(id + BodyFileExt);
+}
+
+QString ItemTemplateStore::previewFilePath(QString const& id) const
+{
+    return QDir(_directory).absoluteFilePath(id + PreviewFileExt);
+}
+
+QByteArray ItemTemplateStore::loadBody(QString const& id) const
+{
+    QFile body(bodyFilePath(id));
+
+    if (!body.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to read template" << id << ":" << body.errorString();
+        return {};
+    }
+
+    return body.readAll();
+}
+
+QPixmap ItemTemplateStore::loadPreview(QString const& id) const
+{
+    QPixmap preview;
+    QString const path = previewFilePath(id);
+
+    if (QFile::exists(path)) {
+        preview.load(path, "PNG");
+    }
+
+    return preview;
+}
+
+int ItemTemplateStore::indexOf(QString const& id) const
+{
+    for (int i = 0; i < _entries.size(); i++) {
+        if (_entries.at(i).id == id) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+bool ItemTemplateStore::ensureDirectory() const
+{
+    QDir directory(_directory);
+
+    if (!directory.exists() && !directory.mkpath(".")) {
+        qWarning() << "Failed to create template directory" << _directory;
+        return false;
+    }
+
+    return true;
+}
+
+bool ItemTemplateStore::readIndex()
+{
+    _entries.clear();
+
+    QFile indexFile(QDir(_directory).absoluteFilePath(IndexFileName));
+
+    if (!indexFile.exists()) {
+        // No library yet, this is not an error
+        return true;
+    }
+
+    QDomDocument index;
+    QString parserError;
+
+    if (!indexFile.open(QIODevice::ReadOnly) || !index.setContent(&indexFile, &parserError)) {
+        qWarning() << "Failed to read template index" << indexFile.fileName() << parserError;
+        return false;
+    }
+
+    QDomElement const root = index.documentElement();
+
+    if (root.tagName() != IndexRootTag) {
+        qWarning() << "Template index has wrong root element" << root.tagName();
+        return false;
+    }
+
+    for (QDomElement element = root.firstChildElement(TemplateTag); !element.isNull();
+            element = element.nextSiblingElement(TemplateTag)) {
+        Entry const entry{element.attribute(IdAttrTag), element.attribute(NameAttrTag)};
+
+        if (entry.id.isEmpty() || !QFile::exists(bodyFilePath(entry.id))) {
+            qDebug() << "Skipping template" << entry.name << "without body";
+            continue;
+        }
+
+        _entries.append(entry);
+    }
+
+    return true;
+}
+
+bool ItemTemplateStore::writeIndex() const
+{
+    if (!ensureDirectory()) {
+        return false;
+    }
+
+    QDomDocument index(IndexDocType);
+    QDomElement root = index.createElement(IndexRootTag);
+    root.setAttribute(IndexVersionAttrTag, 1);
+
+    for (Entry const& entry : _entries) {
+        QDomElement element = index.createElement(TemplateTag);
+        element.setAttribute(IdAttrTag, entry.id);
+        element.setAttribute(NameAttrTag, entry.name);
+        root.appendChild(element);
+    }
+
+    index.appendChild(root);
+
+    // Write to a temporary file first, so a crash never leaves a truncated index behind
+    QSaveFile indexFile(QDir(_directory).absoluteFilePath(IndexFileName));
+
+    if (!indexFile.open(QIODevice::WriteOnly) || indexFile.write(index.toByteArray()) < 0 || !indexFile.commit()) {
+        qWarning() << "Failed to write template index" << indexFile.fileName() << indexFile.errorString();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef ITEM_TEMPLATE_STORE_H
+#define ITEM_TEMPLATE_STORE_H
+
+#include "appcore.h"
+
+#include <QString>
+#include <QVector>
+#include <QPixmap>
+#include <QDomDocument>
+
+/**
+ * @brief The ItemTemplateStore class persists item templates in a library directory.
+ *
+ * Every template body is stored in its own file (<id>.xml) together with a rendered
+ * preview (<id>.png). A small index file maps the template ids to their names and
+ * defines the order of the templates. Adding, removing and renaming a template only
+ * touches the index and the files of that template, the bodies are only read when
+ * they are actually needed.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ItemTemplateStore
+{
+public:
+    /**
+     * @brief An index entry of the store
+     */
+    struct Entry {
+        QString id;
+        QString name;
+    };
+
+    /**
+     * @brief Opens the template library located in \a directory. The index is read immediately.
+     * @param directory The library directory. It is created on the first write.
+     */
+    explicit ItemTemplateStore(QString const& directory = defaultDirectory());
+
+    /**
+     * @return The default library directory, located in the application data location
+     */
+    static QString defaultDirectory();
+
+    /**
+     * @return All templates of the library in index order
+     */
+    QVector<Entry> const& entries() const;
+
+    /**
+     * @brief Adds a new template to the library
+     * @param name The name of the template
+     * @param items The XML representation of the items
+     * @param preview The rendered preview of the items
+     * @return The id of the new template, or an empty string on failure
+     */
+    QString add(QString const& name, QDomDocument const& items, QPixmap const& preview);
+
+    /**
+     * @brief Removes the template \a id and its files from the library
+     * @return true on success
+     */
+    bool remove(QString const& id);
+
+    /**
+     * @brief Renames the template \a id. Only the index is rewritten.
+     * @return true on success
+     */
+    bool rename(QString const& id, QString const& name);
+
+    /**
+     * @return The absolute path of the file holding the body of template \a id
+     */
+    QString bodyFilePath(QString const& id) const;
+
+    /**
+     * @return The raw XML body of template \a id, or an empty array if it cannot be read
+     */
+    QByteArray loadBody(QString const& id) const;
+
+    /**
+     * @return The stored preview of template \a id, or a null pixmap if there is none
+     */
+    QPixmap loadPreview(QString const& id) const;
+
+private:
+    bool readIndex();
+    bool writeIndex() const;
+    bool ensureDirectory() const;
+    QString previewFilePath(QString const& id) const;
+    int indexOf(QString const& id) const;
+
+    QString _directory;
+    QVector<Entry> _entries;
+};
+
+#endif // ITEM_TEMPLATE_STORE_H
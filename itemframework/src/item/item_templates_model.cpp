@@ -4,112 +4,149 @@
 #include "item_scene.h"
 #include "project/project_gui.h"
 
-#include <functional>
+#include <QFile>
 
 char const* const mimeType = "application/x-itemframework-items";
 char const* const settingsKey = "ItemTemplates";
 
-template <typename F, typename T>
-auto bind1st(F&& f, T&& t) -> decltype(std::bind(std::forward<F>(f), std::forward<T>(t), std::placeholders::_1))
-{
-    return std::bind(std::forward<F>(f), std::forward<T>(t), std::placeholders::_1);
-}
+namespace {
 
-template <typename F, typename T>
-auto bind2nd(F&& f, T&& t) -> decltype(std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<T>(t)))
+/**
+ * @brief Mime data which reads the template body from the library only when a drop target asks for it.
+ * It only keeps the path of the body, as drag or clipboard data may outlive the model and its store.
+ */
+class TemplateMimeData : public QMimeData
 {
-    return std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<T>(t));
+public:
+    explicit TemplateMimeData(QString const& bodyFilePath)
+        : _bodyFilePath(bodyFilePath)
+    {
+    }
+
+    QStringList formats() const
+    {
+        return { mimeType };
+    }
+
+protected:
+    QVariant retrieveData(QString const& format, QVariant::Type) const
+    {
+        if (format != mimeType) {
+            return {};
+        }
+
+        if (_body.isNull()) {
+            QFile body(_bodyFilePath);
+
+            if (!body.open(QIODevice::ReadOnly)) {
+                qWarning() << "Failed to read template" << _bodyFilePath << ":" << body.errorString();
+                return {};
+            }
+
+            _body = body.readAll();
+        }
+
+        return _body;
+    }
+
+private:
+    QString const _bodyFilePath;
+    mutable QByteArray _body;
+};
+
 }
 
 ItemTemplatesModel::ItemTemplatesModel(QObject* parent)
-    : QStandardItemModel{parent}, _templates{}
+    : QStandardItemModel{parent}, _store{}
 {
     loadTemplates();
 
-    auto for_each_template = [this](int first, int last, QModelIndex const& parent,
-                                    std::function<void(QString const&, QDomDocument const&)> f) {
+    connect(this, &ItemTemplatesModel::rowsAboutToBeRemoved,
+            [this](QModelIndex const& parent, int first, int last) {
         for (int current = first; current <= last; current++) {
-            auto nameVariant = this->data(this->index(current, 0, parent));
-            auto templateVariant = this->data(this->index(current, 0, parent), Qt::UserRole);
-
-            if (nameVariant.isValid() && templateVariant.isValid()) {
-                auto name = nameVariant.value<QString>();
-                auto documentBytes = templateVariant.value<QByteArray>();
-                QDomDocument templates{};
-                templates.setContent(documentBytes);
+            auto id = this->data(this->index(current, 0, parent), Qt::UserRole).toString();
 
-                f(name, templates);
+            if (!id.isEmpty()) {
+                _store.remove(id);
             }
         }
-    };
-
-    auto has_name = [](Template const& templ, QString const& name) {
-        return templ.first == name;
-    };
-
-    connect(this, &ItemTemplatesModel::rowsInserted,
-            [=](QModelIndex const& parent, int first, int last) {
-        for_each_template(first, last, parent, [this](QString const& name, QDomDocument const& templ) {
-            Template itemTemplate{name, templ};
-            this->_templates.append(itemTemplate);
-        });
-        SettingsScope::globalScope()->setValue(settingsKey, QVariant::fromValue(_templates));
     });
+}
 
-    connect(this, &ItemTemplatesModel::rowsAboutToBeRemoved,
-            [=](QModelIndex const& parent, int first, int last) {
-        for_each_template(first, last, parent, [=](QString const& name, QDomDocument const&) {
-                auto match = std::find_if(_templates.begin(), _templates.end(), bind2nd(has_name, name));
-                if (match != _templates.cend()) {
-                    _templates.erase(match);
-                }
-        });
-        SettingsScope::globalScope()->setValue(settingsKey, QVariant::fromValue(_templates));
-    });
+bool ItemTemplatesModel::addTemplate(QString const& name, QDomDocument const& items, QPixmap const& pixmap)
+{
+    auto id = _store.add(name, items, pixmap);
 
-    connect(this, &ItemTemplatesModel::templateRenamed, [=](QString const& oldName, QString const& newName) {
-        auto match = std::find_if(_templates.begin(), _templates.end(), bind2nd(has_name, oldName));
-        if (match != _templates.end()) {
-            match->first = newName;
+    if (id.isEmpty()) {
+        return false;
+    }
 
-            SettingsScope::globalScope()->setValue(settingsKey, QVariant::fromValue(_templates));
-        }
-    });
+    appendTemplate(id, name, pixmap);
+
+    return true;
+}
+
+void ItemTemplatesModel::appendTemplate(QString const& id, QString const& name, QPixmap const& pixmap)
+{
+    auto item = new QStandardItem{name};
+    item->setData(id, Qt::UserRole);
+    item->setData(pixmap, Qt::UserRole + 1);
+
+    appendRow(item);
 }
 
 void ItemTemplatesModel::loadTemplates()
 {
-    auto templatesVariant = SettingsScope::globalScope()->value(settingsKey);
+    migrateLegacyTemplates();
 
-    if (templatesVariant.isValid()) {
-        auto templates = templatesVariant.value<TemplatesContainer>();
+    for (auto const& entry : _store.entries()) {
+        auto pixmap = _store.loadPreview(entry.id);
+
+        if (pixmap.isNull()) {
+            // The preview got lost, render it once from the stored body
+            QDomDocument templateDocument;
+            templateDocument.setContent(_store.loadBody(entry.id));
+
+            ItemScene scene{{}};
+            pixmap = scene.createPixmap(templateDocument);
+        }
+
+        if (pixmap.isNull()) {
+            qDebug() << "pixmap for template " << entry.name << " is null";
+            continue;
+        }
 
-        loadTemplates(templates);
+        appendTemplate(entry.id, entry.name, pixmap);
     }
 }
 
-void ItemTemplatesModel::loadTemplates(TemplatesContainer const& templates)
+void ItemTemplatesModel::migrateLegacyTemplates()
 {
-    _templates = templates;
+    auto templatesVariant = SettingsScope::globalScope()->value(settingsKey);
+
+    if (!templatesVariant.isValid()) {
+        return;
+    }
 
-    auto loadTemplate = [this](Template const& templ) {
-        auto templateName = templ.first;
-        auto templateDocument = templ.second;
-        auto item = new QStandardItem{templateName};
+    auto templates = templatesVariant.value<TemplatesContainer>();
+    TemplatesContainer remaining;
 
+    for (auto const& templ : templates) {
         ItemScene scene{{}};
-        auto pixmap = scene.createPixmap(templateDocument);
-        if (pixmap.isNull()) {
-            qDebug() << "pixmap for template " << templateName << " is null";
-            return;
-        }
-        item->setData(templ.second.toByteArray(), Qt::UserRole);
-        item->setData(pixmap, Qt::UserRole + 1);
+        auto pixmap = scene.createPixmap(templ.second);
 
-        this->appendRow(item);
-    };
+        if (_store.add(templ.first, templ.second, pixmap).isEmpty()) {
+            remaining.append(templ);
+        }
+    }
 
-    std::for_each(_templates.cbegin(), _templates.cend(), loadTemplate);
+    // Only the templates which could not be imported are kept, so they are retried without importing the others again
+    if (remaining.isEmpty()) {
+        SettingsScope::globalScope()->setValue(settingsKey, QVariant());
+    } else {
+        qWarning() << "Not all item templates could be moved to the template library";
+        SettingsScope::globalScope()->setValue(settingsKey, QVariant::fromValue(remaining));
+    }
 }
 
 bool ItemTemplatesModel::canDropMimeData(QMimeData const*, Qt::DropAction, int, int, QModelIndex const&) const
@@ -129,11 +166,7 @@ QStringList ItemTemplatesModel::mimeTypes() const
 
 QMimeData* ItemTemplatesModel::mimeData(QModelIndexList const& indexes) const
 {
-    auto mimeData = new QMimeData{};
-
-    mimeData->setData(mimeType, data(indexes.first(), Qt::UserRole).toString().toLatin1());
-
-    return mimeData;
+    return new TemplateMimeData{_store.bodyFilePath(data(indexes.first(), Qt::UserRole).toString())};
 }
 
 bool ItemTemplatesModel::setData(QModelIndex const& index, QVariant const& value, int role)
@@ -144,6 +177,9 @@ bool ItemTemplatesModel::setData(QModelIndex const& index, QVariant const& value
             return false;
         } else {
             auto oldText = this->data(index).toString();
+            if (!_store.rename(this->data(index, Qt::UserRole).toString(), newText)) {
+                return false;
+            }
             emit templateRenamed(oldText, newText);
         }
     }
@@ -6,6 +6,7 @@
 #include <QDomDocument>
 
 #include "helper/startup_helper.h"
+#include "item_template_store.h"
 
 class ItemTemplatesModel : public QStandardItemModel
 {
@@ -16,6 +17,16 @@ public:
     using TemplatesContainer = QVector<Template>;
 
     explicit ItemTemplatesModel(QObject* parent = nullptr);
+
+    /**
+     * @brief Adds a new template to the template library and appends it to the model
+     * @param name The name of the template
+     * @param items The XML representation of the items
+     * @param pixmap The rendered preview of the items
+     * @return true on success
+     */
+    bool addTemplate(QString const& name, QDomDocument const& items, QPixmap const& pixmap);
+
     bool canDropMimeData(QMimeData const* data, Qt::DropAction action, int row, int column, QModelIndex const& parent) const;
     QMimeData* mimeData(QModelIndexList const& indexes) const;
     bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent);
@@ -30,10 +41,11 @@ signals:
     void templateRenamed(QString const& oldName, QString const& newName);
 
 private:
-    TemplatesContainer _templates;
+    ItemTemplateStore _store;
 
     void loadTemplates();
-    void loadTemplates(TemplatesContainer const& templates);
+    void migrateLegacyTemplates();
+    void appendTemplate(QString const& id, QString const& name, QPixmap const& pixmap);
 };
 
 Q_DECLARE_METATYPE(ItemTemplatesModel::TemplatesContainer)
@@ -105,11 +105,9 @@ QString ItemTemplatesWidget::askTemplateName(bool* shouldCancel)
 
 void ItemTemplatesWidget::saveTemplate(QString const& name, QDomDocument const& items, QPixmap const& pixmap)
 {
-    auto* const item = new QStandardItem{name};
-    item->setData(items.toByteArray(), Qt::UserRole);
-    item->setData(pixmap, Qt::UserRole + 1);
-
-    _model->appendRow(item);
+    if (!_model->addTemplate(name, items, pixmap)) {
+        QMessageBox::warning(this, tr("Template not saved"), tr("The template could not be written to the template library"));
+    }
 }
 
 void ItemTemplatesWidget::deleteTemplates(QModelIndexList const& indexes)
@@ -30,6 +30,8 @@ void ItemView::wheelEvent(QWheelEvent* event)
             // Zooming out
             scale(1.0 / scaleFactor, 1.0 / scaleFactor);
         }
+
+        materializeVisibleItems();
     } else {
         QGraphicsView::wheelEvent(event);
     }
@@ -38,6 +40,24 @@ void ItemView::wheelEvent(QWheelEvent* event)
 void ItemView::resizeEvent(QResizeEvent*)
 {
     _scene->resetBounding();
+    materializeVisibleItems();
+}
+
+void ItemView::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+    materializeVisibleItems();
+}
+
+void ItemView::materializeVisibleItems()
+{
+    if (!_scene->isVirtualized()) {
+        return;
+    }
+
+    // Create the items half a viewport ahead, so they already exist when scrolled into view
+    QRectF const visible = mapToScene(viewport()->rect()).boundingRect();
+    _scene->materialize(visible.adjusted(-visible.width() / 2, -visible.height() / 2, visible.width() / 2, visible.height() / 2));
 }
 
 ItemScene* ItemView::itemScene()
@@ -54,7 +74,7 @@ bool ItemView::load(class QDomElement& domElement)
 
 bool ItemView::reload(QDomElement& domElement)
 {
-    _scene->clear();
+    _scene->clearContent();
     return load(domElement);
 }
 
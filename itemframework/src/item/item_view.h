@@ -20,11 +20,13 @@ public:
     bool save(QDomDocument& domDocument, QDomElement& domElement);
 
 private:
+    void materializeVisibleItems(); //creates the virtual items of a virtualized scene which are (almost) visible
     QSharedPointer<ProjectGui> _projectGui;
     ItemScene* _scene;
 protected:
     void wheelEvent(QWheelEvent* event);
     void resizeEvent(QResizeEvent* event);
+    void scrollContentsBy(int dx, int dy);
 };
 
 #endif // GRAPHICS_VIEW_H
@@ -1,5 +1,4 @@
 #include <QDebug>
-#include <QCryptographicHash>
 #include <QTimer>
 #include "abstract_project.h"
 #include "abstract_workspace.h"
@@ -102,9 +101,25 @@ void AbstractProject::setVersion(const QString& version)
     QTextStream(&_version) >> _majorProjectVersion >> _minorProjectVersion;
 }
 
-void AbstractProject::setExternChanged(bool isExternChanged)
+void AbstractProject::setExternChanged(bool isExternChanged, const QStringList& externChanges)
 {
     _isExternChanged = isExternChanged;
+    _externChanges = externChanges;
+}
+
+QImage AbstractProject::thumbnail() const
+{
+    return _thumbnail;
+}
+
+void AbstractProject::setThumbnail(const QImage& thumbnail)
+{
+    _thumbnail = thumbnail;
+}
+
+QStringList AbstractProject::externChanges() const
+{
+    return _externChanges;
 }
 
 QString AbstractProject::lastError() const
@@ -195,16 +210,35 @@ QDomDocument AbstractProject::projectDomDocumentTemplate(const QString& name, co
     return projectDomDocument;
 }
 
-bool AbstractProject::compareDomDocumentMD5(const QDomDocument& dom1, const QDomDocument& dom2)
+ProjectHash AbstractProject::contentHash()
 {
-    const QByteArray hashDom1 = QCryptographicHash::hash(dom1.toByteArray(), QCryptographicHash::Md5);
-    const QByteArray hashDom2 = QCryptographicHash::hash(dom2.toByteArray(), QCryptographicHash::Md5);
+    ProjectHash hash(domDocument().documentElement(), [](const QDomElement& element) {
+        return !ProjectHash::isItemContent(element);
+    });
+    hash.insert(itemsHash());
+    return hash;
+}
 
-    if (hashDom1.operator != (hashDom2)) {
-        return false;
+const ProjectHash& AbstractProject::itemsHash()
+{
+    if (!_isItemsHashValid) {
+        _itemsHash = ProjectHash();
+        _itemsHash.insertChildren(domDocument().documentElement(), ProjectHash::isItemContent);
+        _isItemsHashValid = true;
     }
 
-    return true;
+    return _itemsHash;
+}
+
+void AbstractProject::setItemsHash(const ProjectHash& itemsHash)
+{
+    _itemsHash = itemsHash;
+    _isItemsHashValid = true;
+}
+
+void AbstractProject::invalidateContentHash()
+{
+    _isItemsHashValid = false;
 }
 
 int AbstractProject::majorProjectVersion() const
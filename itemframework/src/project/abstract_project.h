@@ -11,7 +11,9 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QDomElement>
+#include <QImage>
 #include "helper/settings_scope.h"
+#include "project_hash.h"
 
 class AbstractProject : public QObject
 {
@@ -147,16 +149,6 @@ public:
      */
     static QDomDocument projectDomDocumentTemplate(const QString& name, const QString& version, const QString& description = "");
 
-    /**
-     * @brief Compare two domdocuments with each other via md5 hash bytearray.
-     *
-     * @param dom1 The first domDocument.
-     * @param dom2 The second domDocument.
-     *
-     * @return Returns \c true if the domDocuments are equil, otherwise returns \c false.
-     */
-    static bool compareDomDocumentMD5(const QDomDocument& dom1, const QDomDocument& dom2);
-
     /**
      * @brief This function validates a project domDocument xml structure. A validation error
      * can be printed by lastError.
@@ -284,6 +276,57 @@ public:
      */
     bool isExternChanged() const;
 
+    /**
+     * @return Returns a small preview image of the project, or a null image if there is none.
+     *
+     * \sa setThumbnail
+     */
+    QImage thumbnail() const;
+
+    /**
+     * @brief Set the preview image of the project, e.g. after the project was saved.
+     *
+     * @param thumbnail The preview image.
+     *
+     * \sa thumbnail
+     */
+    void setThumbnail(const QImage& thumbnail);
+
+    /**
+     * @return Returns the names of the items, connectors and notes which differ from the extern changed project.
+     *
+     * \sa isExternChanged
+     */
+    QStringList externChanges() const;
+
+    /**
+     * @brief The structural hash of the project domDocument. The hash of the items is cached until the domDocument is
+     * set again, the remaining project elements (e.g. settings) are hashed on every call.
+     *
+     * @return Returns the content hash of the project.
+     *
+     * \sa setItemsHash
+     */
+    ProjectHash contentHash();
+
+    /**
+     * @return Returns the structural hash of the items, connectors and notes of the project domDocument.
+     *
+     * \sa contentHash
+     * \sa setItemsHash
+     */
+    const ProjectHash& itemsHash();
+
+    /**
+     * @brief Set the hash of the items of the project, if it is already known (e.g. from the item scene which was
+     * saved to the domDocument). This saves hashing all items again.
+     *
+     * @param itemsHash The hash of the items, connectors and notes of the project.
+     *
+     * \sa contentHash
+     */
+    void setItemsHash(const ProjectHash& itemsHash);
+
 protected:
     /**
      * @brief Abstract project constructor.
@@ -334,10 +377,19 @@ protected:
      * @brief Set project changed by extern (e.g. project file was changed outside Traviz).
      *
      * @param isExternChanged The project extern changed state.
+     * @param externChanges The names of the changed items, connectors and notes.
      *
      * \sa isExternChanged
+     * \sa externChanges
+     */
+    void setExternChanged(bool isExternChanged, const QStringList& externChanges = QStringList());
+
+    /**
+     * @brief Drop the cached hash of the items, because the domDocument changed.
+     *
+     * \sa contentHash
      */
-    void setExternChanged(bool isExternChanged);
+    void invalidateContentHash();
 
 signals:
     void stateChange();
@@ -360,6 +412,10 @@ private:
     bool _isFastLoad = false;
     bool _isLoaded = false;
     bool _isExternChanged = false;
+    QStringList _externChanges;
+    QImage _thumbnail;
+    ProjectHash _itemsHash;
+    bool _isItemsHashValid = false;
 };
 
 #endif // ABSTRACT_PROJECT_H
@@ -1,5 +1,7 @@
 #include "file_helper.h"
 #include <QDir>
+#include <QCryptographicHash>
+#include <QXmlStreamReader>
 #include <QDomDocument>
 
 static QString _lastError;
@@ -102,6 +104,72 @@ QDomDocument FileHelper::domDocumentFromXMLFile(const QString& filePath)
     return domDocument;
 }
 
+QDomDocument FileHelper::domDocumentHeaderFromXMLFile(const QString& filePath)
+{
+    QDomDocument domDocument;
+
+    if (!fileExists(filePath) || !testFileOpenMode(filePath, QIODevice::ReadOnly)) {
+        return domDocument;
+    }
+
+    QFile file(filePath);
+    file.open(QIODevice::ReadOnly);
+    QXmlStreamReader reader(&file);
+
+    if (!reader.readNextStartElement()) {
+        _lastError = QString("Could not read root element of %1. QXmlStreamReader error: %2.").arg(filePath).arg(reader.errorString());
+        return domDocument;
+    }
+
+    QDomElement rootElement = domDocument.createElement(reader.qualifiedName().toString());
+
+    for (const QXmlStreamAttribute& attribute : reader.attributes()) {
+        rootElement.setAttribute(attribute.qualifiedName().toString(), attribute.value().toString());
+    }
+
+    domDocument.appendChild(rootElement);
+    _lastError.clear();
+    return domDocument;
+}
+
+FileHelper::Signature FileHelper::fileSignature(const QString& filePath)
+{
+    Signature signature;
+    const QFileInfo fileInfo(filePath);
+
+    if (!fileInfo.exists()) {
+        return signature;
+    }
+
+    signature.lastModified = fileInfo.lastModified();
+    signature.size = fileInfo.size();
+
+    QFile file(filePath);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(&file);
+        signature.contentHash = hash.result();
+    }
+
+    return signature;
+}
+
+bool FileHelper::updateFileSignature(const QString& filePath, Signature* signature)
+{
+    const QFileInfo fileInfo(filePath);
+
+    // A touch or a rewrite with the same content only changes the time, so the content decides
+    if (fileInfo.exists() && fileInfo.lastModified() == signature->lastModified && fileInfo.size() == signature->size) {
+        return false;
+    }
+
+    const Signature current = fileSignature(filePath);
+    const bool contentChanged = current.size != signature->size || current.contentHash != signature->contentHash;
+    *signature = current;
+    return contentChanged;
+}
+
 QString FileHelper::relativeToAbsoluteFilePath(const QString& filePathFrom, const QString& filePathTo)
 {
     const QFileInfo fileInfoTo(filePathTo);
@@ -8,13 +8,25 @@
 #ifndef FILEHELPER_H
 #define FILEHELPER_H
 
+#include "appcore.h"
+
 #include <QFile>
+#include <QDateTime>
 
 class QDomDocument;
 
-class FileHelper
+class ITEMFRAMEWORK_TEST_EXPORT FileHelper
 {
 public:
+    /**
+     * @brief The state of a file, to detect if a file changed notification really changed its content.
+     */
+    struct Signature {
+        QDateTime lastModified;
+        qint64 size = -1;
+        QByteArray contentHash;
+    };
+
     /**
      * @return Returns the last occured FileHelper error.
      */
@@ -85,6 +97,39 @@ public:
      */
     static QDomDocument domDocumentFromXMLFile(const QString& filePath);
 
+    /**
+     * @return Returns a DomDocument which only contains the root element of a xml file with its attributes.
+     * The file is read until the root element, the rest of the file is not parsed.
+     *
+     * @param filePath The xml filepath as string.
+     *
+     * \sa domDocumentFromXMLFile
+     */
+    static QDomDocument domDocumentHeaderFromXMLFile(const QString& filePath);
+
+    /**
+     * @return Returns the signature of a file: modification time, size and the hash of its content.
+     * The signature of a missing file is empty.
+     *
+     * @param filePath The filepath as string.
+     *
+     * \sa updateFileSignature
+     */
+    static Signature fileSignature(const QString& filePath);
+
+    /**
+     * @brief Compares a file with its last known signature and updates the signature. The file content
+     * is only read and hashed if the modification time or the size differ.
+     *
+     * @param filePath The filepath as string.
+     * @param signature The last known signature of the file.
+     *
+     * @return Returns \c true if the content of the file changed, otherwise returns \c false.
+     *
+     * \sa fileSignature
+     */
+    static bool updateFileSignature(const QString& filePath, Signature* signature);
+
     /**
      * @return Returns the absolute filepath from the relative first parameter. This function
      * needs a relativ filepath as first parameter and a absolut filepath as second parameter.
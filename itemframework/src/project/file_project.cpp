@@ -2,6 +2,7 @@
 #include "file_project.h"
 #include "project_manager_config.h"
 #include "abstract_workspace.h"
+#include "file_watch_service.h"
 
 FileProject::FileProject(SettingsScope* parentSettingsScope,
                          const QString& filePath,
@@ -32,6 +33,31 @@ FileProject::FileProject(SettingsScope* parentSettingsScope,
     setValid(projectIsValid);
 }
 
+FileProject::FileProject(SettingsScope* parentSettingsScope, const QString& filePath)
+    : FileProject(parentSettingsScope, filePath, FileHelper::domDocumentHeaderFromXMLFile(filePath))
+{
+    _isHeaderOnly = true;
+}
+
+QSharedPointer<FileProject> FileProject::createFileProjectFromHeader(SettingsScope* parentSettingsScope,
+                                                                     const QString& filePath,
+                                                                     const QDomDocument& headerDomDocument)
+{
+    QSharedPointer<FileProject> fileProject(new FileProject(parentSettingsScope, filePath, headerDomDocument));
+    fileProject->_isHeaderOnly = true;
+    return fileProject;
+}
+
+void FileProject::setHeaderDomDocument(const QDomDocument& headerDomDocument)
+{
+    if (isLoaded() || isDirty()) {
+        return;
+    }
+
+    setValid(setDomDocument(headerDomDocument));
+    _isHeaderOnly = true;
+}
+
 FileProject::~FileProject()
 {
 }
@@ -103,34 +129,32 @@ void FileProject::setAutosaveFilePath(const QString &autosaveFilePath)
     }
 
     if(isLoaded()){
-        _fileSystemWatcher.disconnect(this);
         FileHelper::removeFile(_autosaveFilePath);
     }
 
     _autosaveFilePath = autosaveFilePath;
 
     if(isLoaded()){
-        if(autosave()){
-            _fileSystemWatcher.addPath(_autosaveFilePath);
-        }
+        autosave();
     }
 }
 
 bool FileProject::save()
 {
     const QIODevice::OpenMode openMode = QIODevice::WriteOnly;
-    QDomElement projectRootDomElement =  _domDocument.documentElement();
+    QDomElement projectRootDomElement =  domDocument().documentElement(); // reads the document if only its header is known
 
-    if (!settingsScope()->save(_domDocument, projectRootDomElement)) {
+    if (_isHeaderOnly) {
+        setLastError(QString("Could not read project file %1. %2").arg(_fileInfo.filePath()).arg(FileHelper::lastError()));
         return false;
     }
 
-    if (!FileHelper::testFileOpenMode(_fileInfo.filePath(), openMode)) {
+    if (!settingsScope()->save(_domDocument, projectRootDomElement)) {
         return false;
     }
 
-    if (isLoaded()) {
-        _internalSave = true;
+    if (!FileHelper::testFileOpenMode(_fileInfo.filePath(), openMode)) {
+        return false;
     }
 
     QFile file(_fileInfo.filePath());
@@ -138,6 +162,11 @@ bool FileProject::save()
     file.write(_domDocument.toByteArray());
     file.close();
 
+    if (isLoaded()) {
+        // The notification about this save finds the same signature and is ignored
+        _fileSignature = FileHelper::fileSignature(_fileInfo.filePath());
+    }
+
     setExternChanged(false);
     setDirty(false);
 
@@ -151,7 +180,12 @@ bool FileProject::save()
 bool FileProject::autosave()
 {
     const QIODevice::OpenMode openMode = QIODevice::WriteOnly;
-    QDomElement projectRootDomElement =  _domDocument.documentElement();
+    QDomElement projectRootDomElement =  domDocument().documentElement(); // reads the document if only its header is known
+
+    if (_isHeaderOnly) {
+        setLastError(QString("Could not read project file %1. %2").arg(_fileInfo.filePath()).arg(FileHelper::lastError()));
+        return false;
+    }
 
     if (!settingsScope()->save(_domDocument, projectRootDomElement)) {
         return false;
@@ -184,7 +218,17 @@ void FileProject::reset()
         projectIsValid = false;
     }
 
-    QDomDocument projectDomDocument = FileHelper::domDocumentFromXMLFile(_fileInfo.filePath());
+    QDomDocument projectDomDocument;
+
+    // The file was already parsed to compare it, if it did not change again since, that document is taken
+    if (projectIsValid && !_externDomDocument.isNull() &&
+            !FileHelper::updateFileSignature(_fileInfo.filePath(), &_fileSignature)) {
+        projectDomDocument = _externDomDocument;
+    } else {
+        projectDomDocument = FileHelper::domDocumentFromXMLFile(_fileInfo.filePath());
+    }
+
+    _externDomDocument = QDomDocument();
 
     if (projectIsValid && !FileHelper::lastError().isEmpty()) {
         setLastError(FileHelper::lastError());
@@ -220,12 +264,34 @@ QString FileProject::path() const
 
 QDomDocument FileProject::domDocument() const
 {
+    if (_isHeaderOnly) {
+        const QDomDocument projectDomDocument = FileHelper::domDocumentFromXMLFile(_fileInfo.filePath());
+
+        // If the file can't be read, the header is kept, so the project is never saved without its content
+        if (!projectDomDocument.documentElement().isNull()) {
+            _domDocument = projectDomDocument;
+            _isHeaderOnly = false;
+        }
+    }
+
     return _domDocument;
 }
 
+void FileProject::dropDomDocument()
+{
+    // Keep the root element for the project attributes, the rest is read again when it is needed
+    QDomDocument header;
+    header.appendChild(header.importNode(_domDocument.documentElement(), false));
+    _domDocument = header;
+    _isHeaderOnly = true;
+    invalidateContentHash();
+}
+
 bool FileProject::setDomDocument(const QDomDocument& projectDomDocument)
 {
     _domDocument = projectDomDocument;
+    _isHeaderOnly = false;
+    invalidateContentHash();
 
     if (validateProjectDomDocument(_domDocument)) {
         setName(_domDocument.documentElement().attribute(ProDomElmNameAttLabel));
@@ -257,6 +323,13 @@ void FileProject::setFilePath(const QString &filePath)
         return;
     }
 
+    if (isLoaded()) {
+        FileWatchService::instance()->unwatch(_fileInfo.filePath(), this);
+        FileWatchService::instance()->watch(filePath, this, [this](const QString&) {
+            onProjectFileChanged();
+        });
+    }
+
     _fileInfo.setFile(filePath);
     setAutosaveFilePath(QString("%1/.%2.%3").arg(_fileInfo.absolutePath()).arg(_fileInfo.baseName()).arg(ProFileAutosaveExt));
 }
@@ -291,11 +364,19 @@ bool FileProject::setAutosaveDomDocument(const QDomDocument& domDocument)
 void FileProject::setLoaded(bool isLoaded)
 {
     if (isLoaded) {
-        connect(&_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &FileProject::onProjectFileChanged);
-        _fileSystemWatcher.addPath(_fileInfo.filePath());
+        FileWatchService::instance()->watch(_fileInfo.filePath(), this, [this](const QString&) {
+            onProjectFileChanged();
+        });
+        _fileSignature = FileHelper::fileSignature(_fileInfo.filePath());
     } else {
-        _fileSystemWatcher.disconnect(this);
+        FileWatchService::instance()->unwatch(_fileInfo.filePath(), this);
+        _externDomDocument = QDomDocument();
         cleanAutosave();
+
+        // Closed projects don't need their document, unless it has unsaved changes
+        if (!isDirty() && isValid()) {
+            dropDomDocument();
+        }
     }
 
     AbstractProject::setLoaded(isLoaded);
@@ -303,19 +384,27 @@ void FileProject::setLoaded(bool isLoaded)
 
 void FileProject::onProjectFileChanged()
 {
-    _fileSystemWatcher.addPath(_fileInfo.filePath());
-
     if (!isLoaded()) {
         return;
     }
 
-    if (_internalSave) {
-        _internalSave = false;
+    // Own saves, autosaves and touches don't change the content, they are detected without parsing the file
+    if (!FileHelper::updateFileSignature(_fileInfo.filePath(), &_fileSignature)) {
         return;
     }
 
-    if (!compareDomDocumentMD5(_domDocument, FileHelper::domDocumentFromXMLFile(_fileInfo.filePath()))) {
-        setExternChanged(true);
-        emit externDomChange();
+    // Only a changed content counts, not a different formatting or order of the items
+    const QDomDocument externDomDocument = FileHelper::domDocumentFromXMLFile(_fileInfo.filePath());
+    const QStringList externChanges = contentHash().differences(ProjectHash(externDomDocument.documentElement()));
+
+    if (externChanges.isEmpty()) {
+        // e.g. the file was changed back
+        _externDomDocument = QDomDocument();
+        setExternChanged(false);
+        return;
     }
+
+    _externDomDocument = externDomDocument;
+    setExternChanged(true, externChanges);
+    emit externDomChange();
 }
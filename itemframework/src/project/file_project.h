@@ -8,7 +8,6 @@
 #ifndef FILEPROJECT_H
 #define FILEPROJECT_H
 
-#include <QFileSystemWatcher>
 #include <QFileInfo>
 
 #include "abstract_project.h"
@@ -18,6 +17,25 @@ class FileProject : public AbstractProject
 {
 public:
     FileProject(SettingsScope* parentSettingsScope, const QString& filePath, const QDomDocument& domDocument);
+
+    /**
+     * @brief Constructs a project from the header (the root element) of its file. The complete document is
+     * read when it is needed, e.g. when the project is loaded.
+     */
+    FileProject(SettingsScope* parentSettingsScope, const QString& filePath);
+
+    /**
+     * @brief Creates a project from an already known header (e.g. from the FileWorkspaceIndex), without reading its file.
+     */
+    static QSharedPointer<FileProject> createFileProjectFromHeader(SettingsScope* parentSettingsScope,
+                                                                   const QString& filePath,
+                                                                   const QDomDocument& headerDomDocument);
+
+    /**
+     * @brief Replaces the header of a project which is not loaded, e.g. because its file changed.
+     * The complete document is read again when it is needed.
+     */
+    void setHeaderDomDocument(const QDomDocument& headerDomDocument);
     ~FileProject();
     bool autosaveExists() override;
     void cleanAutosave() override;
@@ -42,13 +60,15 @@ public:
 private:
     void setAutosaveFilePath(const QString &autosaveFilePath);
     void setFallbackAttributes();
-    QDomDocument _domDocument;
+    void dropDomDocument();
+    mutable QDomDocument _domDocument;
+    mutable bool _isHeaderOnly = false; // _domDocument only contains the root element
     QDomDocument _autosaveDomDocument;
-    QFileSystemWatcher _fileSystemWatcher;
+    QDomDocument _externDomDocument; // parsed when the file changed, reused by reset()
+    FileHelper::Signature _fileSignature; // of the last saved or checked file content
     QString _autosaveFilePath;
     QString _relativFilePath;
     QFileInfo _fileInfo;
-    bool _internalSave = false;
 
 private slots:
     void onProjectFileChanged();
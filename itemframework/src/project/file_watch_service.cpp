@@ -0,0 +1,200 @@
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QPointer>
+#include <limits>
+#include "file_watch_service.h"
+#include "project_manager_config.h"
+
+FileWatchService* FileWatchService::instance()
+{
+    static QPointer<FileWatchService> service;
+
+    if (service.isNull()) {
+        service = new FileWatchService(QCoreApplication::instance());
+    }
+
+    return service;
+}
+
+FileWatchService::FileWatchService(QObject* parent) : QObject(parent)
+{
+    _clock.start();
+    _dispatchTimer.setSingleShot(true);
+    connect(&_watcher, &QFileSystemWatcher::fileChanged, this, &FileWatchService::onFileChanged);
+    connect(&_watcher, &QFileSystemWatcher::directoryChanged, this, &FileWatchService::onDirectoryChanged);
+    connect(&_dispatchTimer, &QTimer::timeout, this, &FileWatchService::dispatch);
+}
+
+void FileWatchService::watch(const QString& filePath, QObject* receiver, const Handler& handler)
+{
+    if (filePath.isEmpty() || receiver == nullptr) {
+        return;
+    }
+
+    QHash<QObject*, Handler>& receivers = _receivers[filePath];
+
+    if (receivers.isEmpty()) {
+        addToWatcher(filePath);
+    }
+
+    receivers.insert(receiver, handler);
+
+    if (!_paths.contains(receiver)) {
+        connect(receiver, &QObject::destroyed, this, &FileWatchService::onReceiverDestroyed);
+    }
+
+    _paths[receiver].insert(filePath);
+}
+
+void FileWatchService::unwatch(const QString& filePath, QObject* receiver)
+{
+    auto receivers = _receivers.find(filePath);
+
+    if (receivers == _receivers.end() || receivers->remove(receiver) == 0) {
+        return;
+    }
+
+    auto paths = _paths.find(receiver);
+    paths->remove(filePath);
+
+    if (paths->isEmpty()) {
+        _paths.erase(paths);
+        disconnect(receiver, &QObject::destroyed, this, &FileWatchService::onReceiverDestroyed);
+    }
+
+    if (!receivers->isEmpty()) {
+        return;
+    }
+
+    // No receiver is left
+    _receivers.erase(receivers);
+    _pending.remove(filePath);
+    _watcher.removePath(filePath);
+
+    const QString directoryPath = QFileInfo(filePath).absolutePath();
+    auto missingPaths = _missingPaths.find(directoryPath);
+
+    if (missingPaths != _missingPaths.end() && missingPaths->remove(filePath) && missingPaths->isEmpty()) {
+        _missingPaths.erase(missingPaths);
+        _watcher.removePath(directoryPath);
+    }
+}
+
+void FileWatchService::unwatchAll(QObject* receiver)
+{
+    for (const QString& filePath : _paths.value(receiver)) {
+        unwatch(filePath, receiver);
+    }
+}
+
+bool FileWatchService::isWatching(const QString& filePath, QObject* receiver) const
+{
+    return _receivers.value(filePath).contains(receiver);
+}
+
+void FileWatchService::addToWatcher(const QString& filePath)
+{
+    if (QFileInfo::exists(filePath)) {
+        _watcher.addPath(filePath);
+        return;
+    }
+
+    // Wait for the file to be created (again) in its directory
+    const QString directoryPath = QFileInfo(filePath).absolutePath();
+    QSet<QString>& missingPaths = _missingPaths[directoryPath];
+
+    if (missingPaths.isEmpty() && QFileInfo::exists(directoryPath)) {
+        _watcher.addPath(directoryPath);
+    }
+
+    missingPaths.insert(filePath);
+}
+
+void FileWatchService::schedule()
+{
+    if (_pending.isEmpty()) {
+        _dispatchTimer.stop();
+        return;
+    }
+
+    qint64 due = std::numeric_limits<qint64>::max();
+
+    for (qint64 pathDue : _pending) {
+        due = qMin(due, pathDue);
+    }
+
+    _dispatchTimer.start(int(qMax<qint64>(0, due - _clock.elapsed())));
+}
+
+void FileWatchService::onFileChanged(const QString& filePath)
+{
+    if (!_receivers.contains(filePath)) {
+        return;
+    }
+
+    // A removed file or a file replaced by a rename is no longer watched
+    if (!_watcher.files().contains(filePath)) {
+        addToWatcher(filePath);
+    }
+
+    // Every notification of a path postpones it, so a burst is dispatched once
+    _pending.insert(filePath, _clock.elapsed() + FileChangedDelay);
+    schedule();
+}
+
+void FileWatchService::onDirectoryChanged(const QString& directoryPath)
+{
+    const QSet<QString> missingPaths = _missingPaths.value(directoryPath);
+
+    for (const QString& filePath : missingPaths) {
+        if (!QFileInfo::exists(filePath)) {
+            continue;
+        }
+
+        QSet<QString>& stillMissing = _missingPaths[directoryPath];
+        stillMissing.remove(filePath);
+
+        if (stillMissing.isEmpty()) {
+            _missingPaths.remove(directoryPath);
+            _watcher.removePath(directoryPath);
+        }
+
+        _watcher.addPath(filePath);
+        _pending.insert(filePath, _clock.elapsed() + FileChangedDelay);
+    }
+
+    schedule();
+}
+
+void FileWatchService::onReceiverDestroyed(QObject* receiver)
+{
+    unwatchAll(receiver);
+}
+
+void FileWatchService::dispatch()
+{
+    const qint64 now = _clock.elapsed();
+    QStringList duePaths;
+
+    for (auto it = _pending.begin(); it != _pending.end();) {
+        if (it.value() <= now) {
+            duePaths.append(it.key());
+            it = _pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const QString& filePath : duePaths) {
+        // The handlers may watch or unwatch paths, so they are called from a copy
+        const QHash<QObject*, Handler> receivers = _receivers.value(filePath);
+
+        for (auto it = receivers.constBegin(); it != receivers.constEnd(); ++it) {
+            if (isWatching(filePath, it.key())) {
+                it.value()(filePath);
+            }
+        }
+    }
+
+    schedule();
+}
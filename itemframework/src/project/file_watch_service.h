@@ -0,0 +1,87 @@
+#ifndef FILE_WATCH_SERVICE_H
+#define FILE_WATCH_SERVICE_H
+
+#include "appcore.h"
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <functional>
+
+/**
+ * @brief The FileWatchService class watches files for all projects and workspaces of the application with one
+ * QFileSystemWatcher, instead of one watcher (and inotify instance) per object.
+ *
+ * Every path can be watched by several receivers. The notifications of a path are coalesced: the receivers are
+ * called once the path had no notification for FileChangedDelay ms.
+ * Editors often save by writing a temporary file and renaming it over the watched file, which removes the file from
+ * the watcher. The service adds such paths again, and watches the directory of a path that is missing until
+ * it is created again.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT FileWatchService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(const QString&)>;
+
+    /**
+     * @return Returns the service of the application. It is created on first use and deleted with the application.
+     */
+    static FileWatchService* instance();
+
+    /**
+     * @brief Calls \a handler after \a filePath changed, was removed or created again, until unwatch() is called
+     * or \a receiver is destroyed. A receiver can watch a path only once, watching it again replaces the handler.
+     *
+     * @param filePath The watched filepath as string.
+     * @param receiver The object which receives the notifications.
+     * @param handler The function which is called with the changed path.
+     *
+     * \sa unwatch
+     */
+    void watch(const QString& filePath, QObject* receiver, const Handler& handler);
+
+    /**
+     * @brief Stops calling \a receiver for changes of \a filePath. The path is removed from the watcher
+     * when no receiver is left.
+     *
+     * \sa watch
+     */
+    void unwatch(const QString& filePath, QObject* receiver);
+
+    /**
+     * @brief Stops calling \a receiver for changes of all its paths.
+     */
+    void unwatchAll(QObject* receiver);
+
+    /**
+     * @return Returns \c true if \a receiver watches \a filePath, otherwise returns \c false.
+     */
+    bool isWatching(const QString& filePath, QObject* receiver) const;
+
+private:
+    explicit FileWatchService(QObject* parent);
+
+    void addToWatcher(const QString& filePath);
+    void schedule();
+
+    QFileSystemWatcher _watcher;
+    QTimer _dispatchTimer;
+    QElapsedTimer _clock;
+    QHash<QString, QHash<QObject*, Handler>> _receivers; // by path
+    QHash<QObject*, QSet<QString>> _paths; // by receiver, to unwatch them when it is destroyed
+    QHash<QString, qint64> _pending; // changed paths and when they are due, on _clock
+    QHash<QString, QSet<QString>> _missingPaths; // watched paths by their directory, while they don't exist
+
+private slots:
+    void onFileChanged(const QString& filePath);
+    void onDirectoryChanged(const QString& directoryPath);
+    void onReceiverDestroyed(QObject* receiver);
+    void dispatch();
+};
+
+#endif // FILE_WATCH_SERVICE_H
@@ -1,6 +1,7 @@
 #include "file_workspace.h"
 #include "project_manager_config.h"
 #include "file_project.h"
+#include "file_watch_service.h"
 
 FileWorkspace::FileWorkspace(): AbstractWorkspace(tr("File"))
 {
@@ -8,6 +9,11 @@ FileWorkspace::FileWorkspace(): AbstractWorkspace(tr("File"))
 
 FileWorkspace::~FileWorkspace()
 {
+    stopIndexRevalidation();
+
+    if (!_index.isNull()) {
+        saveIndex();
+    }
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -74,6 +80,12 @@ void FileWorkspace::initProjects()
     // Get first project dom node (xml -> TravizProject) of workspaceDomDocument
     QDomElement projectElement = rootElement.firstChildElement(ProDomElmTagPro);
 
+    // The index knows the headers of the project files, so they are not read while the workspace is opened
+    stopIndexRevalidation();
+    _index.reset(new FileWorkspaceIndex(_fileInfo.filePath()));
+    _index->load();
+    QStringList absProjectFiles;
+
     // For each project dom node in workspaceDomDocument
     while (!projectElement.isNull()) {
         // Analyze project xml structure of workspace dom document
@@ -128,9 +140,17 @@ void FileWorkspace::initProjects()
 
             const QString absProjectFile = FileHelper::relativeToAbsoluteFilePath(projectFilePath, _fileInfo.filePath());
 
-            // Create project dom document from xml project file (projectFilePath).
-            const QDomDocument projectDomDocument = FileHelper::domDocumentFromXMLFile(absProjectFile);
-            QSharedPointer<FileProject> project = QSharedPointer<FileProject>(new FileProject(settingsScope(), absProjectFile, projectDomDocument));
+            // Scan the header of the xml project file (projectFilePath), if it is not indexed yet.
+            if (!_index->contains(absProjectFile)) {
+                _index->insert(absProjectFile, FileWorkspaceIndex::scan(absProjectFile, false));
+            }
+
+            // Create project from the indexed header, the document is read on load.
+            const FileWorkspaceIndex::Entry indexEntry = _index->entry(absProjectFile);
+            QSharedPointer<FileProject> project = FileProject::createFileProjectFromHeader(settingsScope(), absProjectFile,
+                                                  FileWorkspaceIndex::headerDomDocument(indexEntry));
+            project->setThumbnail(indexEntry.thumbnail);
+            absProjectFiles.append(absProjectFile);
             project->setRelativFilePath(projectFilePath);
             // Set the fast load attribute.
             project->setFastLoad(fastLoad);
@@ -141,6 +161,87 @@ void FileWorkspace::initProjects()
         // Set next project dom node as current.
         projectElement = projectElement.nextSiblingElement(ProDomElmTagPro);
     }
+
+    _index->retain(absProjectFiles);
+    startIndexRevalidation();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Workspace index
+// ---------------------------------------------------------------------------------------------------------------------
+
+void FileWorkspace::startIndexRevalidation()
+{
+    _indexRevalidation = new FileWorkspaceIndexRevalidation(_index->entries(), this);
+    connect(_indexRevalidation, &QThread::finished, this, &FileWorkspace::onIndexRevalidated);
+    _indexRevalidation->start(QThread::LowPriority);
+}
+
+void FileWorkspace::stopIndexRevalidation()
+{
+    if (_indexRevalidation == nullptr) {
+        return;
+    }
+
+    _indexRevalidation->cancel();
+    _indexRevalidation->wait();
+    delete _indexRevalidation;
+    _indexRevalidation = nullptr;
+}
+
+void FileWorkspace::onIndexRevalidated()
+{
+    // A finished signal of a stopped revalidation can still be queued
+    if (_indexRevalidation == nullptr || !_indexRevalidation->isFinished()) {
+        return;
+    }
+
+    const QHash<QString, FileWorkspaceIndex::Entry> changedEntries = _indexRevalidation->changedEntries();
+    _indexRevalidation->deleteLater();
+    _indexRevalidation = nullptr;
+
+    QHash<QString, QSharedPointer<FileProject>> fileProjects;
+
+    for (const QSharedPointer<AbstractProject>& project : projects()) {
+        const QSharedPointer<FileProject> fileProject = qSharedPointerCast<FileProject>(project);
+        fileProjects.insert(fileProject->filePath(), fileProject);
+    }
+
+    for (auto it = changedEntries.constBegin(); it != changedEntries.constEnd(); ++it) {
+        _index->insert(it.key(), it.value());
+        const QSharedPointer<FileProject> fileProject = fileProjects.value(it.key());
+
+        if (!fileProject.isNull() && !fileProject->isLoaded()) {
+            fileProject->setHeaderDomDocument(FileWorkspaceIndex::headerDomDocument(it.value()));
+            fileProject->setThumbnail(it.value().thumbnail);
+        }
+    }
+
+    saveIndex();
+
+    if (!changedEntries.isEmpty()) {
+        emit workspaceUpdated();
+    }
+}
+
+void FileWorkspace::saveIndex()
+{
+    for (const QSharedPointer<AbstractProject>& project : projects()) {
+        const QSharedPointer<FileProject> fileProject = qSharedPointerCast<FileProject>(project);
+        const QImage thumbnail = fileProject->thumbnail();
+        FileWorkspaceIndex::Entry entry = _index->entry(fileProject->filePath());
+
+        if (thumbnail.isNull() || thumbnail.cacheKey() == entry.thumbnail.cacheKey()) {
+            continue;
+        }
+
+        // The thumbnail was taken when the project was saved, so the entry is updated to the saved file
+        FileWorkspaceIndex::revalidate(fileProject->filePath(), &entry);
+        entry.thumbnail = thumbnail;
+        _index->insert(fileProject->filePath(), entry);
+    }
+
+    _index->save();
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -238,6 +339,9 @@ bool FileWorkspace::save()
         }
 
         file.close();
+
+        // The notification about this save finds the same signature and is ignored
+        _fileSignature = FileHelper::fileSignature(_fileInfo.filePath());
     }
 
     return isSaved;
@@ -250,11 +354,17 @@ void FileWorkspace::setFilePath(const QString& filePath)
         return;
     }
 
+    if(isOpen()){
+        FileWatchService::instance()->unwatch(_fileInfo.filePath(), this);
+    }
+
     _fileInfo.setFile(filePath);
     setConnectionString(_fileInfo.filePath());
 
-    if(isOpen() && !_fileSystemWatcher.files().contains(_fileInfo.filePath())){
-        _fileSystemWatcher.addPath(_fileInfo.filePath());
+    if(isOpen()){
+        FileWatchService::instance()->watch(_fileInfo.filePath(), this, [this](const QString&) {
+            onWorkspaceFileChanged();
+        });
     }
 }
 
@@ -276,10 +386,17 @@ QString FileWorkspace::fileName() const
 void FileWorkspace::setOpen(bool isOpen)
 {
     if (isOpen) {
-        connect(&_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, &FileWorkspace::onWorkspaceFileChanged);
-        _fileSystemWatcher.addPath(_fileInfo.filePath());
+        FileWatchService::instance()->watch(_fileInfo.filePath(), this, [this](const QString&) {
+            onWorkspaceFileChanged();
+        });
+        _fileSignature = FileHelper::fileSignature(_fileInfo.filePath());
     } else {
-        _fileSystemWatcher.disconnect(this);
+        FileWatchService::instance()->unwatch(_fileInfo.filePath(), this);
+        stopIndexRevalidation();
+
+        if (!_index.isNull()) {
+            saveIndex();
+        }
     }
 
     AbstractWorkspace::setOpen(isOpen);
@@ -340,10 +457,24 @@ bool FileWorkspace::deleteWorkspace(bool deleteProjects)
 
 void FileWorkspace::onWorkspaceFileChanged()
 {
+    _fileInfo.refresh();
+
     if(!_fileInfo.exists() && !_editMode){
         // Workspace file was moved, this is just a simple solution.
         save();
+        return;
     }
 
-    _fileSystemWatcher.addPath(_fileInfo.filePath());
+    // Own saves and touches don't change the content, they are detected without parsing the file
+    if (!FileHelper::updateFileSignature(_fileInfo.filePath(), &_fileSignature)) {
+        return;
+    }
+
+    // Only the workspace properties are taken over, the projects stay as they are
+    const QDomDocument dom = FileHelper::domDocumentFromXMLFile(_fileInfo.filePath());
+
+    if (setWorkspaceProperties(dom)) {
+        setWorkspaceDomDocument(dom);
+        emit workspaceUpdated();
+    }
 }
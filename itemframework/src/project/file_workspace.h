@@ -1,9 +1,11 @@
 #ifndef FILE_WORKSPACE_H
 #define FILE_WORKSPACE_H
 
-#include <QFileSystemWatcher>
 #include <QFileInfo>
+#include <QScopedPointer>
 #include "abstract_workspace.h"
+#include "file_helper.h"
+#include "file_workspace_index.h"
 
 class FileWorkspace : public AbstractWorkspace
 {
@@ -34,13 +36,19 @@ private:
     void initProjects();
     void updateProjects();
     bool validateFileProperties();
+    void startIndexRevalidation();
+    void stopIndexRevalidation();
+    void saveIndex();
     bool _fileInfoChanged = false;
     bool _internalSave = false;
     bool _editMode = false;
     QFileInfo _fileInfo;
-    QFileSystemWatcher _fileSystemWatcher;
+    FileHelper::Signature _fileSignature; // of the last saved or checked file content
+    QScopedPointer<FileWorkspaceIndex> _index;
+    FileWorkspaceIndexRevalidation* _indexRevalidation = nullptr;
 
 private slots:
     void onWorkspaceFileChanged();
+    void onIndexRevalidated();
 };
 #endif // FILE_WORKSPACE_H
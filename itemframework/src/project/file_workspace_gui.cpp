@@ -416,10 +416,8 @@ void FileWorkspaceGui::showOpenProjectDialog()
         const QStringList projectFiles = fileProjectLoadDialog->selectedFiles();
 
         for (const QString projectPath : projectFiles) {
-            QDomDocument projectDomDocument = FileHelper::domDocumentFromXMLFile(projectPath);
             QSharedPointer<FileProject> fileProject = QSharedPointer<FileProject>(new FileProject(workspace()->settingsScope(),
-                    projectPath,
-                    projectDomDocument));
+                    projectPath));
 
             if (fileWorkspace->addProject(fileProject)) {
                 addProjectGui(QSharedPointer<ProjectGui>(new ProjectGui(this, fileProject)));
@@ -621,10 +619,8 @@ void FileWorkspaceGui::createProjectsFromImport(const QStringList &projectPaths,
 
         if(srcProjectFile.fileName() == dstProjectFile.fileName()){
             // Project is in correct folder and can be added.
-            QDomDocument projectDomDocument = FileHelper::domDocumentFromXMLFile(srcProjectFile.fileName());
             QSharedPointer<FileProject> fileProject = QSharedPointer<FileProject>(new FileProject(fileWorkspace->settingsScope(),
-                    srcProjectFile.fileName(),
-                    projectDomDocument));
+                    srcProjectFile.fileName()));
 
             if (fileWorkspace->addProject(fileProject)) {
                 addProjectGui(QSharedPointer<ProjectGui>(new ProjectGui(this, fileProject)));
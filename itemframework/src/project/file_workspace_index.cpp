@@ -0,0 +1,225 @@
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QXmlStreamReader>
+#include "file_workspace_index.h"
+#include "file_helper.h"
+#include "project_manager_config.h"
+
+static quint32 const IndexMagic = 0x49465749; // "IFWI"
+static quint16 const IndexVersion = 1;
+
+static QDataStream& operator<<(QDataStream& stream, const FileWorkspaceIndex::Entry& entry)
+{
+    return stream << entry.rootTag << entry.attributes << entry.size << entry.lastModified
+           << entry.contentHash << entry.thumbnail;
+}
+
+static QDataStream& operator>>(QDataStream& stream, FileWorkspaceIndex::Entry& entry)
+{
+    return stream >> entry.rootTag >> entry.attributes >> entry.size >> entry.lastModified
+           >> entry.contentHash >> entry.thumbnail;
+}
+
+FileWorkspaceIndex::FileWorkspaceIndex(const QString& workspaceFilePath)
+{
+    const QFileInfo workspaceFileInfo(workspaceFilePath);
+    _filePath = QString("%1/.%2.%3").arg(workspaceFileInfo.absolutePath()).arg(workspaceFileInfo.baseName()).arg(WspIndexFileExt);
+}
+
+QString FileWorkspaceIndex::filePath() const
+{
+    return _filePath;
+}
+
+bool FileWorkspaceIndex::load()
+{
+    _entries.clear();
+    QFile file(_filePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+
+    if (magic != IndexMagic || version != IndexVersion) {
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    stream >> entries;
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    _entries = entries;
+    return true;
+}
+
+bool FileWorkspaceIndex::save() const
+{
+    // Written to a temporary file and renamed, so a crash never leaves a truncated index
+    QSaveFile file(_filePath);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << IndexMagic << IndexVersion << _entries;
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool FileWorkspaceIndex::contains(const QString& projectFilePath) const
+{
+    return _entries.contains(projectFilePath);
+}
+
+FileWorkspaceIndex::Entry FileWorkspaceIndex::entry(const QString& projectFilePath) const
+{
+    return _entries.value(projectFilePath);
+}
+
+QHash<QString, FileWorkspaceIndex::Entry> FileWorkspaceIndex::entries() const
+{
+    return _entries;
+}
+
+void FileWorkspaceIndex::insert(const QString& projectFilePath, const Entry& entry)
+{
+    _entries.insert(projectFilePath, entry);
+}
+
+void FileWorkspaceIndex::retain(const QStringList& projectFilePaths)
+{
+    const QSet<QString> retained = projectFilePaths.toSet();
+
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (retained.contains(it.key())) {
+            ++it;
+        } else {
+            it = _entries.erase(it);
+        }
+    }
+}
+
+FileWorkspaceIndex::Entry FileWorkspaceIndex::scan(const QString& projectFilePath, bool hashContent)
+{
+    // FileHelper keeps its last error in a static, so only its threadsafe fileSignature() is used here
+    Entry entry;
+    const QFileInfo fileInfo(projectFilePath);
+
+    if (!fileInfo.exists()) {
+        return entry;
+    }
+
+    if (hashContent) {
+        const FileHelper::Signature signature = FileHelper::fileSignature(projectFilePath);
+        entry.size = signature.size;
+        entry.lastModified = signature.lastModified;
+        entry.contentHash = signature.contentHash;
+    } else {
+        entry.size = fileInfo.size();
+        entry.lastModified = fileInfo.lastModified();
+    }
+
+    QFile file(projectFilePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entry;
+    }
+
+    QXmlStreamReader reader(&file);
+
+    if (reader.readNextStartElement()) {
+        entry.rootTag = reader.qualifiedName().toString();
+
+        for (const QXmlStreamAttribute& attribute : reader.attributes()) {
+            entry.attributes.insert(attribute.qualifiedName().toString(), attribute.value().toString());
+        }
+    }
+
+    return entry;
+}
+
+bool FileWorkspaceIndex::revalidate(const QString& projectFilePath, Entry* entry)
+{
+    const QFileInfo fileInfo(projectFilePath);
+
+    if (!fileInfo.exists()) {
+        if (entry->size < 0) {
+            return false;
+        }
+
+        *entry = Entry();
+        return true;
+    }
+
+    if (fileInfo.size() == entry->size && fileInfo.lastModified() == entry->lastModified && !entry->contentHash.isEmpty()) {
+        return false;
+    }
+
+    Entry scanned = scan(projectFilePath, true);
+
+    // A touched file with the same content keeps its thumbnail
+    if (scanned.contentHash == entry->contentHash) {
+        scanned.thumbnail = entry->thumbnail;
+    }
+
+    *entry = scanned;
+    return true;
+}
+
+QDomDocument FileWorkspaceIndex::headerDomDocument(const Entry& entry)
+{
+    QDomDocument domDocument;
+
+    if (entry.rootTag.isEmpty()) {
+        return domDocument;
+    }
+
+    QDomElement rootElement = domDocument.createElement(entry.rootTag);
+
+    for (auto it = entry.attributes.constBegin(); it != entry.attributes.constEnd(); ++it) {
+        rootElement.setAttribute(it.key(), it.value());
+    }
+
+    domDocument.appendChild(rootElement);
+    return domDocument;
+}
+
+FileWorkspaceIndexRevalidation::FileWorkspaceIndexRevalidation(const QHash<QString, FileWorkspaceIndex::Entry>& entries,
+                                                               QObject* parent)
+    : QThread(parent), _entries(entries)
+{
+}
+
+QHash<QString, FileWorkspaceIndex::Entry> FileWorkspaceIndexRevalidation::changedEntries() const
+{
+    return _changedEntries;
+}
+
+void FileWorkspaceIndexRevalidation::cancel()
+{
+    _cancelled.storeRelease(1);
+}
+
+void FileWorkspaceIndexRevalidation::run()
+{
+    for (auto it = _entries.begin(); it != _entries.end() && _cancelled.loadAcquire() == 0; ++it) {
+        if (FileWorkspaceIndex::revalidate(it.key(), &it.value())) {
+            _changedEntries.insert(it.key(), it.value());
+        }
+    }
+}
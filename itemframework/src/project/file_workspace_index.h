@@ -0,0 +1,117 @@
+#ifndef FILE_WORKSPACE_INDEX_H
+#define FILE_WORKSPACE_INDEX_H
+
+#include "appcore.h"
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QDomDocument>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QStringList>
+#include <QThread>
+
+/**
+ * @brief The FileWorkspaceIndex class caches the metadata of the projects of a FileWorkspace in a sidecar file
+ * next to the workspace file (.<workspace>.twspidx).
+ *
+ * Every project file is stored with the attributes of its root element (name, version, description), its size,
+ * modification time, content hash and an optional thumbnail. Opening the workspace creates the projects from the
+ * index without touching their files; FileWorkspaceIndexRevalidation checks the entries in the background.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT FileWorkspaceIndex
+{
+public:
+    struct Entry {
+        QString rootTag;
+        QMap<QString, QString> attributes; // of the root element
+        qint64 size = -1; // -1 if the file does not exist
+        QDateTime lastModified;
+        QByteArray contentHash; // empty until the entry was revalidated
+        QImage thumbnail;
+    };
+
+    /**
+     * @param workspaceFilePath The workspace file, the index file is placed next to it.
+     */
+    explicit FileWorkspaceIndex(const QString& workspaceFilePath);
+
+    QString filePath() const;
+
+    /**
+     * @brief Reads the index file. A missing or outdated index file is no error, the index is empty then.
+     *
+     * @return Returns \c true if the index file was read, otherwise returns \c false.
+     */
+    bool load();
+
+    /**
+     * @return Returns \c true if the index file was written, otherwise returns \c false.
+     */
+    bool save() const;
+
+    bool contains(const QString& projectFilePath) const;
+    Entry entry(const QString& projectFilePath) const;
+    QHash<QString, Entry> entries() const;
+    void insert(const QString& projectFilePath, const Entry& entry);
+
+    /**
+     * @brief Removes the entries of all project files not contained in \a projectFilePaths.
+     */
+    void retain(const QStringList& projectFilePaths);
+
+    /**
+     * @brief Reads the root element and the modification time and size of a project file. This function is threadsafe.
+     *
+     * @param projectFilePath The project filepath as string.
+     * @param hashContent Also hash the file content, which reads the complete file.
+     */
+    static Entry scan(const QString& projectFilePath, bool hashContent);
+
+    /**
+     * @brief Checks an entry against its project file and scans the file again if it changed. This function is threadsafe.
+     *
+     * @return Returns \c true if the entry was changed, otherwise returns \c false.
+     */
+    static bool revalidate(const QString& projectFilePath, Entry* entry);
+
+    /**
+     * @return Returns a DomDocument which only contains the root element of the entry (see FileProject).
+     */
+    static QDomDocument headerDomDocument(const Entry& entry);
+
+private:
+    QString _filePath;
+    QHash<QString, Entry> _entries; // by absolute project filepath
+};
+
+/**
+ * @brief The FileWorkspaceIndexRevalidation class revalidates index entries in its own thread.
+ * Once the thread finished, changedEntries() returns the entries which are outdated in the index.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT FileWorkspaceIndexRevalidation : public QThread
+{
+public:
+    FileWorkspaceIndexRevalidation(const QHash<QString, FileWorkspaceIndex::Entry>& entries, QObject* parent);
+
+    /**
+     * @return The changed entries, by project filepath. Only valid after the thread finished.
+     */
+    QHash<QString, FileWorkspaceIndex::Entry> changedEntries() const;
+
+    /**
+     * @brief Stops the revalidation after the current entry.
+     */
+    void cancel();
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QHash<QString, FileWorkspaceIndex::Entry> _entries;
+    QHash<QString, FileWorkspaceIndex::Entry> _changedEntries;
+    QAtomicInt _cancelled;
+};
+
+#endif // FILE_WORKSPACE_INDEX_H
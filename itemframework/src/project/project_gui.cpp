@@ -12,6 +12,9 @@
 #include "ui_project_info_dialog.h"
 #include <QTimer>
 #include <QInputDialog>
+#include <QPainter>
+
+#define EXTERN_CHANGES_SHOWN 20 // [changed items listed in the extern changed dialog]
 
 ProjectGui::ProjectGui(AbstractWorkspaceGui* parent, QSharedPointer<AbstractProject> project)
 {
@@ -187,11 +190,20 @@ bool ProjectGui::save(bool autosave)
 
 
         if (_project->setDomDocument(projectDomDocumentTemplate)) {
+            // The scene keeps the hashes of its items up to date, so the saved items don't have to be hashed again
+            _project->setItemsHash(_itemView->itemScene()->contentHash());
+
             if (autosave) {
                 return _project->autosave();
-            } else {
-                return _project->save();
             }
+
+            if (!_project->save()) {
+                return false;
+            }
+
+            // Kept in the workspace index, so the preview doesn't need to load the project
+            _project->setThumbnail(thumbnail());
+            return true;
         }
     }
 
@@ -200,6 +212,7 @@ bool ProjectGui::save(bool autosave)
 
 bool ProjectGui::load()
 {
+    // Reads the complete project document, the workspace only scanned its header
     reset();
 
     if (!isValid()) {
@@ -367,6 +380,12 @@ bool ProjectGui::reloadDomDocument()
         return false;
     }
 
+    // Only rebuild the scene if the items differ, e.g. not if just the project settings were changed
+    if (_project->itemsHash() == _itemView->itemScene()->contentHash()) {
+        _project->setDirty(false);
+        return true;
+    }
+
     QDomElement projectDomElement = _project->domDocument().documentElement();
     QDomDocument testProjectDomDocument;
     QString errorSetDomDocument;
@@ -383,6 +402,31 @@ bool ProjectGui::reloadDomDocument()
     return true;
 }
 
+QImage ProjectGui::thumbnail() const
+{
+    ItemScene* scene = _itemView->itemScene();
+    const QByteArray hash = scene->contentHash().root();
+
+    // Saving unchanged items keeps the last thumbnail
+    if (!_thumbnail.isNull() && hash == _thumbnailHash) {
+        return _thumbnail;
+    }
+
+    const QRectF sourceRect = scene->contentBounds(); // maintained by the scene, no walk over all items
+    QImage image(ProThumbnailSize, ProThumbnailSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    if (!sourceRect.isEmpty()) {
+        // Larger scenes are scaled below the detail thresholds of the items, which then only fill their boxes
+        QPainter painter(&image);
+        scene->render(&painter, image.rect(), sourceRect);
+    }
+
+    _thumbnail = image;
+    _thumbnailHash = hash;
+    return image;
+}
+
 void ProjectGui::showProjectChangedByExternalDialog()
 {
     if (!_project->isExternChanged()) {
@@ -393,7 +437,18 @@ void ProjectGui::showProjectChangedByExternalDialog()
                          .arg(_project->name());
     _domChanged = false;
     _projectChangedExternDialog->setText(dialogText);
-    _projectChangedExternDialog->setDetails(_project->connectionString());
+    QString details = _project->connectionString();
+    const QStringList externChanges = _project->externChanges();
+
+    if (!externChanges.isEmpty()) {
+        details += tr("\n\nChanged:\n%1").arg(externChanges.mid(0, EXTERN_CHANGES_SHOWN).join("\n"));
+
+        if (externChanges.size() > EXTERN_CHANGES_SHOWN) {
+            details += tr("\n... and %1 more").arg(externChanges.size() - EXTERN_CHANGES_SHOWN);
+        }
+    }
+
+    _projectChangedExternDialog->setDetails(details);
 
     if (_projectChangedExternDialog->exec() == QDialog::Accepted) {
         switch (_projectChangedExternDialog->projectChangedAction()) {
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QPoint>
+#include <QImage>
 #include <QDialog>
 #include <QPointer>
 #include <QEnableSharedFromThis>
@@ -51,6 +52,7 @@ private:
     int _autosaveTimerInterval;
     bool saveReminder();
     void showProjectChangedByExternalDialog();
+    QImage thumbnail() const;
     ProjectChangedExternDialog* _projectChangedExternDialog = nullptr;
     AbstractWorkspaceGui* _parent = nullptr;
     QSharedPointer<AbstractProject> _project;
@@ -65,6 +67,8 @@ private:
     QString _lastError;
     QPoint _dialogPositionOffset;
     QPointer<QDialog> _projectInfoDialog;
+    mutable QImage _thumbnail; // of the items with the content hash _thumbnailHash
+    mutable QByteArray _thumbnailHash;
 
 signals:
     void projectGuiLabelChanged(QSharedPointer<ProjectGui> projectGui);
@@ -0,0 +1,230 @@
+#include <QCryptographicHash>
+#include "project_hash.h"
+#include "item/item_serializer.h"
+
+#include <algorithm>
+
+static const char* const ProjectKey = "project";
+static const QCryptographicHash::Algorithm HashAlgorithm = QCryptographicHash::Md5;
+
+static void addString(QCryptographicHash& hash, const QString& string)
+{
+    hash.addData(string.toUtf8());
+    hash.addData("\0", 1); // separator, so "ab" + "c" differs from "a" + "bc"
+}
+
+ProjectHash::ProjectHash()
+{
+}
+
+ProjectHash::ProjectHash(const QDomElement& projectElement, const Filter& filter)
+{
+    insertChildren(projectElement, filter);
+
+    // The project element itself only contributes its attributes, e.g. name and description
+    QDomElement attributes = projectElement.cloneNode(false).toElement();
+    insert(ProjectKey, hashElement(attributes));
+}
+
+void ProjectHash::insertChildren(const QDomElement& parent, const Filter& filter)
+{
+    const QHash<qint32, QString> names = itemNames(parent);
+    QMap<QString, QList<QByteArray>> groups;
+
+    for (QDomElement element = parent.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (filter && !filter(element)) {
+            continue;
+        }
+
+        const QPair<QString, QByteArray> leaf = ProjectHash::leaf(element, names);
+        groups[leaf.first].append(leaf.second);
+    }
+
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        insert(it.key(), groupLeaf(it.value()));
+    }
+}
+
+void ProjectHash::insert(const QString& key, const QByteArray& leaf)
+{
+    _leaves.insert(key, leaf);
+    _root.clear();
+}
+
+void ProjectHash::insert(const ProjectHash& other)
+{
+    for (auto it = other._leaves.constBegin(); it != other._leaves.constEnd(); ++it) {
+        _leaves.insert(it.key(), it.value());
+    }
+
+    _root.clear();
+}
+
+void ProjectHash::remove(const QString& key)
+{
+    if (_leaves.remove(key) > 0) {
+        _root.clear();
+    }
+}
+
+QByteArray ProjectHash::root() const
+{
+    if (_root.isNull()) {
+        QCryptographicHash hash(HashAlgorithm);
+
+        for (auto it = _leaves.constBegin(); it != _leaves.constEnd(); ++it) {
+            addString(hash, it.key());
+            hash.addData(it.value());
+        }
+
+        _root = hash.result();
+    }
+
+    return _root;
+}
+
+QStringList ProjectHash::differences(const ProjectHash& other) const
+{
+    QStringList keys;
+
+    if (root() == other.root()) {
+        return keys;
+    }
+
+    // Both maps are ordered by key, so they are merged in one pass
+    auto a = _leaves.constBegin();
+    auto b = other._leaves.constBegin();
+
+    while (a != _leaves.constEnd() || b != other._leaves.constEnd()) {
+        if (b == other._leaves.constEnd() || (a != _leaves.constEnd() && a.key() < b.key())) {
+            keys.append(a.key());
+            ++a;
+        } else if (a == _leaves.constEnd() || b.key() < a.key()) {
+            keys.append(b.key());
+            ++b;
+        } else {
+            if (a.value() != b.value()) {
+                keys.append(a.key());
+            }
+
+            ++a;
+            ++b;
+        }
+    }
+
+    return keys;
+}
+
+bool ProjectHash::operator==(const ProjectHash& other) const
+{
+    return root() == other.root();
+}
+
+bool ProjectHash::operator!=(const ProjectHash& other) const
+{
+    return !operator==(other);
+}
+
+bool ProjectHash::isItemContent(const QDomElement& element)
+{
+    return ItemSerializer::isItemElement(element) ||
+           ItemSerializer::isConnectorElement(element) ||
+           ItemSerializer::isNoteElement(element);
+}
+
+QPair<QString, QByteArray> ProjectHash::leaf(const QDomElement& element, const QHash<qint32, QString>& itemNames)
+{
+    static const QStringList positionalAttributes = ItemSerializer::positionalAttributes();
+    QString key;
+
+    if (ItemSerializer::isItemElement(element)) {
+        key = itemKey(ItemSerializer::itemName(element));
+    } else if (ItemSerializer::isConnectorElement(element)) {
+        const QPair<qint32, qint32> items = ItemSerializer::connectorItemIds(element);
+        const QPair<qint32, qint32> ports = ItemSerializer::connectorPortIndexes(element);
+        key = connectorKey(itemNames.value(items.first), ports.first, itemNames.value(items.second), ports.second);
+    } else if (ItemSerializer::isNoteElement(element)) {
+        key = noteKey(ItemSerializer::itemPosition(element));
+    } else {
+        key = element.tagName();
+    }
+
+    return qMakePair(key, hashElement(element, positionalAttributes));
+}
+
+QByteArray ProjectHash::groupLeaf(QList<QByteArray> leaves)
+{
+    if (leaves.size() == 1) {
+        return leaves.first();
+    }
+
+    std::sort(leaves.begin(), leaves.end());
+    QCryptographicHash hash(HashAlgorithm);
+
+    for (const QByteArray& leaf : leaves) {
+        hash.addData(leaf);
+    }
+
+    return hash.result();
+}
+
+QHash<qint32, QString> ProjectHash::itemNames(const QDomElement& parent)
+{
+    QHash<qint32, QString> names;
+
+    for (QDomElement element = parent.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (ItemSerializer::isItemElement(element)) {
+            names.insert(ItemSerializer::itemId(element), ItemSerializer::itemName(element));
+        }
+    }
+
+    return names;
+}
+
+QString ProjectHash::itemKey(const QString& name)
+{
+    return QString("item %1").arg(name);
+}
+
+QString ProjectHash::noteKey(const QPointF& position)
+{
+    return QString("note %1,%2").arg(position.x()).arg(position.y());
+}
+
+QString ProjectHash::connectorKey(const QString& fromItem, int output, const QString& toItem, int input)
+{
+    return QString("connector %1.%2 -> %3.%4").arg(fromItem).arg(output).arg(toItem).arg(input);
+}
+
+QByteArray ProjectHash::hashElement(const QDomElement& element, const QStringList& ignoredAttributes)
+{
+    QCryptographicHash hash(HashAlgorithm);
+    addString(hash, element.tagName());
+
+    // The attribute order of a DOM is not defined, so they are sorted by name
+    const QDomNamedNodeMap attributes = element.attributes();
+    QMap<QString, QString> sortedAttributes;
+
+    for (int i = 0; i < attributes.count(); i++) {
+        const QDomAttr attribute = attributes.item(i).toAttr();
+
+        if (!ignoredAttributes.contains(attribute.name())) {
+            sortedAttributes.insert(attribute.name(), attribute.value());
+        }
+    }
+
+    for (auto it = sortedAttributes.constBegin(); it != sortedAttributes.constEnd(); ++it) {
+        addString(hash, it.key());
+        addString(hash, it.value());
+    }
+
+    for (QDomNode child = element.firstChild(); !child.isNull(); child = child.nextSibling()) {
+        if (child.isElement()) {
+            hash.addData(hashElement(child.toElement()));
+        } else if (child.isText()) { // text and CDATA
+            addString(hash, child.nodeValue());
+        }
+    }
+
+    return hash.result();
+}
@@ -0,0 +1,108 @@
+#ifndef PROJECT_HASH_H
+#define PROJECT_HASH_H
+
+#include "appcore.h"
+
+#include <QByteArray>
+#include <QDomElement>
+#include <QHash>
+#include <QMap>
+#include <QPointF>
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief The ProjectHash class is a structural hash of the content of a project.
+ *
+ * Every item, connector, note and other child element of the project element is a leaf of the hash. A leaf is
+ * identified by a key (e.g. the item name) and hashes the element together with all its attributes and children
+ * (type, name, position, data, settings). Attributes which only refer to the position of an element in the file
+ * (the item ids) are left out, so the same content hashes equally, no matter in which order it was saved.
+ * Elements with the same key (e.g. items with the same name) share one leaf, see groupLeaf().
+ * The root hash combines all leaves. It is cached and only recalculated after a leaf changed.
+ *
+ * Leaves can be replaced one by one, e.g. by ItemScene when an item changed. Comparing two hashes
+ * only compares their leaves and can report the keys of the differing leaves.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT ProjectHash
+{
+public:
+    using Filter = std::function<bool(const QDomElement&)>;
+
+    /**
+     * @brief Constructs an empty hash
+     */
+    ProjectHash();
+
+    /**
+     * @brief Constructs the hash of the project element \a projectElement: its attributes and all children
+     * accepted by \a filter (all if no filter is given).
+     */
+    explicit ProjectHash(const QDomElement& projectElement, const Filter& filter = Filter());
+
+    /**
+     * @brief Adds a leaf for every child element of \a parent accepted by \a filter (all if no filter is given).
+     * Children with the same key are added as one leaf, see groupLeaf().
+     */
+    void insertChildren(const QDomElement& parent, const Filter& filter = Filter());
+
+    void insert(const QString& key, const QByteArray& leaf);
+
+    /**
+     * @brief Adds or replaces the leaves of \a other
+     */
+    void insert(const ProjectHash& other);
+
+    void remove(const QString& key);
+
+    /**
+     * @return The root hash over all leaves
+     */
+    QByteArray root() const;
+
+    /**
+     * @return The keys of all leaves which differ or only exist in one of the hashes
+     */
+    QStringList differences(const ProjectHash& other) const;
+
+    bool operator==(const ProjectHash& other) const;
+    bool operator!=(const ProjectHash& other) const;
+
+    /**
+     * @return true for the elements of items, connectors and notes
+     */
+    static bool isItemContent(const QDomElement& element);
+
+    /**
+     * @brief Calculates the key and the leaf hash of a child element of \a parent
+     * @param element The item, connector, note or other element
+     * @param itemNames The item names by item id, to identify the items of a connector (see itemNames())
+     */
+    static QPair<QString, QByteArray> leaf(const QDomElement& element, const QHash<qint32, QString>& itemNames);
+
+    /**
+     * @brief Combines the leaves of all elements with the same key into one leaf. A single leaf is returned unchanged.
+     * Several leaves are sorted first, so the result does not depend on the order of the elements.
+     */
+    static QByteArray groupLeaf(QList<QByteArray> leaves);
+
+    /**
+     * @return The names of all item elements below \a parent, by their id
+     */
+    static QHash<qint32, QString> itemNames(const QDomElement& parent);
+
+    static QString itemKey(const QString& name);
+    static QString noteKey(const QPointF& position);
+    static QString connectorKey(const QString& fromItem, int output, const QString& toItem, int input);
+
+    /**
+     * @brief Hashes \a element with its attributes except \a ignoredAttributes, its text and the hashes of its children
+     */
+    static QByteArray hashElement(const QDomElement& element, const QStringList& ignoredAttributes = QStringList());
+
+private:
+    QMap<QString, QByteArray> _leaves; // ordered, so the root does not depend on the insertion order
+    mutable QByteArray _root;
+};
+
+#endif // PROJECT_HASH_H
@@ -18,6 +18,9 @@
 // Autosave in ms ( 10 seconds)
 #define AutosaveInerval  10 * 1000
 
+// Delay in ms until a burst of file changed notifications (e.g. from editors or sync tools) is handled
+#define FileChangedDelay  300
+
 // Helpers
 #define Dot  "."
 #define Slash  "/"
@@ -43,6 +46,10 @@
 #define WspFileExt  "twsp"
 #define ProFileExt  "tpro"
 #define ProFileAutosaveExt  "swp"
+#define WspIndexFileExt  "twspidx"
+
+// Size of the project thumbnails in px (see FileWorkspaceIndex)
+#define ProThumbnailSize  128
 
 // File validations
 #define WspFileRegExp  QStringLiteral("[A-Za-z_0-9]+[.](") + WspFileExt + QStringLiteral(")$")
@@ -74,6 +81,11 @@
 #define ProDomElmNameAttLabel  "name"
 #define ProDomElmVersionAttLabel  "version"
 #define ProDomElmDescriptionAttLabel  "description"
+#define ProDomElmTagSettingsScope  "SettingsScope"
+
+// Sql workspace definitions
+#define SqlWspDefaultDriver  "QSQLITE"
+#define SqlWspSchemaVersion  1
 
 // Project GUI item data definition label
 #define itemViewWidgetPropertyLabel  "ProjectGui"
@@ -0,0 +1,214 @@
+#include "sql_project.h"
+#include "project_manager_config.h"
+
+SqlProject::SqlProject(SettingsScope* parentSettingsScope,
+                       const QSharedPointer<SqlProjectStore>& store,
+                       const SqlProjectStore::ProjectRow& projectRow)
+    : AbstractProject(parentSettingsScope), _store(store), _id(projectRow.id)
+{
+    bool projectIsValid = true;
+
+    if (!setDomDocument(projectDomDocumentTemplate(projectRow.name, projectRow.version, projectRow.description))) {
+        projectIsValid = false;
+    }
+
+    if (!init()) {
+        projectIsValid = false;
+    }
+
+    setFastLoad(projectRow.isFastLoad);
+    setValid(projectIsValid);
+
+    // The element rows are read when the document is needed
+    _isHeaderOnly = _id >= 0;
+}
+
+SqlProject::~SqlProject()
+{
+}
+
+qint64 SqlProject::id() const
+{
+    return _id;
+}
+
+SqlProjectStore::ProjectRow SqlProject::projectRow() const
+{
+    SqlProjectStore::ProjectRow projectRow;
+    projectRow.id = _id;
+    projectRow.name = name();
+    projectRow.version = version();
+    projectRow.description = description();
+    projectRow.isFastLoad = isFastLoad();
+    return projectRow;
+}
+
+bool SqlProject::autosaveExists()
+{
+    return _id >= 0 && !_store->readAutosaveDomDocument(_id).isNull();
+}
+
+void SqlProject::cleanAutosave()
+{
+    if (_id >= 0) {
+        _store->writeAutosaveDomDocument(_id, QDomDocument());
+    }
+}
+
+QString SqlProject::autosaveInfo()
+{
+    if (autosaveExists()) {
+        return QString("Found an autosaved state of project \"%1\" in database \"%2\".")
+               .arg(name())
+               .arg(_store->database().databaseName());
+    }
+
+    return QString("No autosaved state found.");
+}
+
+bool SqlProject::save()
+{
+    QDomElement projectRootDomElement = domDocument().documentElement(); // reads the rows if only the header is known
+
+    if (_isHeaderOnly) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    // Saved again below, a project saved twice would have its settings twice otherwise
+    projectRootDomElement.removeChild(projectRootDomElement.firstChildElement(ProDomElmTagSettingsScope));
+
+    if (!settingsScope()->save(_domDocument, projectRootDomElement)) {
+        return false;
+    }
+
+    SqlProjectStore::ProjectRow row = projectRow();
+
+    if (!_store->writeProjectDomDocument(&row, _domDocument)) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    _id = row.id;
+    cleanAutosave();
+    setExternChanged(false);
+    setDirty(false);
+    return true;
+}
+
+bool SqlProject::autosave()
+{
+    // A project is autosaved to its row, so it needs one
+    if (_id < 0) {
+        return false;
+    }
+
+    QDomElement projectRootDomElement = domDocument().documentElement(); // reads the rows if only the header is known
+
+    if (_isHeaderOnly) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    projectRootDomElement.removeChild(projectRootDomElement.firstChildElement(ProDomElmTagSettingsScope));
+
+    if (!settingsScope()->save(_domDocument, projectRootDomElement)) {
+        return false;
+    }
+
+    if (!_store->writeAutosaveDomDocument(_id, _domDocument)) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    return true;
+}
+
+void SqlProject::reset()
+{
+    setDirty(false);
+    setExternChanged(false);
+
+    const QDomDocument projectDomDocument = _store->readProjectDomDocument(_id);
+
+    if (projectDomDocument.isNull()) {
+        setLastError(_store->lastError());
+        setValid(false);
+        return;
+    }
+
+    setValid(setDomDocument(projectDomDocument));
+}
+
+QString SqlProject::connectionString()
+{
+    return QString("%1#%2").arg(SqlProjectStore::connectionString(_store->database())).arg(_id);
+}
+
+void SqlProject::setLoaded(bool isLoaded)
+{
+    if (!isLoaded) {
+        cleanAutosave();
+
+        // Closed projects don't need their document, unless it has unsaved changes
+        if (!isDirty() && isValid()) {
+            dropDomDocument();
+        }
+    }
+
+    AbstractProject::setLoaded(isLoaded);
+}
+
+QDomDocument SqlProject::autosaveDomDocument() const
+{
+    if (_id < 0) {
+        return QDomDocument();
+    }
+
+    return _store->readAutosaveDomDocument(_id);
+}
+
+QDomDocument SqlProject::domDocument() const
+{
+    if (_isHeaderOnly) {
+        const QDomDocument projectDomDocument = _store->readProjectDomDocument(_id);
+
+        // If the rows can't be read, the header is kept, so the project is never saved without its content
+        if (!projectDomDocument.isNull()) {
+            _domDocument = projectDomDocument;
+            _isHeaderOnly = false;
+        }
+    }
+
+    return _domDocument;
+}
+
+void SqlProject::dropDomDocument()
+{
+    if (_id < 0) {
+        return;
+    }
+
+    // Keep the root element for the project attributes, the rest is read again when it is needed
+    QDomDocument header;
+    header.appendChild(header.importNode(_domDocument.documentElement(), false));
+    _domDocument = header;
+    _isHeaderOnly = true;
+    invalidateContentHash();
+}
+
+bool SqlProject::setDomDocument(const QDomDocument& projectDomDocument)
+{
+    _domDocument = projectDomDocument;
+    _isHeaderOnly = false;
+    invalidateContentHash();
+
+    if (!validateProjectDomDocument(_domDocument)) {
+        return false;
+    }
+
+    setName(_domDocument.documentElement().attribute(ProDomElmNameAttLabel));
+    setVersion(_domDocument.documentElement().attribute(ProDomElmVersionAttLabel));
+    setDescription(_domDocument.documentElement().attribute(ProDomElmDescriptionAttLabel));
+    return true;
+}
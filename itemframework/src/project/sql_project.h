@@ -0,0 +1,51 @@
+#ifndef SQL_PROJECT_H
+#define SQL_PROJECT_H
+
+#include <QSharedPointer>
+#include "abstract_project.h"
+#include "sql_project_store.h"
+
+/**
+ * @brief The SqlProject class is a project of a SqlWorkspace. It is created from its project row, the items,
+ * connectors, notes and settings are read from their rows when the document is needed (e.g. on load).
+ * Saving only writes the rows which changed since they were read or saved (see SqlProjectStore).
+ */
+class SqlProject : public AbstractProject
+{
+public:
+    SqlProject(SettingsScope* parentSettingsScope,
+               const QSharedPointer<SqlProjectStore>& store,
+               const SqlProjectStore::ProjectRow& projectRow);
+    ~SqlProject();
+
+    bool autosaveExists() override;
+    void cleanAutosave() override;
+    QString autosaveInfo() override;
+    bool save() override;
+    bool autosave() override;
+    void reset() override;
+    QString connectionString() override;
+    void setLoaded(bool isLoaded) override;
+    QDomDocument autosaveDomDocument() const override;
+    QDomDocument domDocument() const override;
+    bool setDomDocument(const QDomDocument& domDocument) override;
+
+    /**
+     * @return Returns the id of the project row, or -1 if the project was not written yet.
+     */
+    qint64 id() const;
+
+    /**
+     * @return Returns the project row with the current project properties.
+     */
+    SqlProjectStore::ProjectRow projectRow() const;
+
+private:
+    void dropDomDocument();
+    QSharedPointer<SqlProjectStore> _store;
+    qint64 _id = -1;
+    mutable QDomDocument _domDocument;
+    mutable bool _isHeaderOnly = false; // _domDocument only contains the root element
+};
+
+#endif // SQL_PROJECT_H
@@ -0,0 +1,679 @@
+#include <QCryptographicHash>
+#include <QSqlError>
+#include <QSet>
+#include <QTextStream>
+#include "sql_project_store.h"
+#include "abstract_project.h"
+#include "project_hash.h"
+#include "project_manager_config.h"
+#include "helper/dom_helper.h"
+#include "item/item_serializer.h"
+
+// The rows of a project are assembled in this order, the items have to be known before their connectors
+enum ElementKind {
+    ItemElement = 0,
+    NoteElement = 1,
+    ConnectorElement = 2,
+    SettingElement = 3,
+    OtherElement = 4
+};
+
+struct ElementRow {
+    int kind = OtherElement;
+    QString key;
+    int position = 0; // in the project document, the rows are read in this order
+    QString itemType;
+    QString itemName;
+    QString fromItem; // the key of the item row
+    QString toItem; // the key of the item row
+    QString xml;
+    QByteArray hash;
+};
+
+static QString elementXml(const QDomElement& element)
+{
+    QString xml;
+    QTextStream stream(&xml);
+    element.save(stream, -1);
+    return xml;
+}
+
+// Elements with the same key (e.g. items with the same name) are numbered in document order
+static void insertRow(QHash<QString, ElementRow>* rows, const QString& key, const ElementRow& row)
+{
+    QString uniqueKey = key;
+
+    for (int i = 2; rows->contains(uniqueKey); i++) {
+        uniqueKey = QString("%1 #%2").arg(key).arg(i);
+    }
+
+    rows->insert(uniqueKey, row);
+}
+
+// The row keys of the items by item id, so connectors refer to one item, even if several items have its name
+static QHash<qint32, QString> itemKeys(const QDomElement& projectElement)
+{
+    QHash<qint32, QString> keys;
+    QHash<QString, int> counts; // by item name
+
+    for (QDomElement element = projectElement.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (ItemSerializer::isItemElement(element)) {
+            const QString key = ProjectHash::itemKey(ItemSerializer::itemName(element));
+            const int count = ++counts[key];
+            keys.insert(ItemSerializer::itemId(element), count == 1 ? key : QString("%1 #%2").arg(key).arg(count));
+        }
+    }
+
+    return keys;
+}
+
+static QHash<QString, ElementRow> elementRows(const QDomElement& projectElement)
+{
+    static const QStringList positionalAttributes = ItemSerializer::positionalAttributes();
+    const QHash<qint32, QString> itemNames = ProjectHash::itemNames(projectElement);
+    const QHash<qint32, QString> keys = itemKeys(projectElement);
+    QHash<QString, ElementRow> rows;
+    int position = 0;
+
+    for (QDomElement element = projectElement.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        // Every setting is a row of its own, so changing one setting does not write the others
+        if (element.tagName() == ProDomElmTagSettingsScope) {
+            for (QDomElement setting = element.firstChildElement(); !setting.isNull(); setting = setting.nextSiblingElement()) {
+                ElementRow row;
+                row.kind = SettingElement;
+                row.position = position++;
+                row.xml = elementXml(setting);
+                row.hash = ProjectHash::hashElement(setting);
+                insertRow(&rows, QString("setting %1").arg(setting.attribute(DomHelper::NameTag)), row);
+            }
+
+            continue;
+        }
+
+        const QPair<QString, QByteArray> leaf = ProjectHash::leaf(element, itemNames);
+        QString key = leaf.first;
+        ElementRow row;
+        row.position = position++;
+        row.hash = leaf.second;
+
+        if (ItemSerializer::isItemElement(element)) {
+            row.kind = ItemElement;
+            row.itemType = ItemSerializer::itemType(element);
+            row.itemName = ItemSerializer::itemName(element);
+            key = keys.value(ItemSerializer::itemId(element));
+        } else if (ItemSerializer::isConnectorElement(element)) {
+            const QPair<qint32, qint32> items = ItemSerializer::connectorItemIds(element);
+            row.kind = ConnectorElement;
+            row.fromItem = keys.value(items.first);
+            row.toItem = keys.value(items.second);
+
+            // The item keys are part of the row, so it is written again when its items are numbered differently
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            hash.addData(leaf.second);
+            hash.addData(row.fromItem.toUtf8());
+            hash.addData("\n", 1);
+            hash.addData(row.toItem.toUtf8());
+            row.hash = hash.result();
+        } else if (ItemSerializer::isNoteElement(element)) {
+            row.kind = NoteElement;
+        }
+
+        // The ids only refer to the position of the items in the document, they are assigned again on read
+        QDomElement storedElement = element.cloneNode(true).toElement();
+
+        for (const QString& attribute : positionalAttributes) {
+            storedElement.removeAttribute(attribute);
+        }
+
+        row.xml = elementXml(storedElement);
+        insertRow(&rows, key, row);
+    }
+
+    return rows;
+}
+
+SqlProjectStore::SqlProjectStore(const SqlDatabase& database) : _database(database)
+{
+}
+
+SqlDatabase SqlProjectStore::database() const
+{
+    return _database;
+}
+
+QString SqlProjectStore::lastError() const
+{
+    return _lastError;
+}
+
+bool SqlProjectStore::exec(SqlQuery& query)
+{
+    if (!query.exec()) {
+        _lastError = query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool SqlProjectStore::exec(const QString& statement)
+{
+    SqlQuery query(_database);
+
+    if (!query.exec(statement)) {
+        _lastError = query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool SqlProjectStore::rollback()
+{
+    _database.rollback();
+    return false;
+}
+
+bool SqlProjectStore::open()
+{
+    if (!_database.isOpen() && !_database.open()) {
+        _lastError = _database.lastError().text();
+        return false;
+    }
+
+    _lastError.clear();
+    return createSchema();
+}
+
+bool SqlProjectStore::createSchema()
+{
+    // Checked by table, "IF NOT EXISTS" is not supported for indexes by every database
+    const QStringList tables = _database.tables();
+
+    if (!tables.contains("workspace") &&
+            !exec("CREATE TABLE workspace (id INTEGER PRIMARY KEY, schema_version INTEGER NOT NULL, "
+                  "name TEXT NOT NULL, version TEXT NOT NULL, description TEXT, settings TEXT)")) {
+        return false;
+    }
+
+    if (!tables.contains("project") &&
+            !exec("CREATE TABLE project (id INTEGER PRIMARY KEY, position INTEGER NOT NULL DEFAULT 0, "
+                  "name TEXT NOT NULL, version TEXT NOT NULL, description TEXT, "
+                  "fast_load INTEGER NOT NULL DEFAULT 0, autosave TEXT)")) {
+        return false;
+    }
+
+    if (!tables.contains("project_element")) {
+        if (!exec("CREATE TABLE project_element (project_id INTEGER NOT NULL REFERENCES project (id), "
+                  "element_key TEXT NOT NULL, position INTEGER NOT NULL, kind INTEGER NOT NULL, item_type TEXT, item_name TEXT, "
+                  "from_item TEXT, to_item TEXT, xml TEXT NOT NULL, hash BLOB NOT NULL, "
+                  "PRIMARY KEY (project_id, element_key))")) {
+            return false;
+        }
+
+        // For the queries over all projects, e.g. projectIdsUsingItemType()
+        if (!exec("CREATE INDEX project_element_item_type ON project_element (item_type)")) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SqlProjectStore::hasWorkspace()
+{
+    SqlQuery query(_database);
+    query.prepare("SELECT id FROM workspace WHERE id = 1");
+    return exec(query) && query.next();
+}
+
+bool SqlProjectStore::readWorkspace(WorkspaceRow* workspace)
+{
+    SqlQuery query(_database);
+    query.prepare("SELECT name, version, description, settings FROM workspace WHERE id = 1");
+
+    if (!exec(query)) {
+        return false;
+    }
+
+    if (!query.next()) {
+        _lastError = QString("The database contains no workspace.");
+        return false;
+    }
+
+    workspace->name = query.value(0).toString();
+    workspace->version = query.value(1).toString();
+    workspace->description = query.value(2).toString();
+    workspace->settings = query.value(3).toString();
+    return true;
+}
+
+QVector<SqlProjectStore::ProjectRow> SqlProjectStore::readProjects()
+{
+    QVector<ProjectRow> projects;
+    SqlQuery query(_database);
+    query.prepare("SELECT id, name, version, description, fast_load FROM project ORDER BY position, id");
+
+    if (!exec(query)) {
+        return projects;
+    }
+
+    while (query.next()) {
+        ProjectRow project;
+        project.id = query.value(0).toLongLong();
+        project.name = query.value(1).toString();
+        project.version = query.value(2).toString();
+        project.description = query.value(3).toString();
+        project.isFastLoad = query.value(4).toBool();
+        projects.append(project);
+    }
+
+    return projects;
+}
+
+bool SqlProjectStore::writeProjectRow(ProjectRow* project)
+{
+    SqlQuery query(_database);
+
+    if (project->id < 0) {
+        query.prepare("INSERT INTO project (name, version, description, fast_load) VALUES (?, ?, ?, ?)");
+    } else {
+        query.prepare("UPDATE project SET name = ?, version = ?, description = ?, fast_load = ? WHERE id = ?");
+    }
+
+    query.addBindValue(project->name);
+    query.addBindValue(project->version);
+    query.addBindValue(project->description);
+    query.addBindValue(project->isFastLoad ? 1 : 0);
+
+    if (project->id >= 0) {
+        query.addBindValue(project->id);
+    }
+
+    if (!exec(query)) {
+        return false;
+    }
+
+    if (project->id < 0) {
+        project->id = query.lastInsertId().toLongLong();
+    }
+
+    return true;
+}
+
+bool SqlProjectStore::deleteProjectRows(qint64 projectId)
+{
+    // Deleted explicitly, not every database enforces the foreign key
+    SqlQuery elements(_database);
+    elements.prepare("DELETE FROM project_element WHERE project_id = ?");
+    elements.addBindValue(projectId);
+
+    if (!exec(elements)) {
+        return false;
+    }
+
+    SqlQuery project(_database);
+    project.prepare("DELETE FROM project WHERE id = ?");
+    project.addBindValue(projectId);
+    return exec(project);
+}
+
+bool SqlProjectStore::writeWorkspace(const WorkspaceRow& workspace, QVector<ProjectRow>* projects)
+{
+    if (!_database.transaction()) {
+        _lastError = _database.lastError().text();
+        return false;
+    }
+
+    SqlQuery update(_database);
+    update.prepare("UPDATE workspace SET schema_version = ?, name = ?, version = ?, description = ?, settings = ? WHERE id = 1");
+    update.addBindValue(SqlWspSchemaVersion);
+    update.addBindValue(workspace.name);
+    update.addBindValue(workspace.version);
+    update.addBindValue(workspace.description);
+    update.addBindValue(workspace.settings);
+
+    if (!exec(update)) {
+        return rollback();
+    }
+
+    if (update.numRowsAffected() == 0) {
+        SqlQuery insert(_database);
+        insert.prepare("INSERT INTO workspace (id, schema_version, name, version, description, settings) VALUES (1, ?, ?, ?, ?, ?)");
+        insert.addBindValue(SqlWspSchemaVersion);
+        insert.addBindValue(workspace.name);
+        insert.addBindValue(workspace.version);
+        insert.addBindValue(workspace.description);
+        insert.addBindValue(workspace.settings);
+
+        if (!exec(insert)) {
+            return rollback();
+        }
+    }
+
+    QSet<qint64> projectIds;
+    SqlQuery position(_database);
+    position.prepare("UPDATE project SET position = ? WHERE id = ?");
+
+    for (int i = 0; i < projects->count(); i++) {
+        ProjectRow& project = (*projects)[i];
+
+        if (!writeProjectRow(&project)) {
+            return rollback();
+        }
+
+        position.bindValue(0, i);
+        position.bindValue(1, project.id);
+
+        if (!exec(position)) {
+            return rollback();
+        }
+
+        projectIds.insert(project.id);
+    }
+
+    // The projects which were removed from the workspace
+    SqlQuery select(_database);
+    select.prepare("SELECT id FROM project");
+
+    if (!exec(select)) {
+        return rollback();
+    }
+
+    QList<qint64> removedProjectIds;
+
+    while (select.next()) {
+        const qint64 projectId = select.value(0).toLongLong();
+
+        if (!projectIds.contains(projectId)) {
+            removedProjectIds.append(projectId);
+        }
+    }
+
+    for (qint64 projectId : removedProjectIds) {
+        if (!deleteProjectRows(projectId)) {
+            return rollback();
+        }
+    }
+
+    if (!_database.commit()) {
+        _lastError = _database.lastError().text();
+        return rollback();
+    }
+
+    return true;
+}
+
+bool SqlProjectStore::deleteWorkspace(bool deleteProjects)
+{
+    if (!_database.transaction()) {
+        _lastError = _database.lastError().text();
+        return false;
+    }
+
+    if (deleteProjects && (!exec("DELETE FROM project_element") || !exec("DELETE FROM project"))) {
+        return rollback();
+    }
+
+    if (!exec("DELETE FROM workspace")) {
+        return rollback();
+    }
+
+    if (!_database.commit()) {
+        _lastError = _database.lastError().text();
+        return rollback();
+    }
+
+    return true;
+}
+
+QDomDocument SqlProjectStore::readProjectDomDocument(qint64 projectId)
+{
+    SqlQuery project(_database);
+    project.prepare("SELECT name, version, description FROM project WHERE id = ?");
+    project.addBindValue(projectId);
+
+    if (!exec(project)) {
+        return QDomDocument();
+    }
+
+    if (!project.next()) {
+        _lastError = QString("Project %1 does not exist.").arg(projectId);
+        return QDomDocument();
+    }
+
+    QDomDocument projectDomDocument = AbstractProject::projectDomDocumentTemplate(project.value(0).toString(),
+                                      project.value(1).toString(),
+                                      project.value(2).toString());
+    QDomElement projectElement = projectDomDocument.documentElement();
+
+    SqlQuery elements(_database);
+    elements.setForwardOnly(true);
+    elements.prepare("SELECT kind, element_key, from_item, to_item, xml FROM project_element "
+                     "WHERE project_id = ? ORDER BY kind, position");
+    elements.addBindValue(projectId);
+
+    if (!exec(elements)) {
+        return QDomDocument();
+    }
+
+    // All rows are parsed at once, instead of one document per row
+    QVector<ElementRow> rows;
+    QString xml("<rows>");
+
+    while (elements.next()) {
+        ElementRow row;
+        row.kind = elements.value(0).toInt();
+        row.key = elements.value(1).toString();
+        row.fromItem = elements.value(2).toString();
+        row.toItem = elements.value(3).toString();
+        xml.append(elements.value(4).toString());
+        rows.append(row);
+    }
+
+    xml.append("</rows>");
+    QDomDocument rowsDomDocument;
+    QString errorMessage;
+
+    if (!rowsDomDocument.setContent(xml, &errorMessage)) {
+        _lastError = QString("Project %1 has invalid rows: %2").arg(projectId).arg(errorMessage);
+        return QDomDocument();
+    }
+
+    QHash<QString, qint32> itemIds;
+    QDomElement settingsScopeElement;
+    QDomElement rowElement = rowsDomDocument.documentElement().firstChildElement();
+
+    for (const ElementRow& row : rows) {
+        if (rowElement.isNull()) {
+            break;
+        }
+
+        QDomElement element = projectDomDocument.importNode(rowElement, true).toElement();
+        rowElement = rowElement.nextSiblingElement();
+
+        switch (row.kind) {
+        case ItemElement:
+            itemIds.insert(row.key, itemIds.count());
+            ItemSerializer::setItemId(element, itemIds.value(row.key));
+            break;
+
+        case ConnectorElement:
+            ItemSerializer::setConnectorItemIds(element, itemIds.value(row.fromItem, -1), itemIds.value(row.toItem, -1));
+            break;
+
+        case SettingElement:
+            if (settingsScopeElement.isNull()) {
+                settingsScopeElement = projectDomDocument.createElement(ProDomElmTagSettingsScope);
+                projectElement.appendChild(settingsScopeElement);
+            }
+
+            settingsScopeElement.appendChild(element);
+            continue;
+        }
+
+        projectElement.appendChild(element);
+    }
+
+    return projectDomDocument;
+}
+
+bool SqlProjectStore::writeProjectDomDocument(ProjectRow* project, const QDomDocument& projectDomDocument)
+{
+    const QHash<QString, ElementRow> rows = elementRows(projectDomDocument.documentElement());
+
+    if (!_database.transaction()) {
+        _lastError = _database.lastError().text();
+        return false;
+    }
+
+    if (!writeProjectRow(project)) {
+        return rollback();
+    }
+
+    QHash<QString, ElementRow> storedRows; // only the hash and the position
+    SqlQuery select(_database);
+    select.setForwardOnly(true);
+    select.prepare("SELECT element_key, hash, position FROM project_element WHERE project_id = ?");
+    select.addBindValue(project->id);
+
+    if (!exec(select)) {
+        return rollback();
+    }
+
+    while (select.next()) {
+        ElementRow storedRow;
+        storedRow.hash = select.value(1).toByteArray();
+        storedRow.position = select.value(2).toInt();
+        storedRows.insert(select.value(0).toString(), storedRow);
+    }
+
+    SqlQuery insert(_database);
+    insert.prepare("INSERT INTO project_element (kind, item_type, item_name, from_item, to_item, xml, hash, position, project_id, "
+                   "element_key) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    SqlQuery update(_database);
+    update.prepare("UPDATE project_element SET kind = ?, item_type = ?, item_name = ?, from_item = ?, to_item = ?, xml = ?, hash = ?, "
+                   "position = ? WHERE project_id = ? AND element_key = ?");
+    SqlQuery move(_database);
+    move.prepare("UPDATE project_element SET position = ? WHERE project_id = ? AND element_key = ?");
+
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        const ElementRow& row = it.value();
+        auto storedRow = storedRows.find(it.key());
+        SqlQuery* query = &insert;
+
+        if (storedRow != storedRows.end()) {
+            const bool isChanged = storedRow->hash != row.hash;
+            const bool isMoved = storedRow->position != row.position;
+            storedRows.erase(storedRow);
+
+            if (!isChanged) {
+                // An element inserted or removed before this one only moves it, the content is not written again
+                if (isMoved) {
+                    move.bindValue(0, row.position);
+                    move.bindValue(1, project->id);
+                    move.bindValue(2, it.key());
+
+                    if (!exec(move)) {
+                        return rollback();
+                    }
+                }
+
+                continue;
+            }
+
+            query = &update;
+        }
+
+        query->bindValue(0, row.kind);
+        query->bindValue(1, row.itemType);
+        query->bindValue(2, row.itemName);
+        query->bindValue(3, row.fromItem);
+        query->bindValue(4, row.toItem);
+        query->bindValue(5, row.xml);
+        query->bindValue(6, row.hash);
+        query->bindValue(7, row.position);
+        query->bindValue(8, project->id);
+        query->bindValue(9, it.key());
+
+        if (!exec(*query)) {
+            return rollback();
+        }
+    }
+
+    // The remaining stored rows are no longer part of the project
+    SqlQuery remove(_database);
+    remove.prepare("DELETE FROM project_element WHERE project_id = ? AND element_key = ?");
+
+    for (auto it = storedRows.constBegin(); it != storedRows.constEnd(); ++it) {
+        remove.bindValue(0, project->id);
+        remove.bindValue(1, it.key());
+
+        if (!exec(remove)) {
+            return rollback();
+        }
+    }
+
+    if (!_database.commit()) {
+        _lastError = _database.lastError().text();
+        return rollback();
+    }
+
+    return true;
+}
+
+QDomDocument SqlProjectStore::readAutosaveDomDocument(qint64 projectId)
+{
+    QDomDocument autosaveDomDocument;
+    SqlQuery query(_database);
+    query.prepare("SELECT autosave FROM project WHERE id = ?");
+    query.addBindValue(projectId);
+
+    if (!exec(query) || !query.next() || query.isNull(0)) {
+        return autosaveDomDocument;
+    }
+
+    if (!autosaveDomDocument.setContent(query.value(0).toString())) {
+        return QDomDocument();
+    }
+
+    return autosaveDomDocument;
+}
+
+bool SqlProjectStore::writeAutosaveDomDocument(qint64 projectId, const QDomDocument& autosaveDomDocument)
+{
+    SqlQuery query(_database);
+    query.prepare("UPDATE project SET autosave = ? WHERE id = ?");
+    query.addBindValue(autosaveDomDocument.isNull() ? QVariant(QVariant::String) : QVariant(autosaveDomDocument.toString(-1)));
+    query.addBindValue(projectId);
+    return exec(query);
+}
+
+QList<qint64> SqlProjectStore::projectIdsUsingItemType(const QString& itemType)
+{
+    QList<qint64> projectIds;
+    SqlQuery query(_database);
+    query.prepare("SELECT DISTINCT project_id FROM project_element WHERE kind = ? AND item_type = ?");
+    query.addBindValue(int(ItemElement));
+    query.addBindValue(itemType);
+
+    if (!exec(query)) {
+        return projectIds;
+    }
+
+    while (query.next()) {
+        projectIds.append(query.value(0).toLongLong());
+    }
+
+    return projectIds;
+}
+
+QString SqlProjectStore::connectionString(const SqlDatabase& database)
+{
+    return QString("%1://%2@%3:%4/%5")
+           .arg(database.driverName())
+           .arg(database.userName())
+           .arg(database.hostName())
+           .arg(database.port())
+           .arg(database.databaseName());
+}
@@ -0,0 +1,112 @@
+#ifndef SQL_PROJECT_STORE_H
+#define SQL_PROJECT_STORE_H
+
+#include "appcore.h"
+
+#include <QDomDocument>
+#include <QVector>
+#include "helper/sql_database.h"
+
+/**
+ * @brief The SqlProjectStore class maps the workspace and its projects to the rows of a sql database (see SqlWorkspace).
+ *
+ * Every project has a row with its attributes. The items, connectors, notes and settings of a project are stored in
+ * one row each, keyed like the leaves of ProjectHash and holding the leaf hash. Saving a project compares the hashes
+ * and only writes the rows which changed, in one transaction. Item ids are positional and not stored, connectors
+ * refer to the keys of their item rows (items with the same name are numbered) and get the ids assigned again when
+ * the project document is assembled. Every row keeps its position in the document, the rows are read in this order.
+ * A row which only moved (e.g. an element before it was removed) only gets its position written.
+ *
+ * The statements are plain sql, the store is tested with the QSQLITE driver.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT SqlProjectStore
+{
+public:
+    struct ProjectRow {
+        qint64 id = -1; // -1 until the project was inserted
+        QString name;
+        QString version;
+        QString description;
+        bool isFastLoad = false;
+    };
+
+    struct WorkspaceRow {
+        QString name;
+        QString version;
+        QString description;
+        QString settings; // the xml of the workspace settings scope
+    };
+
+    explicit SqlProjectStore(const SqlDatabase& database);
+
+    SqlDatabase database() const;
+    QString lastError() const;
+
+    /**
+     * @brief Opens the database and creates the tables, if they don't exist yet.
+     *
+     * @return Returns \c true if the database can be used, otherwise returns \c false.
+     */
+    bool open();
+
+    /**
+     * @return Returns \c true if the database contains a workspace, otherwise returns \c false.
+     */
+    bool hasWorkspace();
+
+    bool readWorkspace(WorkspaceRow* workspace);
+    QVector<ProjectRow> readProjects();
+
+    /**
+     * @brief Writes the workspace row and the rows of \a projects in one transaction. Projects without id are
+     * inserted and get their id, the rows of all projects not contained in \a projects are deleted.
+     */
+    bool writeWorkspace(const WorkspaceRow& workspace, QVector<ProjectRow>* projects);
+
+    /**
+     * @brief Deletes the workspace row, and the rows of all projects if \a deleteProjects is set.
+     */
+    bool deleteWorkspace(bool deleteProjects);
+
+    /**
+     * @brief Assembles the project document from the project row and its element rows.
+     *
+     * @return Returns the project document, or a null document if the project does not exist.
+     */
+    QDomDocument readProjectDomDocument(qint64 projectId);
+
+    /**
+     * @brief Writes the project row and the element rows which differ from the rows in the database, in one transaction.
+     * A project without id is inserted and gets its id.
+     */
+    bool writeProjectDomDocument(ProjectRow* project, const QDomDocument& projectDomDocument);
+
+    /**
+     * @return Returns the autosaved project document, or a null document if there is none.
+     */
+    QDomDocument readAutosaveDomDocument(qint64 projectId);
+    bool writeAutosaveDomDocument(qint64 projectId, const QDomDocument& autosaveDomDocument);
+
+    /**
+     * @return Returns the ids of all projects which contain an item of type \a itemType.
+     */
+    QList<qint64> projectIdsUsingItemType(const QString& itemType);
+
+    /**
+     * @return Returns a string which identifies the database, e.g. "QSQLITE://user@host:0/workspace.db".
+     */
+    static QString connectionString(const SqlDatabase& database);
+
+private:
+    bool exec(SqlQuery& query);
+    bool exec(const QString& statement);
+    bool createSchema();
+    bool writeProjectRow(ProjectRow* project);
+    bool deleteProjectRows(qint64 projectId);
+    bool rollback();
+
+    SqlDatabase _database;
+    QString _lastError;
+};
+
+#endif // SQL_PROJECT_STORE_H
@@ -1,7 +1,12 @@
 #include "sql_workspace.h"
+#include "sql_project.h"
+#include "project_manager_config.h"
 #include <QDebug>
+#include <QFileInfo>
+#include <QSet>
+#include <QTextStream>
 
-SqlWorkspace::SqlWorkspace(): AbstractWorkspace(QLatin1Literal("Sql"))
+SqlWorkspace::SqlWorkspace(): AbstractWorkspace(QLatin1Literal("Sql")), _driver(SqlWspDefaultDriver)
 {
 }
 
@@ -9,43 +14,261 @@ SqlWorkspace::~SqlWorkspace()
 {
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Workspace database
+// ---------------------------------------------------------------------------------------------------------------------
+
+bool SqlWorkspace::openDatabase()
+{
+    SqlDatabase sqlDatabase(_driver);
+    sqlDatabase.setDatabaseName(_database);
+    sqlDatabase.setHostName(_host);
+    sqlDatabase.setPort(_port);
+    sqlDatabase.setUserName(_user);
+    sqlDatabase.setPassword(_password);
+
+    const QString connection = SqlProjectStore::connectionString(sqlDatabase);
+
+    // The projects share the store, it is only replaced if the workspace was moved to another database
+    if (_store.isNull() || connectionString() != connection) {
+        _store = QSharedPointer<SqlProjectStore>(new SqlProjectStore(sqlDatabase));
+        setConnectionString(connection);
+    }
+
+    if (_database.isEmpty() || !_store->open()) {
+        setLastError(_database.isEmpty() ? QString("No database is set.") : _store->lastError());
+        return false;
+    }
+
+    clearLastError();
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Workspace init
+// ---------------------------------------------------------------------------------------------------------------------
+
 void SqlWorkspace::init()
 {
+    if (!openDatabase()) {
+        setValid(false);
+
+        if (!_database.isEmpty() && name().isEmpty()) {
+            setName(QFileInfo(_database).baseName());
+        }
+
+        return;
+    }
+
+    initProjectList();
+
+    // A new database gets a workspace, projects which are already in the database are kept
+    if (!_store->hasWorkspace()) {
+        if (name().isEmpty()) {
+            setName(QFileInfo(_database).baseName());
+        }
+
+        if (version().isEmpty()) {
+            setVersion(FileWspVersion);
+        }
+
+        if (!save()) {
+            setValid(false);
+            return;
+        }
+    }
+
+    SqlProjectStore::WorkspaceRow workspaceRow;
+
+    if (!_store->readWorkspace(&workspaceRow)) {
+        setLastError(_store->lastError());
+        setValid(false);
+        return;
+    }
+
+    QDomDocument dom = workspaceDomDocumentTemplate(workspaceRow.name, workspaceRow.version, workspaceRow.description);
+    QDomDocument settingsDom;
 
+    if (settingsDom.setContent(workspaceRow.settings)) {
+        dom.documentElement().appendChild(dom.importNode(settingsDom.documentElement(), true));
+    }
+
+    if (!setWorkspaceProperties(dom)) {
+        setValid(false);
+        return;
+    }
+
+    setWorkspaceDomDocument(dom);
+    setValid(true);
+    emit workspaceUpdated();
 }
 
+void SqlWorkspace::initProjectList()
+{
+    QVector<QSharedPointer<AbstractProject>> sqlProjects;
+
+    // Only the project rows are read, the items of a project are read when it is loaded
+    for (const SqlProjectStore::ProjectRow& projectRow : _store->readProjects()) {
+        sqlProjects.append(QSharedPointer<AbstractProject>(new SqlProject(settingsScope(), _store, projectRow)));
+    }
+
+    setProjects(sqlProjects);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Workspace update
+// ---------------------------------------------------------------------------------------------------------------------
+
 void SqlWorkspace::update()
 {
+    const QString previousConnection = connectionString();
+    setValid(openDatabase());
 
+    if (isValid() && connectionString() != previousConnection) {
+        initProjectList();
+    }
+
+    emit workspaceUpdated();
+}
+
+bool SqlWorkspace::test()
+{
+    update();
+    return isValid();
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//
+// ---------------------------------------------------------------------------------------------------------------------
+
 bool SqlWorkspace::save()
 {
+    if (_store.isNull()) {
+        setLastError(QString("The workspace database is not open."));
+        return false;
+    }
+
+    QDomDocument workspaceDomDocument = workspaceDomDocumentTemplate(name(), version(), description());
+    QDomElement rootDomElement = workspaceDomDocument.documentElement();
+
+    if (!settingsScope()->save(workspaceDomDocument, rootDomElement)) {
+        setLastError("Failed to save setting scope");
+        return false;
+    }
+
+    SqlProjectStore::WorkspaceRow workspaceRow;
+    workspaceRow.name = name();
+    workspaceRow.version = version();
+    workspaceRow.description = description();
+
+    if (rootDomElement.hasChildNodes()) {
+        QTextStream stream(&workspaceRow.settings);
+        rootDomElement.firstChildElement().save(stream, -1);
+    }
+
+    QVector<SqlProjectStore::ProjectRow> projectRows;
+
+    for (const QSharedPointer<AbstractProject>& project : projects()) {
+        projectRows.append(qSharedPointerCast<SqlProject>(project)->projectRow());
+    }
+
+    if (!_store->writeWorkspace(workspaceRow, &projectRows)) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    clearLastError();
     return true;
 }
 
-bool SqlWorkspace::test()
+QSharedPointer<SqlProject> SqlWorkspace::createProject(const QDomDocument& projectDomDocument)
 {
-    return true;
+    if (_store.isNull()) {
+        setLastError(QString("The workspace database is not open."));
+        return QSharedPointer<SqlProject>();
+    }
+
+    const QDomElement projectElement = projectDomDocument.documentElement();
+    SqlProjectStore::ProjectRow projectRow;
+    projectRow.name = projectElement.attribute(ProDomElmNameAttLabel);
+    projectRow.version = projectElement.attribute(ProDomElmVersionAttLabel);
+    projectRow.description = projectElement.attribute(ProDomElmDescriptionAttLabel);
+
+    QSharedPointer<SqlProject> sqlProject(new SqlProject(settingsScope(), _store, projectRow));
+
+    // Saving inserts the project row, the workspace then keeps its position
+    if (!sqlProject->setDomDocument(projectDomDocument) || !sqlProject->save()) {
+        setLastError(sqlProject->lastError());
+        return QSharedPointer<SqlProject>();
+    }
+
+    addProject(sqlProject);
+    return sqlProject;
+}
+
+QVector<QSharedPointer<AbstractProject>> SqlWorkspace::projectsUsingItemType(const QString& itemType) const
+{
+    QVector<QSharedPointer<AbstractProject>> projectsUsingItemType;
+
+    if (_store.isNull()) {
+        return projectsUsingItemType;
+    }
+
+    const QSet<qint64> projectIds = _store->projectIdsUsingItemType(itemType).toSet();
+
+    for (const QSharedPointer<AbstractProject>& project : projects()) {
+        if (projectIds.contains(qSharedPointerCast<SqlProject>(project)->id())) {
+            projectsUsingItemType.append(project);
+        }
+    }
+
+    return projectsUsingItemType;
 }
 
 bool SqlWorkspace::deleteProject(const QSharedPointer<AbstractProject>& project)
 {
-    Q_UNUSED(project);
-    return true;
+    // The rows of projects which are no longer part of the workspace are deleted on save
+    return removeProject(project);
 }
 
 bool SqlWorkspace::deleteWorkspace(bool deleteProjects)
 {
-    Q_UNUSED(deleteProjects);
+    if (_store.isNull()) {
+        setLastError(QString("The workspace database is not open."));
+        return false;
+    }
+
+    if (!_store->deleteWorkspace(deleteProjects)) {
+        setLastError(_store->lastError());
+        return false;
+    }
+
+    clearLastError();
     return true;
 }
 
-
 bool SqlWorkspace::compare(const QSharedPointer<AbstractWorkspace>& workspace) const
 {
-    Q_UNUSED(workspace);
-    return true;
+    const SqlWorkspace* otherSqlWorkspace = qobject_cast<const SqlWorkspace*>(workspace.data());
+
+    if (otherSqlWorkspace == nullptr) {
+        return false;
+    }
+
+    return _driver == otherSqlWorkspace->driver() &&
+           _host == otherSqlWorkspace->host() &&
+           _port == otherSqlWorkspace->port() &&
+           _database == otherSqlWorkspace->database();
+}
+
+QString SqlWorkspace::driver() const
+{
+    return _driver;
+}
+
+void SqlWorkspace::setDriver(const QString& driver)
+{
+    _driver = driver;
 }
 
 int SqlWorkspace::port() const
@@ -107,8 +330,3 @@ void SqlWorkspace::setSourceInformation(const QString& sourceInformation)
 {
     _sourceInformation = sourceInformation;
 }
-
-void SqlWorkspace::initProjectList()
-{
-
-}
@@ -1,11 +1,24 @@
 #ifndef SQL_WORKSPACE_H
 #define SQL_WORKSPACE_H
 
+#include <QSharedPointer>
 #include "abstract_workspace.h"
+#include "sql_project_store.h"
 
+class SqlProject;
+
+/**
+ * @brief The SqlWorkspace class keeps a workspace and its projects in a sql database instead of files.
+ * The projects are stored as rows (see SqlProjectStore), so they can be queried without loading them.
+ *
+ * The database is given by the driver (QSQLITE by default) and the usual connection properties. For QSQLITE only
+ * the database (the filepath of the database file) is needed, the file is created on init.
+ * The projects live in the database, removing a project from the workspace deletes its rows on save.
+ */
 class SqlWorkspace : public AbstractWorkspace
 {
     Q_OBJECT
+    Q_PROPERTY(QString driver READ driver WRITE setDriver USER true)
     Q_PROPERTY(int port READ port WRITE setPort USER true)
     Q_PROPERTY(QString user READ user WRITE setUser USER true)
     Q_PROPERTY(QString password READ password WRITE setPassword USER true)
@@ -24,6 +37,22 @@ public:
     bool deleteProject(const QSharedPointer<AbstractProject>& project) Q_DECL_OVERRIDE;
     bool deleteWorkspace(bool deleteProjects = false) Q_DECL_OVERRIDE;
 
+    /**
+     * @brief Creates a project from \a projectDomDocument (e.g. an imported project file), writes its rows
+     * and adds it to the workspace.
+     *
+     * @return Returns the new project, or a null pointer if the project could not be written.
+     */
+    QSharedPointer<SqlProject> createProject(const QDomDocument& projectDomDocument);
+
+    /**
+     * @return Returns all projects of the workspace which contain an item of type \a itemType,
+     * without loading any project.
+     */
+    QVector<QSharedPointer<AbstractProject>> projectsUsingItemType(const QString& itemType) const;
+
+    QString driver() const;
+    void setDriver(const QString& driver);
     int port() const;
     void setPort(int port);
     QString user() const;
@@ -38,12 +67,15 @@ public:
     void setSourceInformation(const QString& sourceInformation);
 
 private:
-    int _port;
+    bool openDatabase();
+    void initProjectList();
+    QString _driver;
+    int _port = -1;
     QString _user;
     QString _password;
     QString _host;
     QString _database;
     QString _sourceInformation;
-    void initProjectList();
+    QSharedPointer<SqlProjectStore> _store;
 };
 #endif // SQL_WORKSPACE_H
@@ -1,4 +1,5 @@
 #include "resource.h"
+#include "theme.h"
 #include <QPen>
 
 bool Resource::b_init = false;
@@ -31,3 +32,8 @@ void Resource::init()
     map_res.insert("project_active_fgcolor", QColor(Qt::black));
     map_res.insert("project_inactive_fgcolor", QColor(Qt::darkGray));
 }
+
+void Resource::changed()
+{
+    Theme::reload();
+}
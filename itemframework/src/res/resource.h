@@ -3,6 +3,7 @@
 
 #include <QVariant>
 #include <QDebug>
+#include <QStringList>
 
 namespace core
 {
@@ -13,6 +14,8 @@ namespace core
  * It allows values of any type to be stored at keys identified by strings.
  *
  * It is currently used to define all style properties in one central place.
+ * Paint code does not query it directly, but reads the resolved Theme, which is
+ * reloaded whenever a value is set.
  *
  * When requesting the value stored at a certain key, the type of the value needs
  * to be specified by the caller. This is done either by supplying some value
@@ -67,12 +70,24 @@ public:
         }
 
         map_res.insert(key, variant);
+        changed();
 
         return overwritten;
     }
 
+    /**
+     * @return All keys which have a value stored
+     */
+    static QStringList keys()
+    {
+        init();
+
+        return map_res.keys();
+    }
+
 private:
     static void init();
+    static void changed();
 
     static bool b_init;
     static QMap<QString, QVariant> map_res;
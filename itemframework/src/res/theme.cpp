@@ -0,0 +1,66 @@
+#include "theme.h"
+#include "resource.h"
+
+#include <QAtomicPointer>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+static char const* const ConnectorPenPrefix = "item_connector_pen";
+
+static QAtomicPointer<Theme const> currentTheme;
+static QMutex reloadMutex;
+static QList<QSharedPointer<Theme const>> snapshots; // all snapshots ever published, freed when the application exits
+
+Theme::Theme() :
+    itemBoxBackground(Resource::get("item_box_bgcolor", QColor(0xF5, 0xF5, 0xF5))),
+    itemBoxBorder(Resource::get("item_box_bordercolor", QColor(Qt::gray))),
+    itemBoxProgress(Resource::get("item_box_progresscolor", QColor(Qt::green))),
+    itemBoxSelectedPen(Resource::get("item_box_selected_pen", QPen(Qt::black, 1, Qt::DashLine))),
+    itemNoteBackground(Resource::get("item_note_bgcolor", QColor(249, 238, 122))),
+    connectorSelpointColor(Resource::get("item_connector_selpoint_color", QColor(Qt::black))),
+    connectorInactiveBrush(Resource::get("item_connector_inactive", QBrush(Qt::white, Qt::BDiagPattern)))
+{
+    QString const prefix(ConnectorPenPrefix);
+
+    for (QString const& key : Resource::keys()) {
+        bool ok = false;
+        int const transportType = key.startsWith(prefix) ? key.mid(prefix.length()).toInt(&ok) : 0;
+
+        if (ok) {
+            _connectorPens.insert(transportType, Resource::get<QPen>(key));
+        }
+    }
+}
+
+Theme const& Theme::current()
+{
+    Theme const* theme = currentTheme.loadAcquire();
+
+    if (theme == nullptr) {
+        QMutexLocker locker(&reloadMutex);
+        theme = currentTheme.loadAcquire();
+
+        if (theme == nullptr) {
+            snapshots.append(QSharedPointer<Theme const>(new Theme()));
+            theme = snapshots.last().data();
+            currentTheme.storeRelease(theme);
+        }
+    }
+
+    return *theme;
+}
+
+void Theme::reload()
+{
+    // Readers may still hold a reference to the current snapshot, it stays in the snapshots.
+    // Its address is never reused, so it also identifies the theme for caches (see AbstractItem).
+    QMutexLocker locker(&reloadMutex);
+    currentTheme.storeRelease(nullptr);
+}
+
+QPen Theme::connectorPen(int transportType, QPen const& defaultPen) const
+{
+    return _connectorPens.value(transportType, defaultPen);
+}
@@ -0,0 +1,63 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include "appcore.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QHash>
+#include <QPen>
+
+namespace core
+{
+
+/**
+ * @brief The Theme class is a typed, immutable snapshot of the style values of the Resource store.
+ *
+ * Paint code reads its colors and pens from Theme::current() instead of looking them up in the Resource store
+ * by string key on every frame. The snapshot is resolved once and replaced whenever a style value is changed
+ * with Resource::set(). A snapshot is never modified after it was published, so it can be read from any thread,
+ * e.g. by workers which render thumbnails.
+ */
+class ITEMFRAMEWORK_TEST_EXPORT Theme
+{
+public:
+    /**
+     * @return The current snapshot. The reference stays valid until the application exits.
+     */
+    static Theme const& current();
+
+    /**
+     * @brief Retires the current snapshot, the next call of current() resolves a new one. Called by Resource::set().
+     * Several values set in a row therefore create only one snapshot. Retired snapshots are kept alive until
+     * the application exits, because readers may still hold a reference to them.
+     */
+    static void reload();
+
+    /**
+     * @param transportType The transport type whose connector pen is requested
+     * @param defaultPen The pen returned if no style was registered for \a transportType
+     * @return The connector pen registered for \a transportType
+     */
+    QPen connectorPen(int transportType, QPen const& defaultPen) const;
+
+    QColor const itemBoxBackground;
+    QColor const itemBoxBorder;
+    QColor const itemBoxProgress;
+    QPen const itemBoxSelectedPen;
+
+    QColor const itemNoteBackground;
+
+    QColor const connectorSelpointColor;
+    QBrush const connectorInactiveBrush;
+
+private:
+    Theme();
+
+    QHash<int, QPen> _connectorPens; // transport type -> pen
+};
+} // namespace core
+
+using namespace core;
+
+#endif // THEME_H
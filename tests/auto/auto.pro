@@ -1,5 +1,8 @@
 TEMPLATE = subdirs
 
-SUBDIRS += item
+SUBDIRS += item \
+           error \
+           project \
+           helper
 
 OTHER_FILES += testcase.pri
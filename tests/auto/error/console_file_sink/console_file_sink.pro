@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testConsoleFileSink
+
+SOURCES +=  \
+            test_console_file_sink.cpp
+
+HEADERS +=  \
+            test_console_file_sink.h
@@ -0,0 +1,102 @@
+#include "test_console_file_sink.h"
+
+#include "error/console_file_sink.h"
+#include "helper/settings_scope.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+// the smallest size the sink accepts
+static int const MaxSize = 1024;
+
+static ConsoleMessage makeMessage(QString const& text)
+{
+    QMessageLogContext context{"test_console_file_sink.cpp", 1, "makeMessage", "default"};
+    return ConsoleMessage{QtDebugMsg, context, text};
+}
+
+QString test_ConsoleFileSink::logFilePath() const
+{
+    return directory_->filePath("console.log");
+}
+
+void test_ConsoleFileSink::startSink(int maxSize, int fileCount)
+{
+    SettingsScope::globalScope()->setValue("ConsoleLogFile", logFilePath());
+    SettingsScope::globalScope()->setValue("ConsoleLogFileMaxSize", maxSize);
+    SettingsScope::globalScope()->setValue("ConsoleLogFileCount", fileCount);
+    ConsoleFileSink::init();
+}
+
+void test_ConsoleFileSink::logMessages(int count)
+{
+    for (int i = 0; i < count; i++) {
+        ConsoleFileSink::log(makeMessage(QString("message %1 %2").arg(i, 4, 10, QChar('0')).arg(QString(40, 'x'))));
+    }
+
+    // writes the pending messages
+    ConsoleFileSink::deinit();
+}
+
+void test_ConsoleFileSink::init()
+{
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+}
+
+void test_ConsoleFileSink::cleanup()
+{
+    ConsoleFileSink::deinit();
+    SettingsScope::globalScope()->setValue("ConsoleLogFile", QVariant());
+}
+
+void test_ConsoleFileSink::testMessagesAreWritten()
+{
+    startSink(MaxSize, 3);
+    logMessages(3);
+
+    QFile file{logFilePath()};
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    auto const lines = file.readAll().split('\n');
+
+    QCOMPARE(lines.size(), 4); // the last line is empty
+    QVERIFY(lines.at(0).contains("message 0000"));
+    QVERIFY(lines.at(2).contains("message 0002"));
+    QCOMPARE(QDir{directory_->path()}.entryList(QDir::Files), QStringList{"console.log"});
+}
+
+void test_ConsoleFileSink::testRotationKeepsFileCount()
+{
+    startSink(MaxSize, 3);
+
+    // far more than three files
+    logMessages(200);
+
+    auto const files = QDir{directory_->path()}.entryList(QDir::Files, QDir::Name);
+    QCOMPARE(files, (QStringList{"console.log", "console.log.1", "console.log.2"}));
+
+    for (QString const& fileName : files) {
+        QVERIFY(QFileInfo(directory_->filePath(fileName)).size() <= MaxSize);
+    }
+
+    // the newest messages are in the current file, the older ones were shifted
+    QFile current{logFilePath()};
+    QVERIFY(current.open(QIODevice::ReadOnly));
+    QVERIFY(current.readAll().contains("message 0199"));
+
+    QFile older{directory_->filePath("console.log.1")};
+    QVERIFY(older.open(QIODevice::ReadOnly));
+    QVERIFY(!older.readAll().contains("message 0199"));
+}
+
+void test_ConsoleFileSink::testSingleFileStartsOver()
+{
+    startSink(MaxSize, 1);
+    logMessages(200);
+
+    QCOMPARE(QDir{directory_->path()}.entryList(QDir::Files), QStringList{"console.log"});
+    QVERIFY(QFileInfo(logFilePath()).size() <= MaxSize);
+}
+
+QTEST_MAIN(test_ConsoleFileSink)
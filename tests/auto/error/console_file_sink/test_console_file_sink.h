@@ -0,0 +1,29 @@
+#ifndef TEST_CONSOLE_FILE_SINK_H
+#define TEST_CONSOLE_FILE_SINK_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+class test_ConsoleFileSink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testMessagesAreWritten();
+    void testRotationKeepsFileCount();
+    void testSingleFileStartsOver();
+
+private:
+    QString logFilePath() const;
+    void startSink(int maxSize, int fileCount);
+    void logMessages(int count);
+
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_CONSOLE_FILE_SINK_H
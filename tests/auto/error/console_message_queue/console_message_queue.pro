@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testConsoleMessageQueue
+
+SOURCES +=  \
+            test_console_message_queue.cpp
+
+HEADERS +=  \
+            test_console_message_queue.h
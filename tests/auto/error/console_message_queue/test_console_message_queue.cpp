@@ -0,0 +1,118 @@
+#include "test_console_message_queue.h"
+
+#include "error/console_message_queue.h"
+
+#include <QThread>
+#include <algorithm>
+
+static ConsoleMessage makeMessage(QString const& text)
+{
+    QMessageLogContext context{"test_console_message_queue.cpp", 1, "makeMessage", "default"};
+    return ConsoleMessage{QtDebugMsg, context, text};
+}
+
+/**
+ * @brief Pushes numbered messages ("<producer>:<number>") from its own thread
+ */
+class ProducerThread : public QThread
+{
+public:
+    ProducerThread(ConsoleMessageQueue& queue, int producer, int count)
+        : queue_(queue), producer_(producer), count_(count)
+    {
+    }
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < count_; i++) {
+            queue_.push(makeMessage(QString("%1:%2").arg(producer_).arg(i)));
+        }
+    }
+
+private:
+    ConsoleMessageQueue& queue_;
+    int const producer_;
+    int const count_;
+};
+
+void test_ConsoleMessageQueue::testEmptyQueue()
+{
+    ConsoleMessageQueue queue;
+    QVERIFY(queue.takeAll().isEmpty());
+}
+
+void test_ConsoleMessageQueue::testTakeAllKeepsPushOrder()
+{
+    ConsoleMessageQueue queue;
+
+    for (int i = 0; i < 10; i++) {
+        queue.push(makeMessage(QString::number(i)));
+    }
+
+    auto const messages = queue.takeAll();
+    QCOMPARE(messages.size(), 10);
+
+    for (int i = 0; i < 10; i++) {
+        QCOMPARE(messages.at(i).message(), QString::number(i));
+    }
+}
+
+void test_ConsoleMessageQueue::testTakeAllEmptiesQueue()
+{
+    ConsoleMessageQueue queue;
+    queue.push(makeMessage("first"));
+    QCOMPARE(queue.takeAll().size(), 1);
+
+    queue.push(makeMessage("second"));
+    auto const messages = queue.takeAll();
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(messages.first().message(), QString{"second"});
+    QVERIFY(queue.takeAll().isEmpty());
+}
+
+void test_ConsoleMessageQueue::testConcurrentProducers()
+{
+    int const producerCount = 4;
+    int const messagesPerProducer = 2000;
+
+    ConsoleMessageQueue queue;
+    QList<QThread*> producers;
+
+    for (int p = 0; p < producerCount; p++) {
+        producers.append(new ProducerThread{queue, p, messagesPerProducer});
+    }
+
+    // the consumer drains while the producers are still pushing
+    for (QThread* producer : producers) {
+        producer->start();
+    }
+
+    QVector<ConsoleMessage> messages;
+
+    while (std::any_of(producers.cbegin(), producers.cend(), [](QThread* producer) {
+        return producer->isRunning();
+    })) {
+        messages += queue.takeAll();
+    }
+
+    for (QThread* producer : producers) {
+        producer->wait();
+    }
+
+    messages += queue.takeAll();
+    qDeleteAll(producers);
+
+    // every message arrives exactly once and the messages of one producer keep their order
+    QCOMPARE(messages.size(), producerCount * messagesPerProducer);
+    QVector<int> next(producerCount, 0);
+
+    for (ConsoleMessage const& message : messages) {
+        auto const parts = message.message().split(':');
+        int const producer = parts.at(0).toInt();
+        QCOMPARE(parts.at(1).toInt(), next[producer]);
+        next[producer]++;
+    }
+}
+
+QTEST_MAIN(test_ConsoleMessageQueue)
@@ -0,0 +1,18 @@
+#ifndef TEST_CONSOLE_MESSAGE_QUEUE_H
+#define TEST_CONSOLE_MESSAGE_QUEUE_H
+
+#include <QObject>
+#include <QtTest/QTest>
+
+class test_ConsoleMessageQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyQueue();
+    void testTakeAllKeepsPushOrder();
+    void testTakeAllEmptiesQueue();
+    void testConcurrentProducers();
+};
+
+#endif // TEST_CONSOLE_MESSAGE_QUEUE_H
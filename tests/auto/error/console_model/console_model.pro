@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testConsoleModel
+
+SOURCES +=  \
+            test_console_model.cpp
+
+HEADERS +=  \
+            test_console_model.h
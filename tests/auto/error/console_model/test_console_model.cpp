@@ -0,0 +1,251 @@
+#include "test_console_model.h"
+
+#include "error/console_model.h"
+
+#include <QSignalSpy>
+
+/**
+ * @brief Exposes the drain of the message queue, which is otherwise triggered by the model's timer
+ */
+class DrainableConsoleModel : public ConsoleModel
+{
+public:
+    void drain()
+    {
+        timerEvent(nullptr);
+    }
+};
+
+static ConsoleMessage makeMessage(QString const& text,
+                                  QtMsgType type = QtDebugMsg,
+                                  char const* category = "default")
+{
+    QMessageLogContext context{"test_console_model.cpp", 1, "makeMessage", category};
+    return ConsoleMessage{type, context, text};
+}
+
+static QString messageText(ConsoleModel const& model, int row)
+{
+    return model.data(model.index(row, ConsoleModel::Message), Qt::DisplayRole).toString();
+}
+
+// the ids of all rows matching the filter, checked row by row without the indexes
+static QVector<qint64> expectedMatches(ConsoleModel const& model, ConsoleModel::Filter const& filter)
+{
+    QVector<qint64> ids;
+
+    for (int row = 0; row < model.rowCount(QModelIndex{}); row++) {
+        if (model.matches(row, filter)) {
+            ids.append(model.messageId(row));
+        }
+    }
+
+    return ids;
+}
+
+static void appendMixedMessages(DrainableConsoleModel& model)
+{
+    model.appendMessage(makeMessage("loading project", QtDebugMsg, "project"));
+    model.appendMessage(makeMessage("Item moved", QtDebugMsg, "item"));
+    model.appendMessage(makeMessage("could not load project", QtWarningMsg, "project"));
+    model.appendMessage(makeMessage("item removed", QtInfoMsg, "item"));
+    model.appendMessage(makeMessage("connection lost", QtCriticalMsg, "sql"));
+    model.drain();
+}
+
+void test_ConsoleModel::testDrainInsertsQueuedMessages()
+{
+    DrainableConsoleModel model;
+    model.appendMessage(makeMessage("first"));
+    model.appendMessage(makeMessage("second"));
+
+    // messages only show up after the drain
+    QCOMPARE(model.rowCount(QModelIndex{}), 0);
+
+    model.drain();
+    QCOMPARE(model.rowCount(QModelIndex{}), 2);
+    QCOMPARE(messageText(model, 0), QString{"first"});
+    QCOMPARE(messageText(model, 1), QString{"second"});
+}
+
+void test_ConsoleModel::testFullBufferDropsOldestMessages()
+{
+    DrainableConsoleModel model;
+    model.setCapacity(10);
+
+    for (int i = 0; i < 25; i++) {
+        model.appendMessage(makeMessage(QString::number(i)));
+    }
+
+    model.drain();
+    QCOMPARE(model.rowCount(QModelIndex{}), 10);
+    QCOMPARE(messageText(model, 0), QString{"15"});
+    QCOMPARE(messageText(model, 9), QString{"24"});
+
+    model.appendMessage(makeMessage("25"));
+    model.drain();
+    QCOMPARE(model.rowCount(QModelIndex{}), 10);
+    QCOMPARE(messageText(model, 0), QString{"16"});
+    QCOMPARE(messageText(model, 9), QString{"25"});
+}
+
+void test_ConsoleModel::testShrinkingCapacityKeepsNewestMessages()
+{
+    DrainableConsoleModel model;
+
+    for (int i = 0; i < 5; i++) {
+        model.appendMessage(makeMessage(QString::number(i)));
+    }
+
+    model.drain();
+    model.setCapacity(3);
+
+    QCOMPARE(model.capacity(), 3);
+    QCOMPARE(model.rowCount(QModelIndex{}), 3);
+    QCOMPARE(messageText(model, 0), QString{"2"});
+    QCOMPARE(messageText(model, 2), QString{"4"});
+}
+
+void test_ConsoleModel::testLateMessageIsSortedIn()
+{
+    DrainableConsoleModel model;
+    auto const early = makeMessage("early");
+    QTest::qSleep(5);
+    auto const late = makeMessage("late");
+
+    // the early message arrives one drain too late, e.g. from another thread
+    model.appendMessage(late);
+    model.drain();
+    model.appendMessage(early);
+    model.drain();
+
+    QCOMPARE(model.rowCount(QModelIndex{}), 2);
+    QCOMPARE(messageText(model, 0), QString{"early"});
+    QCOMPARE(messageText(model, 1), QString{"late"});
+}
+
+void test_ConsoleModel::testRemoveRowsInTheMiddle()
+{
+    DrainableConsoleModel model;
+
+    for (int i = 0; i < 5; i++) {
+        model.appendMessage(makeMessage(QString::number(i)));
+    }
+
+    model.drain();
+    QVERIFY(model.removeRows(1, 2, QModelIndex{}));
+
+    QCOMPARE(model.rowCount(QModelIndex{}), 3);
+    QCOMPARE(messageText(model, 0), QString{"0"});
+    QCOMPARE(messageText(model, 1), QString{"3"});
+    QCOMPARE(messageText(model, 2), QString{"4"});
+
+    QVERIFY(!model.removeRows(2, 2, QModelIndex{}));
+}
+
+void test_ConsoleModel::testFindMessagesByType()
+{
+    DrainableConsoleModel model;
+    appendMixedMessages(model);
+
+    ConsoleModel::Filter filter;
+    filter.types = {ConsoleMessage::Warning, ConsoleMessage::Critical};
+
+    auto const ids = model.findMessages(filter);
+    QCOMPARE(ids.size(), 2);
+    QCOMPARE(ids, expectedMatches(model, filter));
+}
+
+void test_ConsoleModel::testFindMessagesByCategory()
+{
+    DrainableConsoleModel model;
+    appendMixedMessages(model);
+
+    ConsoleModel::Filter filter;
+    filter.category = "project";
+
+    auto const ids = model.findMessages(filter);
+    QCOMPARE(ids.size(), 2);
+    QCOMPARE(ids, expectedMatches(model, filter));
+
+    filter.types = {ConsoleMessage::Warning};
+    QCOMPARE(model.findMessages(filter).size(), 1);
+
+    QVERIFY(model.categories().contains("sql"));
+}
+
+void test_ConsoleModel::testFindMessagesByText()
+{
+    DrainableConsoleModel model;
+    appendMixedMessages(model);
+
+    ConsoleModel::Filter filter;
+
+    // case insensitive, in any column
+    filter.text = "ITEM";
+    QCOMPARE(model.findMessages(filter).size(), 2);
+    QCOMPARE(model.findMessages(filter), expectedMatches(model, filter));
+
+    filter.text = "load*project";
+    QCOMPARE(model.findMessages(filter).size(), 2);
+    QCOMPARE(model.findMessages(filter), expectedMatches(model, filter));
+
+    filter.text = "not in any message";
+    QVERIFY(model.findMessages(filter).isEmpty());
+}
+
+void test_ConsoleModel::testLateMessagesRebuildIndexesOnce()
+{
+    DrainableConsoleModel model;
+    QSignalSpy rebuilt{&model, SIGNAL(indexesRebuilt())};
+
+    QVector<ConsoleMessage> early;
+
+    for (int i = 0; i < 5; i++) {
+        early.append(makeMessage(QString("early %1").arg(i), QtWarningMsg, "late"));
+        QTest::qSleep(2);
+    }
+
+    model.appendMessage(makeMessage("newest", QtDebugMsg, "default"));
+    model.drain();
+
+    for (ConsoleMessage const& message : early) {
+        model.appendMessage(message);
+    }
+
+    model.drain();
+
+    QCOMPARE(rebuilt.count(), 1);
+    QCOMPARE(messageText(model, 5), QString{"newest"});
+
+    ConsoleModel::Filter filter;
+    filter.category = "late";
+    filter.text = "early";
+    QCOMPARE(model.findMessages(filter).size(), 5);
+    QCOMPARE(model.findMessages(filter), expectedMatches(model, filter));
+}
+
+void test_ConsoleModel::testRemovalsRebuildIndexesOnce()
+{
+    DrainableConsoleModel model;
+    appendMixedMessages(model);
+    QSignalSpy rebuilt{&model, SIGNAL(indexesRebuilt())};
+
+    QVERIFY(model.removeRows(3, 1, QModelIndex{}));
+    QVERIFY(model.removeRows(1, 1, QModelIndex{}));
+
+    // until the rebuild, the messages are checked directly
+    ConsoleModel::Filter filter;
+    filter.text = "item";
+    QCOMPARE(model.findMessages(filter).size(), 0);
+
+    filter.text = "project";
+    QCOMPARE(model.findMessages(filter), expectedMatches(model, filter));
+
+    QCoreApplication::processEvents();
+    QCOMPARE(rebuilt.count(), 1);
+    QCOMPARE(model.findMessages(filter).size(), 2);
+    QCOMPARE(model.findMessages(filter), expectedMatches(model, filter));
+}
+
+QTEST_MAIN(test_ConsoleModel)
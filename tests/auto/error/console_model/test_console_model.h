@@ -0,0 +1,27 @@
+#ifndef TEST_CONSOLE_MODEL_H
+#define TEST_CONSOLE_MODEL_H
+
+#include <QObject>
+#include <QtTest/QTest>
+
+class test_ConsoleModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ring buffer
+    void testDrainInsertsQueuedMessages();
+    void testFullBufferDropsOldestMessages();
+    void testShrinkingCapacityKeepsNewestMessages();
+    void testLateMessageIsSortedIn();
+    void testRemoveRowsInTheMiddle();
+
+    // indexes
+    void testFindMessagesByType();
+    void testFindMessagesByCategory();
+    void testFindMessagesByText();
+    void testLateMessagesRebuildIndexesOnce();
+    void testRemovalsRebuildIndexesOnce();
+};
+
+#endif // TEST_CONSOLE_MODEL_H
@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+SUBDIRS += console_model \
+           console_message_queue \
+           console_file_sink
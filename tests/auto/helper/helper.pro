@@ -0,0 +1,4 @@
+TEMPLATE = subdirs
+
+SUBDIRS += sql_connection_pool \
+           sql_query_worker
@@ -0,0 +1,11 @@
+include(../../testcase.pri)
+
+QT += sql
+
+TARGET = testSqlConnectionPool
+
+SOURCES +=  \
+            test_sql_connection_pool.cpp
+
+HEADERS +=  \
+            test_sql_connection_pool.h
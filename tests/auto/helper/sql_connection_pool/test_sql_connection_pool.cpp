@@ -0,0 +1,177 @@
+#include "test_sql_connection_pool.h"
+
+#include <QSqlError>
+#include <QThread>
+
+#include <functional>
+
+/**
+ * @brief Runs a function on a thread of its own, which finishes afterwards
+ */
+class FunctionThread : public QThread
+{
+public:
+    explicit FunctionThread(std::function<void()> const& function) : function_(function) {}
+
+protected:
+    void run() override
+    {
+        function_();
+    }
+
+private:
+    std::function<void()> function_;
+};
+
+static void runInThread(std::function<void()> const& function)
+{
+    FunctionThread thread{function};
+    thread.start();
+    thread.wait();
+}
+
+static int count(SqlConnectionPool& pool, QString const& table)
+{
+    auto query = pool.exec(QString("SELECT COUNT(*) FROM %1").arg(table));
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+void test_SqlConnectionPool::init()
+{
+    // a file, so all connections of a pool share it
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+
+    database_ = SqlDatabase{"QSQLITE"};
+    database_.setDatabaseName(directory_->filePath("pool.db"));
+    database_.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+}
+
+void test_SqlConnectionPool::testCloneHasSameProperties()
+{
+    database_.setUserName("user");
+    database_.setHostName("host");
+    database_.setPort(42);
+
+    auto const clone = database_.clone();
+    QCOMPARE(clone.driverName(), database_.driverName());
+    QCOMPARE(clone.databaseName(), database_.databaseName());
+    QCOMPARE(clone.userName(), QString{"user"});
+    QCOMPARE(clone.hostName(), QString{"host"});
+    QCOMPARE(clone.port(), 42);
+    QCOMPARE(clone.connectOptions(), database_.connectOptions());
+    QVERIFY(!clone.isOpen());
+}
+
+void test_SqlConnectionPool::testThreadKeepsItsConnection()
+{
+    SqlConnectionPool pool{database_};
+    QVERIFY(pool.database().isOpen());
+    QVERIFY(!database_.isOpen()); // only its clones are opened
+
+    // a temporary table only exists for the connection which created it
+    QVERIFY(!pool.exec("CREATE TEMP TABLE connection_table (id INTEGER)").lastError().isValid());
+    QCOMPARE(count(pool, "connection_table"), 0);
+
+    SqlQuery query{pool.database()};
+    QVERIFY(query.exec("INSERT INTO connection_table VALUES (1)"));
+    QCOMPARE(count(pool, "connection_table"), 1);
+}
+
+void test_SqlConnectionPool::testEveryThreadHasItsOwnConnection()
+{
+    SqlConnectionPool pool{database_};
+    QVERIFY(!pool.exec("CREATE TEMP TABLE connection_table (id INTEGER)").lastError().isValid());
+    QVERIFY(!pool.exec("CREATE TABLE shared_table (id INTEGER)").lastError().isValid());
+
+    bool hasTemporaryTable = true;
+    int sharedRows = -1;
+
+    runInThread([&]() {
+        hasTemporaryTable = pool.database().tables(QSql::AllTables).contains("connection_table");
+        pool.exec("INSERT INTO shared_table VALUES (?)", {1});
+        sharedRows = count(pool, "shared_table");
+    });
+
+    QVERIFY(!hasTemporaryTable);
+    QCOMPARE(sharedRows, 1);
+    QCOMPARE(count(pool, "shared_table"), 1);
+
+    // the connection of the finished thread was closed, a new thread opens another one
+    runInThread([&]() {
+        sharedRows = count(pool, "shared_table");
+    });
+
+    QCOMPARE(sharedRows, 1);
+}
+
+void test_SqlConnectionPool::testCachedStatementStartsOver()
+{
+    SqlConnectionPool pool{database_};
+    QVERIFY(!pool.exec("CREATE TABLE numbers (value INTEGER)").lastError().isValid());
+
+    for (int i = 0; i < 3; i++) {
+        QVERIFY(!pool.exec("INSERT INTO numbers VALUES (?)", {i}).lastError().isValid());
+    }
+
+    QString const select = "SELECT value FROM numbers WHERE value >= ? ORDER BY value";
+
+    // the result is not read to its end, before the statement is used again
+    auto query = pool.exec(select, {1});
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+
+    query = pool.exec(select, {0});
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+
+    // prepared without values, bound by the caller
+    auto statement = pool.prepare(select);
+    statement.bindValue(0, 2);
+    QVERIFY(statement.exec());
+    QVERIFY(statement.next());
+    QCOMPARE(statement.value(0).toInt(), 2);
+    QVERIFY(!statement.next());
+}
+
+void test_SqlConnectionPool::testFailedStatementIsNotCached()
+{
+    SqlConnectionPool pool{database_};
+    QString const select = "SELECT COUNT(*) FROM later_table";
+
+    QVERIFY(pool.exec(select).lastError().isValid());
+
+    QVERIFY(!pool.exec("CREATE TABLE later_table (id INTEGER)").lastError().isValid());
+
+    auto query = pool.exec(select);
+    QVERIFY(!query.lastError().isValid());
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+}
+
+void test_SqlConnectionPool::testExecFromSeveralThreads()
+{
+    SqlConnectionPool pool{database_};
+    QVERIFY(!pool.exec("CREATE TABLE shared_table (thread INTEGER, id INTEGER)").lastError().isValid());
+
+    int const threadCount = 4;
+    int const rowCount = 25;
+    QList<QSharedPointer<FunctionThread>> threads;
+
+    for (int t = 0; t < threadCount; t++) {
+        threads.append(QSharedPointer<FunctionThread>::create([&pool, t]() {
+            for (int i = 0; i < rowCount; i++) {
+                pool.exec("INSERT INTO shared_table VALUES (?, ?)", {t, i});
+            }
+        }));
+        threads.last()->start();
+    }
+
+    for (auto const& thread : threads) {
+        QVERIFY(thread->wait(10000));
+    }
+
+    QCOMPARE(count(pool, "shared_table"), threadCount * rowCount);
+}
+
+QTEST_MAIN(test_SqlConnectionPool)
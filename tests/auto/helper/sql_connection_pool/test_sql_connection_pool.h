@@ -0,0 +1,30 @@
+#ifndef TEST_SQL_CONNECTION_POOL_H
+#define TEST_SQL_CONNECTION_POOL_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+#include "helper/sql_database.h"
+
+class test_SqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testCloneHasSameProperties();
+    void testThreadKeepsItsConnection();
+    void testEveryThreadHasItsOwnConnection();
+    void testCachedStatementStartsOver();
+    void testFailedStatementIsNotCached();
+    void testExecFromSeveralThreads();
+
+private:
+    SqlDatabase database_;
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_SQL_CONNECTION_POOL_H
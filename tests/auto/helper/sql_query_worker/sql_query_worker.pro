@@ -0,0 +1,11 @@
+include(../../testcase.pri)
+
+QT += sql
+
+TARGET = testSqlQueryWorker
+
+SOURCES +=  \
+            test_sql_query_worker.cpp
+
+HEADERS +=  \
+            test_sql_query_worker.h
@@ -0,0 +1,184 @@
+#include "test_sql_query_worker.h"
+
+#include "helper/sql_query_worker.h"
+
+#include <QPointer>
+#include <limits>
+
+static int const NumberCount = 1000;
+static int const Timeout = 5000;
+
+static QString const selectNumbers = "SELECT value FROM numbers ORDER BY value";
+
+/**
+ * @brief Collects the signals of a SqlAsyncQuery
+ */
+struct QueryResult {
+    explicit QueryResult(SqlAsyncQuery* query)
+    {
+        QObject::connect(query, &SqlAsyncQuery::rowsFetched, [this](QVector<QSqlRecord> const& rows) {
+            batchSizes.append(rows.size());
+
+            for (QSqlRecord const& row : rows) {
+                values.append(row.value(0).toInt());
+            }
+        });
+        QObject::connect(query, &SqlAsyncQuery::finished, [this](QSqlError const& finishedError) {
+            isFinished = true;
+            error = finishedError;
+        });
+    }
+
+    QList<int> batchSizes;
+    QList<int> values;
+    bool isFinished = false;
+    QSqlError error;
+};
+
+void test_SqlQueryWorker::init()
+{
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+
+    database_ = SqlDatabase{"QSQLITE"};
+    database_.setDatabaseName(directory_->filePath("worker.db"));
+
+    SqlDatabase setup = database_.clone();
+    QVERIFY(setup.open());
+    QVERIFY(setup.transaction());
+    QVERIFY(!setup.exec("CREATE TABLE numbers (value INTEGER)").lastError().isValid());
+
+    SqlQuery insert{setup};
+    QVERIFY(insert.prepare("INSERT INTO numbers VALUES (?)"));
+
+    for (int i = 0; i < NumberCount; i++) {
+        insert.bindValue(0, i);
+        QVERIFY(insert.exec());
+    }
+
+    QVERIFY(setup.commit());
+}
+
+void test_SqlQueryWorker::testRowsAreDeliveredInBatches()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QPointer<SqlAsyncQuery> query = worker.exec("SELECT value FROM numbers WHERE value < 10 ORDER BY value", &requester, {}, 3);
+    QueryResult result{query};
+
+    QTRY_VERIFY_WITH_TIMEOUT(result.isFinished, Timeout);
+    QCOMPARE(result.error.type(), QSqlError::NoError);
+    QCOMPARE(result.batchSizes, (QList<int>{3, 3, 3, 1}));
+    QCOMPARE(result.values, (QList<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // the handle deletes itself after it finished
+    QTRY_VERIFY_WITH_TIMEOUT(query.isNull(), Timeout);
+}
+
+void test_SqlQueryWorker::testValuesAreBound()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QueryResult result{worker.exec("SELECT value FROM numbers WHERE value >= ? ORDER BY value", &requester, {NumberCount - 3})};
+
+    QTRY_VERIFY_WITH_TIMEOUT(result.isFinished, Timeout);
+    QCOMPARE(result.values, (QList<int>{NumberCount - 3, NumberCount - 2, NumberCount - 1}));
+    QCOMPARE(result.batchSizes.size(), 1);
+}
+
+void test_SqlQueryWorker::testFailedQueryReportsError()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QueryResult result{worker.exec("SELECT value FROM missing_table", &requester)};
+
+    QTRY_VERIFY_WITH_TIMEOUT(result.isFinished, Timeout);
+    QVERIFY(result.error.isValid());
+    QVERIFY(result.batchSizes.isEmpty());
+}
+
+void test_SqlQueryWorker::testQueriesRunInOrder()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QList<int> finished;
+
+    for (int i = 0; i < 3; i++) {
+        auto const query = worker.exec(selectNumbers, &requester, {}, 100);
+        connect(query, &SqlAsyncQuery::finished, [&finished, i](QSqlError const&) {
+            finished.append(i);
+        });
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 3, Timeout);
+    QCOMPARE(finished, (QList<int>{0, 1, 2}));
+}
+
+void test_SqlQueryWorker::testLargeBatchSize()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QueryResult result{worker.exec(selectNumbers, &requester, {}, std::numeric_limits<int>::max())};
+
+    QTRY_VERIFY_WITH_TIMEOUT(result.isFinished, Timeout);
+    QCOMPARE(result.batchSizes, QList<int>{NumberCount});
+}
+
+void test_SqlQueryWorker::testCancelStopsDelivery()
+{
+    SqlQueryWorker worker{database_};
+    QObject requester;
+    QPointer<SqlAsyncQuery> query = worker.exec(selectNumbers, &requester, {}, 1);
+    QueryResult result{query};
+
+    connect(query, &SqlAsyncQuery::rowsFetched, query, &SqlAsyncQuery::cancel);
+
+    // the worker continues with the next query
+    QueryResult next{worker.exec("SELECT value FROM numbers WHERE value = 0", &requester)};
+    QTRY_VERIFY_WITH_TIMEOUT(next.isFinished, Timeout);
+    QCOMPARE(next.values, QList<int>{0});
+
+    QCOMPARE(result.values, QList<int>{0});
+    QVERIFY(!result.isFinished);
+
+    // the cancelled handle deletes itself
+    QTRY_VERIFY_WITH_TIMEOUT(query.isNull(), Timeout);
+}
+
+void test_SqlQueryWorker::testDeletedRequesterCancelsQuery()
+{
+    SqlQueryWorker worker{database_};
+    QScopedPointer<QObject> requester{new QObject};
+    QPointer<SqlAsyncQuery> query = worker.exec(selectNumbers, requester.data(), {}, 1);
+
+    // without the event loop, the worker waits for the handle after a few batches, until it is deleted with its requester
+    QTest::qSleep(100);
+    requester.reset();
+    QVERIFY(query.isNull());
+
+    QObject nextRequester;
+    QueryResult next{worker.exec("SELECT value FROM numbers WHERE value = 0", &nextRequester)};
+    QTRY_VERIFY_WITH_TIMEOUT(next.isFinished, Timeout);
+    QCOMPARE(next.values, QList<int>{0});
+}
+
+void test_SqlQueryWorker::testDestroyedWorkerCancelsQueries()
+{
+    QScopedPointer<SqlQueryWorker> worker{new SqlQueryWorker{database_}};
+    QObject requester;
+    QueryResult running{worker->exec(selectNumbers, &requester, {}, 1)};
+    QueryResult queued{worker->exec(selectNumbers, &requester)};
+
+    // stops the thread, while the first query waits for its handle and the second one is queued
+    QTest::qSleep(100);
+    worker.reset();
+
+    // the batches which were fetched before are dropped
+    QCoreApplication::processEvents();
+    QVERIFY(running.values.isEmpty());
+    QVERIFY(!running.isFinished);
+    QVERIFY(!queued.isFinished);
+    QVERIFY(queued.values.isEmpty());
+}
+
+QTEST_MAIN(test_SqlQueryWorker)
@@ -0,0 +1,34 @@
+#ifndef TEST_SQL_QUERY_WORKER_H
+#define TEST_SQL_QUERY_WORKER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+#include "helper/sql_database.h"
+
+class test_SqlQueryWorker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testRowsAreDeliveredInBatches();
+    void testValuesAreBound();
+    void testFailedQueryReportsError();
+    void testQueriesRunInOrder();
+    void testLargeBatchSize();
+
+    // cancellation
+    void testCancelStopsDelivery();
+    void testDeletedRequesterCancelsQuery();
+    void testDestroyedWorkerCancelsQueries();
+
+private:
+    SqlDatabase database_;
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_SQL_QUERY_WORKER_H
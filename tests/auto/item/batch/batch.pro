@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemBatch
+
+SOURCES +=  \
+            test_item_batch.cpp
+
+HEADERS +=  \
+            test_item_batch.h
@@ -0,0 +1,165 @@
+#include "test_item_batch.h"
+
+#include "item/item_batch.h"
+#include "item/item_scene.h"
+#include "item/item_connector.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QSignalSpy>
+
+void test_ItemBatch::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemBatch::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemBatch::testNestedBatchesAreActive()
+{
+    QVERIFY(!ItemBatch::isActive());
+
+    {
+        ItemBatch outer;
+        QVERIFY(ItemBatch::isActive());
+
+        {
+            ItemBatch inner;
+            QVERIFY(ItemBatch::isActive());
+        }
+
+        QVERIFY(ItemBatch::isActive());
+    }
+
+    QVERIFY(!ItemBatch::isActive());
+}
+
+void test_ItemBatch::testConnectionSignalsAreDeferred()
+{
+    SomeItem itemA{"itemA", 1};
+    SomeItem itemB{"itemB", 2};
+    auto const output = itemA.outputs().first();
+    auto const input = itemB.inputs().first();
+    QSignalSpy outputConnected{output, SIGNAL(inputConnected())};
+    QSignalSpy inputConnected{input, SIGNAL(outputConnected())};
+
+    {
+        ItemBatch outer;
+
+        {
+            ItemBatch inner;
+            QVERIFY(input->connectOutput(output));
+        }
+
+        // only the outermost batch commits
+        QCOMPARE(input->output(), output);
+        QCOMPARE(outputConnected.count(), 0);
+        QCOMPARE(inputConnected.count(), 0);
+    }
+
+    QCOMPARE(outputConnected.count(), 1);
+    QCOMPARE(inputConnected.count(), 1);
+}
+
+void test_ItemBatch::testConnectionSignalsArePerConnection()
+{
+    SomeItem itemA{"itemA", 1};
+    SomeItem itemB{"itemB", 2};
+    SomeItem itemC{"itemC", 3};
+    auto const output = itemA.outputs().first();
+    QSignalSpy outputConnected{output, SIGNAL(inputConnected())};
+
+    {
+        ItemBatch batch;
+        QVERIFY(itemB.inputs().first()->connectOutput(output));
+        QVERIFY(itemC.inputs().first()->connectOutput(output));
+    }
+
+    QCOMPARE(outputConnected.count(), 2);
+}
+
+void test_ItemBatch::testRemovedConnectionIsNotReported()
+{
+    SomeItem itemA{"itemA", 1};
+    SomeItem itemB{"itemB", 2};
+    auto const output = itemA.outputs().first();
+    auto const input = itemB.inputs().first();
+    QSignalSpy outputConnected{output, SIGNAL(inputConnected())};
+    QSignalSpy outputDisconnected{output, SIGNAL(inputDisconnected())};
+    QSignalSpy inputConnected{input, SIGNAL(outputConnected())};
+    QSignalSpy inputDisconnected{input, SIGNAL(outputDisconnected())};
+    QSignalSpy inputDataChanged{input, SIGNAL(dataChanged())};
+
+    {
+        ItemBatch batch;
+        QVERIFY(input->connectOutput(output));
+        input->disconnectOutput();
+    }
+
+    QVERIFY(!input->isConnected());
+    QVERIFY(output->inputs().isEmpty());
+    QCOMPARE(outputConnected.count(), 0);
+    QCOMPARE(outputDisconnected.count(), 0);
+    QCOMPARE(inputConnected.count(), 0);
+    QCOMPARE(inputDisconnected.count(), 0);
+    QCOMPARE(inputDataChanged.count(), 0);
+}
+
+void test_ItemBatch::testPortsAreRealignedOnCommit()
+{
+    SomeItem reference{"reference", 1};
+    QScopedPointer<SomeItem> item;
+
+    {
+        ItemBatch batch;
+        item.reset(new SomeItem{"item", 2});
+    }
+
+    QCOMPARE(item->inputs().first()->localPosition(), reference.inputs().first()->localPosition());
+    QCOMPARE(item->outputs().first()->localPosition(), reference.outputs().first()->localPosition());
+}
+
+void test_ItemBatch::testConnectorsAreRoutedOnCommit()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    itemB->setPos(300, 100);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    Item_Connector* connector = nullptr;
+
+    {
+        ItemBatch batch;
+        connector = new Item_Connector{itemA->outputs().first(), itemB->inputs().first()};
+        scene.addItem(connector);
+        itemB->setPos(300, 200); // moving the ports again does not route either
+        QVERIFY(connector->shape().isEmpty());
+    }
+
+    QVERIFY(!connector->shape().isEmpty());
+    QVERIFY(connector->shape().contains(itemA->outputs().first()->scenePosition()));
+    QVERIFY(connector->shape().contains(itemB->inputs().first()->scenePosition()));
+}
+
+void test_ItemBatch::testDeletedItemsAreForgotten()
+{
+    SomeItem itemA{"itemA", 1};
+
+    {
+        ItemBatch batch;
+        auto itemB = new SomeItem{"itemB", 2};
+        QVERIFY(itemB->inputs().first()->connectOutput(itemA.outputs().first()));
+        delete itemB; // the commit must not touch its item and ports anymore
+    }
+
+    QVERIFY(itemA.outputs().first()->inputs().isEmpty());
+}
+
+QTEST_APPLESS_MAIN(test_ItemBatch)
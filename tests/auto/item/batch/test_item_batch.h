@@ -0,0 +1,28 @@
+#ifndef TEST_ITEM_BATCH_H
+#define TEST_ITEM_BATCH_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemBatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testNestedBatchesAreActive();
+    void testConnectionSignalsAreDeferred();
+    void testConnectionSignalsArePerConnection();
+    void testRemovedConnectionIsNotReported();
+    void testPortsAreRealignedOnCommit();
+    void testConnectorsAreRoutedOnCommit();
+    void testDeletedItemsAreForgotten();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_BATCH_H
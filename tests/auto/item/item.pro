@@ -1,3 +1,14 @@
 TEMPLATE = subdirs
 
-SUBDIRS += serializer
+SUBDIRS += serializer \
+           template_store \
+           port_index \
+           router \
+           record_store \
+           batch \
+           journal \
+           scene \
+           mime_data \
+           paint
+
+OTHER_FILES += item_test.pri
@@ -0,0 +1,13 @@
+# The application environment and the items shared by the item tests (see serializer)
+
+INCLUDEPATH += $$PWD $$PWD/serializer
+
+SOURCES +=  \
+            $$PWD/serializer/test_component.cpp \
+            $$PWD/serializer/some_item.cpp
+
+HEADERS +=  \
+            $$PWD/item_test_application.h \
+            $$PWD/serializer/test_component.h \
+            $$PWD/serializer/some_item.h \
+            $$PWD/serializer/some_transporter.h
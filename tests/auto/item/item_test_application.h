@@ -0,0 +1,32 @@
+#ifndef ITEM_TEST_APPLICATION_H
+#define ITEM_TEST_APPLICATION_H
+
+#include <QApplication>
+
+/**
+ * Loads the application environment required by the item tests, see test_ItemScene::initTestCase().
+ * Since the GuiManager is set to the Headless mode in the TestComponent, exec() returns once the
+ * environment is loaded. The returned application has to live until the tests finished.
+ */
+inline QApplication* startItemTestApplication()
+{
+    // QApplication keeps references to argc and argv
+    static int argc = 1;
+    static char argv0[] = "testApplication";
+    static char* argv[] = {argv0, nullptr};
+
+    auto application = new QApplication{argc, argv};
+
+    // required, otherwise initialization will be canceled.
+    QApplication::setOrganizationName("Testing Organisation");
+    QApplication::setOrganizationDomain("testing.example.com");
+    QApplication::setApplicationName("Testing Application");
+    QApplication::setApplicationDisplayName("Testing Application 1.0");
+    QApplication::setApplicationVersion("1.0-testing");
+
+    application->exec();
+
+    return application;
+}
+
+#endif // ITEM_TEST_APPLICATION_H
@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemJournal
+
+SOURCES +=  \
+            test_item_journal.cpp
+
+HEADERS +=  \
+            test_item_journal.h
@@ -0,0 +1,270 @@
+#include "test_item_journal.h"
+
+#include "item/item_journal.h"
+#include "item/item_scene.h"
+#include "item/item_connector.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "helper/settings_scope.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QGraphicsView>
+
+static QList<SomeItem*> someItems(ItemScene const& scene)
+{
+    QList<SomeItem*> items;
+
+    for (QGraphicsItem* item : scene.items()) {
+        if (auto someItem = qobject_cast<SomeItem*>(item->toGraphicsObject())) {
+            items.append(someItem);
+        }
+    }
+
+    return items;
+}
+
+static SomeItem* findItem(ItemScene const& scene, QString const& name)
+{
+    for (SomeItem* item : someItems(scene)) {
+        if (item->name() == name) {
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+void test_ItemJournal::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemJournal::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemJournal::testUndoRedoAddedItems()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene}; // undo() fits the scene to the view
+    QVERIFY(!scene.canUndo());
+
+    auto item = new SomeItem{"item", 1};
+    item->setPos(40, 50);
+    scene.addItem(item);
+    scene.journal().recordAdded({item});
+    QVERIFY(scene.canUndo());
+
+    scene.undo();
+    QVERIFY(someItems(scene).isEmpty());
+    QVERIFY(!scene.canUndo());
+    QVERIFY(scene.canRedo());
+
+    scene.redo();
+    QCOMPARE(someItems(scene).size(), 1);
+    QCOMPARE(someItems(scene).first()->name(), QString{"item"});
+    QCOMPARE(someItems(scene).first()->pos(), QPointF(40, 50));
+}
+
+void test_ItemJournal::testUndoRedoRestoresConnections()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    itemB->setPos(300, 0);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    auto connector = new Item_Connector{itemA->outputs().first(), itemB->inputs().first()};
+    QVERIFY(itemB->inputs().first()->connectOutput(itemA->outputs().first()));
+    scene.addItem(connector);
+    scene.journal().recordAdded({itemA, itemB, connector});
+
+    scene.undo();
+    QVERIFY(someItems(scene).isEmpty());
+
+    // the items are created again, they are found by their journal ids
+    scene.redo();
+    auto const restoredA = findItem(scene, "itemA");
+    auto const restoredB = findItem(scene, "itemB");
+    QVERIFY(restoredA != nullptr);
+    QVERIFY(restoredB != nullptr);
+    QCOMPARE(restoredB->inputs().first()->output(), restoredA->outputs().first());
+
+    // and are removed again by a second undo
+    scene.undo();
+    QVERIFY(someItems(scene).isEmpty());
+}
+
+void test_ItemJournal::testUndoRedoMove()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    scene.journal().beginMove({item});
+    item->setPos(100, 200);
+    scene.journal().endMove();
+
+    scene.undo();
+    QCOMPARE(item->pos(), QPointF(0, 0));
+
+    scene.redo();
+    QCOMPARE(item->pos(), QPointF(100, 200));
+}
+
+void test_ItemJournal::testUndoRedoRename()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    item->setName("renamed");
+    QVERIFY(scene.canUndo());
+
+    scene.undo();
+    QCOMPARE(item->name(), QString{"item"});
+
+    scene.redo();
+    QCOMPARE(item->name(), QString{"renamed"});
+}
+
+void test_ItemJournal::testUndoRedoSetting()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    item->settingsScope()->setValue("someSetting", 42);
+    QVERIFY(scene.canUndo());
+
+    scene.undo();
+    QVERIFY(!item->settingsScope()->value("someSetting", QVariant{}, false).isValid());
+
+    scene.redo();
+    QCOMPARE(item->settingsScope()->value("someSetting", QVariant{}, false).toInt(), 42);
+}
+
+void test_ItemJournal::testQuickSettingChangesAreMerged()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    for (int value = 1; value <= 5; value++) {
+        item->settingsScope()->setValue("someSetting", value);
+    }
+
+    scene.undo();
+    QVERIFY(!item->settingsScope()->value("someSetting", QVariant{}, false).isValid());
+    QVERIFY(!scene.canUndo());
+
+    scene.redo();
+    QCOMPARE(item->settingsScope()->value("someSetting", QVariant{}, false).toInt(), 5);
+}
+
+void test_ItemJournal::testSlowSettingChangesAreNotMerged()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    item->settingsScope()->setValue("someSetting", 1);
+    QTest::qSleep(1100); // longer than the merge interval
+    item->settingsScope()->setValue("someSetting", 2);
+
+    scene.undo();
+    QCOMPARE(item->settingsScope()->value("someSetting", QVariant{}, false).toInt(), 1);
+    QVERIFY(scene.canUndo());
+
+    scene.undo();
+    QVERIFY(!item->settingsScope()->value("someSetting", QVariant{}, false).isValid());
+}
+
+void test_ItemJournal::testNewEditDropsRedo()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    item->setName("first");
+    scene.undo();
+    QVERIFY(scene.canRedo());
+
+    item->setName("second");
+    QVERIFY(!scene.canRedo());
+
+    scene.undo();
+    QCOMPARE(item->name(), QString{"item"});
+}
+
+void test_ItemJournal::testMemoryLimitDropsOldestEntries()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    // a rename costs more than 64 bytes, so only few of them fit
+    ItemJournal journal{&scene, 300};
+
+    for (int i = 0; i < 10; i++) {
+        journal.recordRename(item, QString("name%1").arg(i), QString("name%1").arg(i + 1));
+    }
+
+    int undos = 0;
+
+    while (journal.canUndo()) {
+        journal.undo();
+        undos++;
+    }
+
+    QVERIFY(undos > 0);
+    QVERIFY(undos < 10);
+
+    // the latest entries are kept
+    QCOMPARE(item->name(), QString("name%1").arg(10 - undos));
+}
+
+void test_ItemJournal::testDroppedEntriesAreNotCounted()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+
+    ItemJournal journal{&scene, 300};
+
+    auto renameAndUndoAll = [&](QString const& prefix) {
+        for (int i = 0; i < 10; i++) {
+            journal.recordRename(item, prefix + QString::number(i), prefix + QString::number(i + 1));
+        }
+
+        int undos = 0;
+
+        while (journal.canUndo()) {
+            journal.undo();
+            undos++;
+        }
+
+        return undos;
+    };
+
+    // the second round replaces the undone entries of the first one, so as many entries fit again
+    int const undos = renameAndUndoAll("first");
+    QCOMPARE(renameAndUndoAll("other"), undos);
+
+    journal.clear();
+    QCOMPARE(renameAndUndoAll("third"), undos);
+}
+
+QTEST_APPLESS_MAIN(test_ItemJournal)
@@ -0,0 +1,31 @@
+#ifndef TEST_ITEM_JOURNAL_H
+#define TEST_ITEM_JOURNAL_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testUndoRedoAddedItems();
+    void testUndoRedoRestoresConnections();
+    void testUndoRedoMove();
+    void testUndoRedoRename();
+    void testUndoRedoSetting();
+    void testQuickSettingChangesAreMerged();
+    void testSlowSettingChangesAreNotMerged();
+    void testNewEditDropsRedo();
+    void testMemoryLimitDropsOldestEntries();
+    void testDroppedEntriesAreNotCounted();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_JOURNAL_H
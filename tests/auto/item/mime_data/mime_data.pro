@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemMimeData
+
+SOURCES +=  \
+            test_item_mime_data.cpp
+
+HEADERS +=  \
+            test_item_mime_data.h
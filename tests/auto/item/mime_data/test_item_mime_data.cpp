@@ -0,0 +1,118 @@
+#include "test_item_mime_data.h"
+
+#include "item/item_mime_data.h"
+
+#include <QDomDocument>
+#include <QMimeData>
+
+static char const* const XmlMimeType = "application/x-itemframework-items";
+
+static QDomDocument someDocument()
+{
+    QDomDocument document{"items"};
+    QDomElement root = document.createElement("items");
+    document.appendChild(root);
+
+    for (int i = 0; i < 3; i++) {
+        QDomElement item = document.createElement("item");
+        item.setAttribute("name", QString("item %1").arg(i));
+        item.setAttribute("x", i * 100);
+        item.appendChild(document.createTextNode(QString("setting <%1> & more").arg(i)));
+        root.appendChild(item);
+    }
+
+    return document;
+}
+
+// The data as another application would offer it, only the given format is copied
+static QMimeData* foreignCopy(QDomDocument const& document, QString const& format)
+{
+    ItemMimeData const source{document, XmlMimeType};
+    auto copy = new QMimeData;
+    copy->setData(format, source.data(format));
+    return copy;
+}
+
+void test_ItemMimeData::testBinaryRoundTrip()
+{
+    QDomDocument const document = someDocument();
+    QScopedPointer<QMimeData> mimeData{foreignCopy(document, ItemMimeData::BinaryMimeType)};
+    QString error;
+
+    QDomDocument const decoded = ItemMimeData::document(*mimeData, XmlMimeType, &error);
+    QVERIFY2(!decoded.isNull(), qPrintable(error));
+    QCOMPARE(decoded.toString(), document.toString());
+}
+
+void test_ItemMimeData::testXmlRoundTrip()
+{
+    QDomDocument const document = someDocument();
+    QScopedPointer<QMimeData> mimeData{foreignCopy(document, XmlMimeType)};
+    QString error;
+
+    QDomDocument const decoded = ItemMimeData::document(*mimeData, XmlMimeType, &error);
+    QVERIFY2(!decoded.isNull(), qPrintable(error));
+    QCOMPARE(decoded.toString(), document.toString());
+}
+
+void test_ItemMimeData::testOwnDocumentIsCopied()
+{
+    QDomDocument const document = someDocument();
+    QString const original = document.toString();
+    ItemMimeData const mimeData{document, XmlMimeType};
+
+    QDomDocument first = ItemMimeData::document(mimeData, XmlMimeType);
+    first.documentElement().firstChildElement().setAttribute("name", "changed");
+    first.documentElement().removeChild(first.documentElement().lastChild());
+
+    QCOMPARE(ItemMimeData::document(mimeData, XmlMimeType).toString(), original);
+    QCOMPARE(document.toString(), original);
+}
+
+void test_ItemMimeData::testCachedDocumentIsCopied()
+{
+    QDomDocument const document = someDocument();
+    QString const original = document.toString();
+    QScopedPointer<QMimeData> mimeData{foreignCopy(document, ItemMimeData::BinaryMimeType)};
+
+    // the second read is served from the cache
+    QDomDocument first = ItemMimeData::document(*mimeData, XmlMimeType);
+    first.documentElement().firstChildElement().setAttribute("name", "changed");
+    first.documentElement().removeChild(first.documentElement().lastChild());
+
+    QDomDocument second = ItemMimeData::document(*mimeData, XmlMimeType);
+    QCOMPARE(second.toString(), original);
+    second.documentElement().appendChild(second.createElement("extra"));
+
+    QCOMPARE(ItemMimeData::document(*mimeData, XmlMimeType).toString(), original);
+}
+
+void test_ItemMimeData::testDeepBinaryDataFails()
+{
+    QDomDocument document{"items"};
+    QDomNode parent = document;
+
+    for (int i = 0; i < 1000; i++) {
+        parent = parent.appendChild(document.createElement("item"));
+    }
+
+    QScopedPointer<QMimeData> mimeData{foreignCopy(document, ItemMimeData::BinaryMimeType)};
+    QString error;
+
+    QVERIFY(ItemMimeData::document(*mimeData, XmlMimeType, &error).isNull());
+    QVERIFY(!error.isEmpty());
+}
+
+void test_ItemMimeData::testTruncatedBinaryDataFails()
+{
+    ItemMimeData const source{someDocument(), XmlMimeType};
+    QByteArray const binary = source.data(ItemMimeData::BinaryMimeType);
+    QMimeData mimeData;
+    mimeData.setData(ItemMimeData::BinaryMimeType, binary.left(binary.size() / 2));
+    QString error;
+
+    QVERIFY(ItemMimeData::document(mimeData, XmlMimeType, &error).isNull());
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(test_ItemMimeData)
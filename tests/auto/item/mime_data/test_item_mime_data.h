@@ -0,0 +1,20 @@
+#ifndef TEST_ITEM_MIME_DATA_H
+#define TEST_ITEM_MIME_DATA_H
+
+#include <QObject>
+#include <QtTest/QTest>
+
+class test_ItemMimeData : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBinaryRoundTrip();
+    void testXmlRoundTrip();
+    void testOwnDocumentIsCopied();
+    void testCachedDocumentIsCopied();
+    void testDeepBinaryDataFails();
+    void testTruncatedBinaryDataFails();
+};
+
+#endif // TEST_ITEM_MIME_DATA_H
@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemPaint
+
+SOURCES +=  \
+            test_item_paint.cpp
+
+HEADERS +=  \
+            test_item_paint.h
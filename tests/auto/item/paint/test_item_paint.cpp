@@ -0,0 +1,166 @@
+#include "test_item_paint.h"
+
+#include "res/theme.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QWidget>
+
+/**
+ * @brief Counts the calls of paintItemBox
+ */
+class CountingItem : public SomeItem
+{
+public:
+    CountingItem() : SomeItem{"item", 1} {}
+
+    int itemBoxPaints = 0;
+
+protected:
+    void paintItemBox(QPainter* painter) override
+    {
+        itemBoxPaints++;
+        SomeItem::paintItemBox(painter);
+    }
+};
+
+// Paints item like a view which shows it at scale
+static void paintAt(AbstractItem& item, qreal scale)
+{
+    QWidget widget;
+    QImage image{256, 256, QImage::Format_ARGB32_Premultiplied};
+    QPainter painter{&image};
+    painter.scale(scale, scale);
+    QStyleOptionGraphicsItem option;
+    item.paint(&painter, &option, &widget);
+}
+
+static AbstractItem::DetailLevel detailLevelAt(qreal scale)
+{
+    QImage image{16, 16, QImage::Format_ARGB32_Premultiplied};
+    QPainter painter{&image};
+    painter.scale(scale, scale);
+    QStyleOptionGraphicsItem option;
+    return AbstractItem::detailLevel(&option, &painter);
+}
+
+void test_ItemPaint::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemPaint::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemPaint::testDetailLevelFollowsScale()
+{
+    QCOMPARE(detailLevelAt(2.0), AbstractItem::FullDetail);
+    QCOMPARE(detailLevelAt(1.0), AbstractItem::FullDetail);
+    QCOMPARE(detailLevelAt(0.4), AbstractItem::ReducedDetail);
+    QCOMPARE(detailLevelAt(0.1), AbstractItem::LowDetail);
+}
+
+void test_ItemPaint::testLowDetailSkipsItemBox()
+{
+    CountingItem item;
+
+    // only a filled box
+    paintAt(item, 0.1);
+    QCOMPARE(item.itemBoxPaints, 0);
+
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 1);
+}
+
+void test_ItemPaint::testThemeSnapshotResolves()
+{
+    Theme const& theme = Theme::current();
+    QCOMPARE(&Theme::current(), &theme); // resolved once
+
+    QVERIFY(theme.itemBoxBackground.isValid());
+    QVERIFY(theme.itemBoxBorder.isValid());
+    QVERIFY(theme.itemBoxProgress.isValid());
+    QVERIFY(theme.itemNoteBackground.isValid());
+    QVERIFY(theme.connectorSelpointColor.isValid());
+    QVERIFY(theme.itemBoxSelectedPen.color().isValid());
+    QCOMPARE(theme.connectorPen(-1, QPen{Qt::red}).color(), QColor{Qt::red}); // no style registered
+}
+
+void test_ItemPaint::testChangedStyleReloadsTheme()
+{
+    int const transportType = 4711;
+    Theme const& before = Theme::current();
+    QPen const beforePen = before.connectorPen(transportType, QPen{Qt::red});
+
+    AbstractItem::registerConnectorStyle(Qt::blue, transportType);
+
+    Theme const& after = Theme::current();
+    QVERIFY(&after != &before);
+    QCOMPARE(after.connectorPen(transportType, QPen{Qt::red}).color(), QColor{Qt::blue});
+
+    // the retired snapshot stays valid and unchanged for its readers
+    QCOMPARE(before.connectorPen(transportType, QPen{Qt::red}), beforePen);
+}
+
+void test_ItemPaint::testItemBoxCacheIsKeptWithinBucket()
+{
+    CountingItem item;
+
+    paintAt(item, 1.0);
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 1);
+
+    // 1.05 and 1.1 share the next larger bucket
+    paintAt(item, 1.05);
+    paintAt(item, 1.1);
+    QCOMPARE(item.itemBoxPaints, 2);
+}
+
+void test_ItemPaint::testItemBoxCacheChangesAcrossZoomBuckets()
+{
+    CountingItem item;
+
+    for (qreal scale : {1.0, 2.0, 0.6, 1.0}) {
+        paintAt(item, scale);
+    }
+
+    // only the last bucket is kept
+    QCOMPARE(item.itemBoxPaints, 4);
+}
+
+void test_ItemPaint::testItemBoxCacheIsInvalidatedByChanges()
+{
+    CountingItem item;
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 1);
+
+    item.setName("renamed");
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 2);
+
+    item.setSelected(true);
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 3);
+
+    item.setProgress(50);
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 4);
+
+    item.setImage(QImage{8, 8, QImage::Format_ARGB32_Premultiplied});
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 5);
+
+    // a new theme snapshot
+    AbstractItem::registerConnectorStyle(Qt::green, 4712);
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 6);
+
+    paintAt(item, 1.0);
+    QCOMPARE(item.itemBoxPaints, 6);
+}
+
+QTEST_APPLESS_MAIN(test_ItemPaint)
@@ -0,0 +1,33 @@
+#ifndef TEST_ITEM_PAINT_H
+#define TEST_ITEM_PAINT_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemPaint : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // level of detail
+    void testDetailLevelFollowsScale();
+    void testLowDetailSkipsItemBox();
+
+    // theme
+    void testThemeSnapshotResolves();
+    void testChangedStyleReloadsTheme();
+
+    // item box cache
+    void testItemBoxCacheIsKeptWithinBucket();
+    void testItemBoxCacheChangesAcrossZoomBuckets();
+    void testItemBoxCacheIsInvalidatedByChanges();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_PAINT_H
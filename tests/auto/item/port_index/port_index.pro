@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemPortIndex
+
+SOURCES +=  \
+            test_item_port_index.cpp
+
+HEADERS +=  \
+            test_item_port_index.h
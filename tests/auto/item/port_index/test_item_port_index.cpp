@@ -0,0 +1,158 @@
+#include "test_item_port_index.h"
+
+#include "item/item_port_index.h"
+#include "item/item_scene.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "item_test_application.h"
+#include "some_item.h"
+#include "some_transporter.h"
+
+static void indexPorts(ItemPortIndex& index, SomeItem* item)
+{
+    index.update(item->inputs().first());
+    index.update(item->outputs().first());
+}
+
+void test_ItemPortIndex::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemPortIndex::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemPortIndex::testNearestFindsClosestPort()
+{
+    SomeItem itemA{"itemA", 1};
+    SomeItem itemB{"itemB", 2};
+    itemB.setPos(300, 0);
+
+    ItemPortIndex index{60};
+    indexPorts(index, &itemA);
+    indexPorts(index, &itemB);
+
+    auto const inputB = itemB.inputs().first();
+    auto const position = inputB->scenePosition() + QPointF{3, 3};
+
+    QCOMPARE(index.nearest(position, 30, ItemPortIndex::Input, qMetaTypeId<SomeTransporter*>()),
+             static_cast<AbstractItemInputOutputBase*>(inputB));
+}
+
+void test_ItemPortIndex::testDirectionsAreSeparated()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    auto const input = item.inputs().first();
+    auto const output = item.outputs().first();
+
+    QCOMPARE(index.nearest(input->scenePosition(), 5, ItemPortIndex::Input),
+             static_cast<AbstractItemInputOutputBase*>(input));
+    QCOMPARE(index.nearest(output->scenePosition(), 5, ItemPortIndex::Output),
+             static_cast<AbstractItemInputOutputBase*>(output));
+    QVERIFY(index.nearest(input->scenePosition(), 5, ItemPortIndex::Output) == nullptr);
+}
+
+void test_ItemPortIndex::testTransportTypesAreSeparated()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    auto const position = item.inputs().first()->scenePosition();
+    int const otherType = qMetaTypeId<QObject*>();
+
+    QVERIFY(index.nearest(position, 5, ItemPortIndex::Input, otherType) == nullptr);
+    QVERIFY(index.nearest(position, 5, ItemPortIndex::Input, qMetaTypeId<SomeTransporter*>()) != nullptr);
+}
+
+void test_ItemPortIndex::testMaxDistance()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    // farther away than one grid cell
+    auto const position = item.inputs().first()->scenePosition() + QPointF{0, 100};
+
+    QVERIFY(index.nearest(position, 30, ItemPortIndex::Input) == nullptr);
+    QVERIFY(index.nearest(position, 150, ItemPortIndex::Input) != nullptr);
+}
+
+void test_ItemPortIndex::testFilter()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    auto const position = item.inputs().first()->scenePosition();
+    auto const rejectAll = [](AbstractItemInputOutputBase*) {
+        return false;
+    };
+
+    QVERIFY(index.nearest(position, 5, ItemPortIndex::Input, rejectAll) == nullptr);
+}
+
+void test_ItemPortIndex::testUpdateMovesPort()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    auto const input = item.inputs().first();
+    auto const oldPosition = input->scenePosition();
+
+    // into another grid cell
+    item.setPos(1000, 1000);
+    indexPorts(index, &item);
+
+    QVERIFY(index.nearest(oldPosition, 30, ItemPortIndex::Input) == nullptr);
+    QCOMPARE(index.nearest(input->scenePosition(), 5, ItemPortIndex::Input),
+             static_cast<AbstractItemInputOutputBase*>(input));
+}
+
+void test_ItemPortIndex::testRemove()
+{
+    SomeItem item{"item", 1};
+
+    ItemPortIndex index{60};
+    indexPorts(index, &item);
+
+    auto const input = item.inputs().first();
+    index.remove(input);
+    index.remove(input); // removing twice does nothing
+
+    QVERIFY(index.nearest(input->scenePosition(), 5, ItemPortIndex::Input) == nullptr);
+}
+
+void test_ItemPortIndex::testSceneMaintainsIndex()
+{
+    ItemScene scene{{}};
+    auto item = new SomeItem{"item", 1};
+    auto const input = item->inputs().first();
+
+    scene.addItem(item);
+    QCOMPARE(scene.portIndex().nearest(input->scenePosition(), 5, ItemPortIndex::Input),
+             static_cast<AbstractItemInputOutputBase*>(input));
+
+    auto const oldPosition = input->scenePosition();
+    item->setPos(500, 500);
+    QVERIFY(scene.portIndex().nearest(oldPosition, 5, ItemPortIndex::Input) == nullptr);
+    QCOMPARE(scene.portIndex().nearest(input->scenePosition(), 5, ItemPortIndex::Input),
+             static_cast<AbstractItemInputOutputBase*>(input));
+
+    auto const position = input->scenePosition();
+    delete item;
+    QVERIFY(scene.portIndex().nearest(position, 5, ItemPortIndex::Input) == nullptr);
+}
+
+QTEST_APPLESS_MAIN(test_ItemPortIndex)
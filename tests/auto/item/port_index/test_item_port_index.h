@@ -0,0 +1,29 @@
+#ifndef TEST_ITEM_PORT_INDEX_H
+#define TEST_ITEM_PORT_INDEX_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemPortIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testNearestFindsClosestPort();
+    void testDirectionsAreSeparated();
+    void testTransportTypesAreSeparated();
+    void testMaxDistance();
+    void testFilter();
+    void testUpdateMovesPort();
+    void testRemove();
+    void testSceneMaintainsIndex();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_PORT_INDEX_H
@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemRecordStore
+
+SOURCES +=  \
+            test_item_record_store.cpp
+
+HEADERS +=  \
+            test_item_record_store.h
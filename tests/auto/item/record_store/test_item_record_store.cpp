@@ -0,0 +1,166 @@
+#include "test_item_record_store.h"
+
+#include "item/item_record_store.h"
+#include "item/item_serializer.h"
+#include "item/item_scene.h"
+#include "item/item_connector.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QSet>
+
+static QSet<QString> itemNames(QDomElement const& items)
+{
+    QSet<QString> names;
+
+    for (QDomElement element = items.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (ItemSerializer::isItemElement(element)) {
+            names.insert(ItemSerializer::itemName(element));
+        }
+    }
+
+    return names;
+}
+
+static int countConnectors(QDomElement const& items)
+{
+    int count = 0;
+
+    for (QDomElement element = items.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        count += ItemSerializer::isConnectorElement(element) ? 1 : 0;
+    }
+
+    return count;
+}
+
+void test_ItemRecordStore::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemRecordStore::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemRecordStore::init()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"a", 1};
+    auto itemB = new SomeItem{"b", 2};
+    auto itemC = new SomeItem{"c", 3};
+    itemB->setPos(200, 0);
+    itemC->setPos(5000, 5000);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+    scene.addItem(itemC);
+
+    auto connector = new Item_Connector{itemA->outputs().first(), itemB->inputs().first()};
+    scene.addItem(connector);
+
+    document_ = QDomDocument{};
+    items_ = document_.createElement("items");
+    document_.appendChild(items_);
+    QVERIFY(ItemSerializer::saveToXml(document_, items_, {itemA, itemB, itemC, connector}));
+    items_.appendChild(document_.createElement("other"));
+}
+
+void test_ItemRecordStore::testLoadKeepsItemsAndConnectors()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    store.load(items_, remainingDocument);
+
+    QVERIFY(!store.isEmpty());
+    QCOMPARE(store.count(), 3);
+    QVERIFY(store.bounds().contains(QPointF{0, 0}));
+    QVERIFY(store.bounds().contains(QPointF{5000, 5000}));
+}
+
+void test_ItemRecordStore::testLoadReturnsOtherElements()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    QDomElement const remaining = store.load(items_, remainingDocument);
+
+    QCOMPARE(remaining.tagName(), QString{"items"});
+    QCOMPARE(remaining.childNodes().count(), 1);
+    QCOMPARE(remaining.firstChildElement().tagName(), QString{"other"});
+}
+
+void test_ItemRecordStore::testTakeReturnsWholeComponents()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    store.load(items_, remainingDocument);
+
+    // only "a" is in the area, but "b" is connected to it
+    QDomDocument document;
+    QDomElement const taken = store.take({-10, -10, 20, 20}, document);
+
+    QCOMPARE(itemNames(taken), (QSet<QString>{"a", "b"}));
+    QCOMPARE(countConnectors(taken), 1);
+    QVERIFY(ItemSerializer::isConnectorElement(taken.lastChildElement())); // after the items it references
+    QCOMPARE(store.count(), 1);
+    QVERIFY(!store.bounds().contains(QPointF{0, 0}));
+
+    QDomElement const rest = store.take({4990, 4990, 20, 20}, document);
+    QCOMPARE(itemNames(rest), QSet<QString>{"c"});
+    QVERIFY(store.isEmpty());
+}
+
+void test_ItemRecordStore::testTakeOutsideReturnsNothing()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    store.load(items_, remainingDocument);
+
+    QDomDocument document;
+    QVERIFY(!store.take({2000, 2000, 100, 100}, document).hasChildNodes());
+    QCOMPARE(store.count(), 3);
+}
+
+void test_ItemRecordStore::testSaveRenumbersIds()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    store.load(items_, remainingDocument);
+
+    QDomDocument document;
+    QDomElement xml = document.createElement("items");
+    store.saveToXml(document, xml, 10);
+
+    QHash<QString, qint32> ids;
+    QDomElement connector;
+
+    for (QDomElement element = xml.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        if (ItemSerializer::isItemElement(element)) {
+            ids.insert(ItemSerializer::itemName(element), ItemSerializer::itemId(element));
+        } else if (ItemSerializer::isConnectorElement(element)) {
+            connector = element;
+        }
+    }
+
+    QCOMPARE(ids.size(), 3);
+    QCOMPARE((QSet<qint32>{ids.value("a"), ids.value("b"), ids.value("c")}), (QSet<qint32>{10, 11, 12}));
+    QVERIFY(!connector.isNull());
+    QCOMPARE(ItemSerializer::connectorItemIds(connector), qMakePair(ids.value("a"), ids.value("b")));
+}
+
+void test_ItemRecordStore::testClear()
+{
+    ItemRecordStore store{500};
+    QDomDocument remainingDocument;
+    store.load(items_, remainingDocument);
+    store.clear();
+
+    QVERIFY(store.isEmpty());
+    QCOMPARE(store.count(), 0);
+
+    QDomDocument document;
+    QVERIFY(!store.take({-10, -10, 20, 20}, document).hasChildNodes());
+}
+
+QTEST_APPLESS_MAIN(test_ItemRecordStore)
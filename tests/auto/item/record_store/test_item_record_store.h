@@ -0,0 +1,33 @@
+#ifndef TEST_ITEM_RECORD_STORE_H
+#define TEST_ITEM_RECORD_STORE_H
+
+#include <QDomDocument>
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemRecordStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void testLoadKeepsItemsAndConnectors();
+    void testLoadReturnsOtherElements();
+    void testTakeReturnsWholeComponents();
+    void testTakeOutsideReturnsNothing();
+    void testSaveRenumbersIds();
+    void testClear();
+
+private:
+    QScopedPointer<class QApplication> application_;
+
+    // items "a" and "b" connected at the origin, "c" on its own far away, and an element which is no item
+    QDomDocument document_;
+    QDomElement items_;
+};
+
+#endif // TEST_ITEM_RECORD_STORE_H
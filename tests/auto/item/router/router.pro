@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemRouter
+
+SOURCES +=  \
+            test_item_router.cpp
+
+HEADERS +=  \
+            test_item_router.h
@@ -0,0 +1,220 @@
+#include "test_item_router.h"
+
+#include "item/item_router.h"
+#include "item/item_scene.h"
+#include "item/item_connector.h"
+#include "item/item_input.h"
+#include "item/item_output.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QGraphicsRectItem>
+
+// The corners of a route, in the format of Item_Connector (see ItemRouter::route)
+static QVector<QPointF> routePoints(QPointF const& start, QPointF const& end, QList<qreal> const& coords)
+{
+    QVector<QPointF> points{start};
+    bool horizontal = true;
+
+    for (qreal coordinate : coords) {
+        QPointF const& last = points.last();
+        points.append(horizontal ? QPointF{coordinate, last.y()} : QPointF{last.x(), coordinate});
+        horizontal = !horizontal;
+    }
+
+    points.append(end);
+    return points;
+}
+
+// Whether one of the segments runs through the interior of box
+static bool crosses(QVector<QPointF> const& points, QRectF const& box)
+{
+    for (int i = 1; i < points.size(); i++) {
+        QRectF const segment = QRectF{points.at(i - 1), points.at(i)}.normalized();
+        bool const overlapsX = qMax(segment.left(), box.left()) < qMin(segment.right(), box.right()) ||
+                               (segment.width() == 0 && segment.left() > box.left() && segment.left() < box.right());
+        bool const overlapsY = qMax(segment.top(), box.top()) < qMin(segment.bottom(), box.bottom()) ||
+                               (segment.height() == 0 && segment.top() > box.top() && segment.top() < box.bottom());
+
+        if (overlapsX && overlapsY) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool isOrthogonal(QVector<QPointF> const& points)
+{
+    for (int i = 1; i < points.size(); i++) {
+        if (points.at(i - 1).x() != points.at(i).x() && points.at(i - 1).y() != points.at(i).y()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Places item so that its box is centered on the middle between the ports of connector
+static void placeOnRoute(SomeItem* item, Item_Connector const* connector)
+{
+    QPointF const middle = (connector->get_output()->scenePosition() + connector->get_input()->scenePosition()) / 2;
+    item->setPos(middle - item->boundingRect().center());
+}
+
+void test_ItemRouter::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemRouter::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemRouter::testFreeRouteIsStraight()
+{
+    ItemRouter router{10, 25};
+    QList<qreal> coords;
+
+    QVERIFY(router.route({0, 0}, {300, 0}, coords));
+    QVERIFY(coords.isEmpty());
+
+    QVERIFY(router.route({0, 0}, {300, 100}, coords));
+    auto const points = routePoints({0, 0}, {300, 100}, coords);
+    QVERIFY(isOrthogonal(points));
+
+    // the route leaves the output and enters the input horizontally
+    QCOMPARE(points.at(1).y(), 0.0);
+    QCOMPARE(points.at(points.size() - 2).y(), 100.0);
+}
+
+void test_ItemRouter::testRouteAvoidsObstacle()
+{
+    QGraphicsRectItem obstacle;
+    QRectF const box{100, -50, 100, 100};
+
+    ItemRouter router{10, 25};
+    router.updateObstacle(&obstacle, box);
+
+    QList<qreal> coords;
+    QVERIFY(router.route({0, 0}, {300, 0}, coords));
+
+    auto const points = routePoints({0, 0}, {300, 0}, coords);
+    QVERIFY(isOrthogonal(points));
+    QVERIFY(!crosses(points, box));
+    QVERIFY(!coords.isEmpty());
+}
+
+void test_ItemRouter::testUpdatedObstacleIsAvoided()
+{
+    QGraphicsRectItem obstacle;
+
+    ItemRouter router{10, 25};
+    router.updateObstacle(&obstacle, {100, 200, 100, 100});
+
+    QList<qreal> coords;
+    QVERIFY(router.route({0, 0}, {300, 0}, coords));
+    QVERIFY(coords.isEmpty());
+
+    QRectF const moved{100, -50, 100, 100};
+    router.updateObstacle(&obstacle, moved);
+
+    QVERIFY(router.route({0, 0}, {300, 0}, coords));
+    QVERIFY(!crosses(routePoints({0, 0}, {300, 0}, coords), moved));
+}
+
+void test_ItemRouter::testRemovedObstacleIsIgnored()
+{
+    QGraphicsRectItem obstacle;
+
+    ItemRouter router{10, 25};
+    router.updateObstacle(&obstacle, {100, -50, 100, 100});
+    router.removeObstacle(&obstacle);
+    router.removeObstacle(&obstacle); // removing twice does nothing
+
+    QList<qreal> coords;
+    QVERIFY(router.route({0, 0}, {300, 0}, coords));
+    QVERIFY(coords.isEmpty());
+}
+
+void test_ItemRouter::testBlockedEndPointFails()
+{
+    QGraphicsRectItem obstacle;
+
+    ItemRouter router{10, 25};
+    router.updateObstacle(&obstacle, {250, -50, 100, 100}); // covers the end of the input stub
+
+    QList<qreal> coords;
+    QVERIFY(!router.route({0, 0}, {300, 0}, coords));
+}
+
+void test_ItemRouter::testRoutesIntersectingBox()
+{
+    ItemRouter router{10, 25};
+    QGraphicsRectItem near;
+    QGraphicsRectItem far;
+    QGraphicsRectItem wide;
+
+    router.updateRoute(&near, {0, 0, 100, 50});
+    router.updateRoute(&far, {1000, 1000, 100, 50});
+    router.updateRoute(&wide, {-500, 20, 2000, 10}); // spans several cells
+
+    QList<QGraphicsItem const*> routes = router.routesIntersecting({50, 0, 100, 100});
+    QCOMPARE(routes.size(), 2);
+    QVERIFY(routes.contains(&near));
+    QVERIFY(routes.contains(&wide));
+
+    router.updateRoute(&near, {1000, 1000, 100, 50});
+    router.removeRoute(&wide);
+    QVERIFY(router.routesIntersecting({50, 0, 100, 100}).isEmpty());
+    QCOMPARE(router.routesIntersecting({1050, 1000, 10, 10}).size(), 2);
+}
+
+void test_ItemRouter::testConnectorIsReroutedWhenEnteringScene()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    auto obstacle = new SomeItem{"obstacle", 3};
+    itemB->setPos(600, 0);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    // like a loaded connector, routed before it is part of the scene
+    auto connector = new Item_Connector{itemA->outputs().first(), itemB->inputs().first()};
+    connector->do_update();
+    placeOnRoute(obstacle, connector);
+    scene.addItem(obstacle);
+    QVERIFY(connector->shape().intersects(obstacle->sceneBoundingRect()));
+
+    scene.addItem(connector);
+    QCoreApplication::processEvents();
+    QVERIFY(!connector->shape().intersects(obstacle->sceneBoundingRect()));
+}
+
+void test_ItemRouter::testConnectorIsReroutedWhenItemIsMovedOntoIt()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    auto obstacle = new SomeItem{"obstacle", 3};
+    itemB->setPos(600, 0);
+    obstacle->setPos(300, 500);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+    scene.addItem(obstacle);
+
+    auto connector = new Item_Connector{itemA->outputs().first(), itemB->inputs().first()};
+    scene.addItem(connector);
+    QCoreApplication::processEvents();
+
+    // neither end point moves, only the item on the route
+    placeOnRoute(obstacle, connector);
+    QVERIFY(connector->shape().intersects(obstacle->sceneBoundingRect()));
+
+    QCoreApplication::processEvents();
+    QVERIFY(!connector->shape().intersects(obstacle->sceneBoundingRect()));
+}
+
+QTEST_APPLESS_MAIN(test_ItemRouter)
@@ -0,0 +1,32 @@
+#ifndef TEST_ITEM_ROUTER_H
+#define TEST_ITEM_ROUTER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemRouter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // router
+    void testFreeRouteIsStraight();
+    void testRouteAvoidsObstacle();
+    void testUpdatedObstacleIsAvoided();
+    void testRemovedObstacleIsIgnored();
+    void testBlockedEndPointFails();
+    void testRoutesIntersectingBox();
+
+    // connectors in the scene
+    void testConnectorIsReroutedWhenEnteringScene();
+    void testConnectorIsReroutedWhenItemIsMovedOntoIt();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_ROUTER_H
@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../item_test.pri)
+
+TARGET = testItemScene
+
+SOURCES +=  \
+            test_item_scene.cpp
+
+HEADERS +=  \
+            test_item_scene.h
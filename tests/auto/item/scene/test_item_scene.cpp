@@ -0,0 +1,82 @@
+#include "test_item_scene.h"
+
+#include "item/item_scene.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+// the area itemsBoundingRect() uses for an item, including its name label
+static QRectF itemBounds(QGraphicsItem const* item)
+{
+    return item->sceneBoundingRect() | item->mapRectToScene(item->childrenBoundingRect());
+}
+
+void test_ItemScene::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ItemScene::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ItemScene::testContentBoundsContainAddedItems()
+{
+    ItemScene scene{{}};
+    QVERIFY(scene.contentBounds().isNull());
+
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    itemB->setPos(300, 200);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    QCOMPARE(scene.contentBounds(), itemBounds(itemA) | itemBounds(itemB));
+}
+
+void test_ItemScene::testContentBoundsFollowMovedItem()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"itemA", 1};
+    auto itemB = new SomeItem{"itemB", 2};
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    itemB->setPos(500, 0);
+    QCOMPARE(scene.contentBounds(), itemBounds(itemA) | itemBounds(itemB));
+
+    // moving back shrinks the bounds again
+    itemB->setPos(100, 0);
+    QCOMPARE(scene.contentBounds(), itemBounds(itemA) | itemBounds(itemB));
+}
+
+void test_ItemScene::testContentBoundsShrinkOnRemove()
+{
+    ItemScene scene{{}};
+    auto itemA = new SomeItem{"itemA", 1};
+    QScopedPointer<SomeItem> itemB{new SomeItem{"itemB", 2}};
+    itemB->setPos(500, 500);
+    scene.addItem(itemA);
+    scene.addItem(itemB.data());
+
+    scene.removeItem(itemB.data());
+    QCOMPARE(scene.contentBounds(), itemBounds(itemA));
+}
+
+void test_ItemScene::testContentBoundsFollowRenamedItem()
+{
+    ItemScene scene{{}};
+    auto item = new SomeItem{"item", 1};
+    scene.addItem(item);
+    auto const before = scene.contentBounds();
+
+    // the name label is wider than the item
+    item->setName(QString(80, 'w'));
+    QVERIFY(scene.contentBounds().width() > before.width());
+    QCOMPARE(scene.contentBounds(), itemBounds(item));
+
+    item->setName("i");
+    QCOMPARE(scene.contentBounds(), itemBounds(item));
+}
+
+QTEST_APPLESS_MAIN(test_ItemScene)
@@ -0,0 +1,26 @@
+#ifndef TEST_ITEM_SCENE_H
+#define TEST_ITEM_SCENE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ItemScene : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // content bounds
+    void testContentBoundsContainAddedItems();
+    void testContentBoundsFollowMovedItem();
+    void testContentBoundsShrinkOnRemove();
+    void testContentBoundsFollowRenamedItem();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_ITEM_SCENE_H
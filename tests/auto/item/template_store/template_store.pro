@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testItemTemplateStore
+
+SOURCES +=  \
+            test_item_template_store.cpp
+
+HEADERS +=  \
+            test_item_template_store.h
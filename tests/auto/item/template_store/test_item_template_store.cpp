@@ -0,0 +1,121 @@
+#include "test_item_template_store.h"
+
+#include "item/item_template_store.h"
+
+#include <QFile>
+
+QDomDocument test_ItemTemplateStore::someItems(QString const& name) const
+{
+    QDomDocument document{};
+    auto element = document.createElement("testItems");
+    element.setAttribute("name", name);
+    document.appendChild(element);
+    return document;
+}
+
+void test_ItemTemplateStore::init()
+{
+    // every test gets its own, empty library
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+}
+
+void test_ItemTemplateStore::testEmptyDirectoryHasNoEntries()
+{
+    ItemTemplateStore store{directory_->path()};
+    QCOMPARE(store.entries().size(), 0);
+}
+
+void test_ItemTemplateStore::testAddWritesBodyAndIndex()
+{
+    ItemTemplateStore store{directory_->path()};
+    auto const id = store.add("templateA", someItems("a"), QPixmap{});
+
+    QVERIFY(!id.isEmpty());
+    QCOMPARE(store.entries().size(), 1);
+    QCOMPARE(store.entries().first().id, id);
+    QCOMPARE(store.entries().first().name, QString{"templateA"});
+    QVERIFY(QFile::exists(store.bodyFilePath(id)));
+
+    QDomDocument body{};
+    QVERIFY(body.setContent(store.loadBody(id)));
+    QCOMPARE(body.documentElement().attribute("name"), QString{"a"});
+}
+
+void test_ItemTemplateStore::testEntriesKeepOrderAfterReopen()
+{
+    QString idA;
+    QString idB;
+
+    {
+        ItemTemplateStore store{directory_->path()};
+        idA = store.add("templateA", someItems("a"), QPixmap{});
+        idB = store.add("templateB", someItems("b"), QPixmap{});
+    }
+
+    ItemTemplateStore reopened{directory_->path()};
+    QCOMPARE(reopened.entries().size(), 2);
+    QCOMPARE(reopened.entries().at(0).id, idA);
+    QCOMPARE(reopened.entries().at(1).id, idB);
+    QCOMPARE(reopened.entries().at(1).name, QString{"templateB"});
+}
+
+void test_ItemTemplateStore::testRenameOnlyChangesName()
+{
+    ItemTemplateStore store{directory_->path()};
+    auto const id = store.add("templateA", someItems("a"), QPixmap{});
+    auto const bodyBefore = store.loadBody(id);
+
+    QVERIFY(store.rename(id, "renamed"));
+    QCOMPARE(store.loadBody(id), bodyBefore);
+
+    ItemTemplateStore reopened{directory_->path()};
+    QCOMPARE(reopened.entries().size(), 1);
+    QCOMPARE(reopened.entries().first().name, QString{"renamed"});
+}
+
+void test_ItemTemplateStore::testRemoveDeletesFiles()
+{
+    ItemTemplateStore store{directory_->path()};
+    auto const idA = store.add("templateA", someItems("a"), QPixmap{});
+    auto const idB = store.add("templateB", someItems("b"), QPixmap{});
+    auto const bodyA = store.bodyFilePath(idA);
+
+    QVERIFY(store.remove(idA));
+    QVERIFY(!QFile::exists(bodyA));
+    QCOMPARE(store.entries().size(), 1);
+    QCOMPARE(store.entries().first().id, idB);
+
+    ItemTemplateStore reopened{directory_->path()};
+    QCOMPARE(reopened.entries().size(), 1);
+    QCOMPARE(reopened.entries().first().id, idB);
+}
+
+void test_ItemTemplateStore::testUnknownIdFails()
+{
+    ItemTemplateStore store{directory_->path()};
+    store.add("templateA", someItems("a"), QPixmap{});
+
+    QVERIFY(!store.remove("unknown"));
+    QVERIFY(!store.rename("unknown", "name"));
+    QVERIFY(store.loadBody("unknown").isEmpty());
+    QCOMPARE(store.entries().size(), 1);
+}
+
+void test_ItemTemplateStore::testEntryWithoutBodyIsSkipped()
+{
+    QString id;
+
+    {
+        ItemTemplateStore store{directory_->path()};
+        id = store.add("templateA", someItems("a"), QPixmap{});
+        store.add("templateB", someItems("b"), QPixmap{});
+        QVERIFY(QFile::remove(store.bodyFilePath(id)));
+    }
+
+    ItemTemplateStore reopened{directory_->path()};
+    QCOMPARE(reopened.entries().size(), 1);
+    QCOMPARE(reopened.entries().first().name, QString{"templateB"});
+}
+
+QTEST_MAIN(test_ItemTemplateStore)
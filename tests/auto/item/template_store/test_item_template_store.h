@@ -0,0 +1,30 @@
+#ifndef TEST_ITEM_TEMPLATE_STORE_H
+#define TEST_ITEM_TEMPLATE_STORE_H
+
+#include <QDomDocument>
+#include <QObject>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+class test_ItemTemplateStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testEmptyDirectoryHasNoEntries();
+    void testAddWritesBodyAndIndex();
+    void testEntriesKeepOrderAfterReopen();
+    void testRenameOnlyChangesName();
+    void testRemoveDeletesFiles();
+    void testUnknownIdFails();
+    void testEntryWithoutBodyIsSkipped();
+
+private:
+    QDomDocument someItems(QString const& name) const;
+
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_ITEM_TEMPLATE_STORE_H
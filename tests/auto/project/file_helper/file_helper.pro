@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testFileHelper
+
+SOURCES +=  \
+            test_file_helper.cpp
+
+HEADERS +=  \
+            test_file_helper.h
@@ -0,0 +1,126 @@
+#include "test_file_helper.h"
+
+#include "project/file_helper.h"
+
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+
+// Lets the modification time of a rewritten file differ on file systems with a resolution of a second
+static void waitForNextModificationTime()
+{
+    QTest::qSleep(1100);
+}
+
+QString test_FileHelper::writeFile(QString const& name, QByteArray const& content) const
+{
+    QString const filePath = directory_->filePath(name);
+    QFile file{filePath};
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(content);
+    }
+
+    return filePath;
+}
+
+void test_FileHelper::init()
+{
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+}
+
+void test_FileHelper::testSignatureOfMissingFileIsEmpty()
+{
+    auto const signature = FileHelper::fileSignature(directory_->filePath("missing.xml"));
+
+    QVERIFY(signature.lastModified.isNull());
+    QCOMPARE(signature.size, qint64{-1});
+    QVERIFY(signature.contentHash.isEmpty());
+}
+
+void test_FileHelper::testUnchangedFileIsNotReported()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    auto signature = FileHelper::fileSignature(filePath);
+
+    QCOMPARE(signature.size, qint64{10});
+    QVERIFY(!signature.contentHash.isEmpty());
+    QVERIFY(!FileHelper::updateFileSignature(filePath, &signature));
+}
+
+void test_FileHelper::testTouchedFileIsNotReported()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    auto signature = FileHelper::fileSignature(filePath);
+
+    // e.g. an autosave which writes the same content again
+    waitForNextModificationTime();
+    writeFile("project.xml", "<project/>");
+
+    QVERIFY(!FileHelper::updateFileSignature(filePath, &signature));
+    QCOMPARE(signature.lastModified, QFileInfo(filePath).lastModified());
+}
+
+void test_FileHelper::testChangedContentIsReported()
+{
+    auto const filePath = writeFile("project.xml", "<project a=\"1\"/>");
+    auto signature = FileHelper::fileSignature(filePath);
+
+    waitForNextModificationTime();
+    writeFile("project.xml", "<project a=\"2\"/>"); // same size
+
+    QVERIFY(FileHelper::updateFileSignature(filePath, &signature));
+    QVERIFY(!FileHelper::updateFileSignature(filePath, &signature));
+}
+
+void test_FileHelper::testChangedSizeIsReported()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    auto signature = FileHelper::fileSignature(filePath);
+
+    writeFile("project.xml", "<project name=\"p\"/>");
+
+    QVERIFY(FileHelper::updateFileSignature(filePath, &signature));
+    QCOMPARE(signature.size, qint64{19});
+}
+
+void test_FileHelper::testRemovedFileIsReported()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    auto signature = FileHelper::fileSignature(filePath);
+
+    QVERIFY(QFile::remove(filePath));
+    QVERIFY(FileHelper::updateFileSignature(filePath, &signature));
+    QCOMPARE(signature.size, qint64{-1});
+
+    // created again with the same content
+    writeFile("project.xml", "<project/>");
+    QVERIFY(FileHelper::updateFileSignature(filePath, &signature));
+}
+
+void test_FileHelper::testHeaderContainsOnlyRootAttributes()
+{
+    // the rest of the file is not parsed, so it does not even have to be well formed
+    auto const filePath = writeFile("project.xml",
+                                    "<?xml version=\"1.0\"?>\n"
+                                    "<project name=\"p\" description=\"d\">"
+                                    "<GraphicsItem name=\"a\"/>"
+                                    "<unclosed>");
+
+    auto const document = FileHelper::domDocumentHeaderFromXMLFile(filePath);
+    auto const root = document.documentElement();
+
+    QCOMPARE(root.tagName(), QString{"project"});
+    QCOMPARE(root.attribute("name"), QString{"p"});
+    QCOMPARE(root.attribute("description"), QString{"d"});
+    QVERIFY(!root.hasChildNodes());
+    QVERIFY(FileHelper::domDocumentFromXMLFile(filePath).isNull());
+}
+
+void test_FileHelper::testHeaderOfMissingFileIsNull()
+{
+    QVERIFY(FileHelper::domDocumentHeaderFromXMLFile(directory_->filePath("missing.xml")).isNull());
+}
+
+QTEST_MAIN(test_FileHelper)
@@ -0,0 +1,34 @@
+#ifndef TEST_FILE_HELPER_H
+#define TEST_FILE_HELPER_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+class test_FileHelper : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // signature
+    void testSignatureOfMissingFileIsEmpty();
+    void testUnchangedFileIsNotReported();
+    void testTouchedFileIsNotReported();
+    void testChangedContentIsReported();
+    void testChangedSizeIsReported();
+    void testRemovedFileIsReported();
+
+    // header
+    void testHeaderContainsOnlyRootAttributes();
+    void testHeaderOfMissingFileIsNull();
+
+private:
+    QString writeFile(QString const& name, QByteArray const& content) const;
+
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_FILE_HELPER_H
@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testFileWatchService
+
+SOURCES +=  \
+            test_file_watch_service.cpp
+
+HEADERS +=  \
+            test_file_watch_service.h
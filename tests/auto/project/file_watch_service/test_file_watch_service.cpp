@@ -0,0 +1,158 @@
+#include "test_file_watch_service.h"
+
+#include "project/file_watch_service.h"
+#include "project/project_manager_config.h"
+
+#include <QFile>
+
+// Long enough for the file system to report a change and for the service to dispatch it
+static int const NotificationTimeout = FileChangedDelay + 2000;
+
+QString test_FileWatchService::writeFile(QString const& name, QByteArray const& content) const
+{
+    QString const filePath = directory_->filePath(name);
+    QFile file{filePath};
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(content);
+    }
+
+    return filePath;
+}
+
+void test_FileWatchService::init()
+{
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+}
+
+void test_FileWatchService::testBurstIsNotifiedOnce()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QObject receiver;
+    QStringList notified;
+    FileWatchService::instance()->watch(filePath, &receiver, [&notified](QString const& path) {
+        notified.append(path);
+    });
+
+    // e.g. an editor which writes the file in several steps
+    for (int i = 0; i < 5; i++) {
+        writeFile("project.xml", QByteArray("<project step=\"") + QByteArray::number(i) + "\"/>");
+        QTest::qWait(FileChangedDelay / 10);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(notified.size(), 1, NotificationTimeout);
+    QCOMPARE(notified.first(), filePath);
+
+    QTest::qWait(FileChangedDelay * 2);
+    QCOMPARE(notified.size(), 1);
+}
+
+void test_FileWatchService::testAllReceiversAreNotified()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QObject project;
+    QObject workspace;
+    int projectCalls = 0;
+    int workspaceCalls = 0;
+    FileWatchService::instance()->watch(filePath, &project, [&projectCalls](QString const&) {
+        projectCalls++;
+    });
+    FileWatchService::instance()->watch(filePath, &workspace, [&workspaceCalls](QString const&) {
+        workspaceCalls++;
+    });
+
+    writeFile("project.xml", "<project name=\"p\"/>");
+
+    QTRY_COMPARE_WITH_TIMEOUT(projectCalls, 1, NotificationTimeout);
+    QTRY_COMPARE_WITH_TIMEOUT(workspaceCalls, 1, NotificationTimeout);
+}
+
+void test_FileWatchService::testUnwatchStopsNotifications()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QObject receiver;
+    QObject other;
+    int receiverCalls = 0;
+    int otherCalls = 0;
+    FileWatchService::instance()->watch(filePath, &receiver, [&receiverCalls](QString const&) {
+        receiverCalls++;
+    });
+    FileWatchService::instance()->watch(filePath, &other, [&otherCalls](QString const&) {
+        otherCalls++;
+    });
+
+    QVERIFY(FileWatchService::instance()->isWatching(filePath, &receiver));
+    FileWatchService::instance()->unwatch(filePath, &receiver);
+    QVERIFY(!FileWatchService::instance()->isWatching(filePath, &receiver));
+    QVERIFY(FileWatchService::instance()->isWatching(filePath, &other));
+
+    writeFile("project.xml", "<project name=\"p\"/>");
+
+    QTRY_COMPARE_WITH_TIMEOUT(otherCalls, 1, NotificationTimeout);
+    QCOMPARE(receiverCalls, 0);
+}
+
+void test_FileWatchService::testDestroyedReceiverIsUnwatched()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QScopedPointer<QObject> receiver{new QObject};
+    QObject other;
+    int receiverCalls = 0;
+    int otherCalls = 0;
+    FileWatchService::instance()->watch(filePath, receiver.data(), [&receiverCalls](QString const&) {
+        receiverCalls++;
+    });
+    FileWatchService::instance()->watch(filePath, &other, [&otherCalls](QString const&) {
+        otherCalls++;
+    });
+
+    QObject* const destroyed = receiver.data();
+    receiver.reset();
+    QVERIFY(!FileWatchService::instance()->isWatching(filePath, destroyed));
+
+    writeFile("project.xml", "<project name=\"p\"/>");
+
+    QTRY_COMPARE_WITH_TIMEOUT(otherCalls, 1, NotificationTimeout);
+    QCOMPARE(receiverCalls, 0);
+}
+
+void test_FileWatchService::testFileReplacedByRenameIsStillWatched()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QObject receiver;
+    int calls = 0;
+    FileWatchService::instance()->watch(filePath, &receiver, [&calls](QString const&) {
+        calls++;
+    });
+
+    // the way editors save: write a temporary file and rename it over the watched one
+    auto const temporaryPath = writeFile("project.xml.tmp", "<project name=\"p\"/>");
+    QVERIFY(QFile::remove(filePath));
+    QVERIFY(QFile::rename(temporaryPath, filePath));
+
+    QTRY_COMPARE_WITH_TIMEOUT(calls, 1, NotificationTimeout);
+
+    // the replaced file is watched as well
+    writeFile("project.xml", "<project name=\"q\"/>");
+    QTRY_COMPARE_WITH_TIMEOUT(calls, 2, NotificationTimeout);
+}
+
+void test_FileWatchService::testRemovedFileIsNotifiedWhenCreatedAgain()
+{
+    auto const filePath = writeFile("project.xml", "<project/>");
+    QObject receiver;
+    int calls = 0;
+    FileWatchService::instance()->watch(filePath, &receiver, [&calls](QString const&) {
+        calls++;
+    });
+
+    QVERIFY(QFile::remove(filePath));
+    QTRY_COMPARE_WITH_TIMEOUT(calls, 1, NotificationTimeout);
+
+    writeFile("project.xml", "<project/>");
+    QTRY_COMPARE_WITH_TIMEOUT(calls, 2, NotificationTimeout);
+    QVERIFY(FileWatchService::instance()->isWatching(filePath, &receiver));
+}
+
+QTEST_MAIN(test_FileWatchService)
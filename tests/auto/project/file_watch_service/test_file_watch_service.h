@@ -0,0 +1,29 @@
+#ifndef TEST_FILE_WATCH_SERVICE_H
+#define TEST_FILE_WATCH_SERVICE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+class test_FileWatchService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testBurstIsNotifiedOnce();
+    void testAllReceiversAreNotified();
+    void testUnwatchStopsNotifications();
+    void testDestroyedReceiverIsUnwatched();
+    void testFileReplacedByRenameIsStillWatched();
+    void testRemovedFileIsNotifiedWhenCreatedAgain();
+
+private:
+    QString writeFile(QString const& name, QByteArray const& content) const;
+
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_FILE_WATCH_SERVICE_H
@@ -0,0 +1,9 @@
+include(../../testcase.pri)
+
+TARGET = testFileWorkspaceIndex
+
+SOURCES +=  \
+            test_file_workspace_index.cpp
+
+HEADERS +=  \
+            test_file_workspace_index.h
@@ -0,0 +1,212 @@
+#include "test_file_workspace_index.h"
+
+#include "project/file_workspace_index.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+// Lets the modification time of a rewritten file differ on file systems with a resolution of a second
+static void waitForNextModificationTime()
+{
+    QTest::qSleep(1100);
+}
+
+static QImage someThumbnail()
+{
+    QImage thumbnail{8, 8, QImage::Format_ARGB32};
+    thumbnail.fill(Qt::red);
+    return thumbnail;
+}
+
+QString test_FileWorkspaceIndex::writeFile(QString const& name, QByteArray const& content) const
+{
+    QString const filePath = directory_->filePath(name);
+    QFile file{filePath};
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(content);
+    }
+
+    return filePath;
+}
+
+void test_FileWorkspaceIndex::init()
+{
+    directory_.reset(new QTemporaryDir{});
+    QVERIFY(directory_->isValid());
+}
+
+void test_FileWorkspaceIndex::testScanReadsRootElement()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\" version=\"2.0\"><GraphicsItem/></project>");
+
+    auto const entry = FileWorkspaceIndex::scan(filePath, false);
+    QCOMPARE(entry.rootTag, QString{"project"});
+    QCOMPARE(entry.attributes.value("name"), QString{"a"});
+    QCOMPARE(entry.attributes.value("version"), QString{"2.0"});
+    QCOMPARE(entry.size, QFileInfo(filePath).size());
+    QCOMPARE(entry.lastModified, QFileInfo(filePath).lastModified());
+    QVERIFY(entry.contentHash.isEmpty());
+
+    QVERIFY(!FileWorkspaceIndex::scan(filePath, true).contentHash.isEmpty());
+}
+
+void test_FileWorkspaceIndex::testScanOfMissingFileIsEmpty()
+{
+    auto const entry = FileWorkspaceIndex::scan(directory_->filePath("missing.tpro"), true);
+
+    QVERIFY(entry.rootTag.isEmpty());
+    QCOMPARE(entry.size, qint64{-1});
+}
+
+void test_FileWorkspaceIndex::testHeaderDomDocument()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\" description=\"d\"><GraphicsItem/></project>");
+
+    auto const header = FileWorkspaceIndex::headerDomDocument(FileWorkspaceIndex::scan(filePath, false));
+    QCOMPARE(header.documentElement().tagName(), QString{"project"});
+    QCOMPARE(header.documentElement().attribute("name"), QString{"a"});
+    QCOMPARE(header.documentElement().attribute("description"), QString{"d"});
+    QVERIFY(!header.documentElement().hasChildNodes());
+
+    QVERIFY(FileWorkspaceIndex::headerDomDocument(FileWorkspaceIndex::Entry{}).isNull());
+}
+
+void test_FileWorkspaceIndex::testIndexFileIsNextToWorkspace()
+{
+    FileWorkspaceIndex index{directory_->filePath("workspace.twsp")};
+    QCOMPARE(index.filePath(), directory_->filePath(".workspace.twspidx"));
+}
+
+void test_FileWorkspaceIndex::testSaveAndLoad()
+{
+    auto const filePathA = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto const filePathB = writeFile("b.tpro", "<project name=\"b\"/>");
+    auto entryA = FileWorkspaceIndex::scan(filePathA, true);
+    entryA.thumbnail = someThumbnail();
+
+    {
+        FileWorkspaceIndex index{directory_->filePath("workspace.twsp")};
+        index.insert(filePathA, entryA);
+        index.insert(filePathB, FileWorkspaceIndex::scan(filePathB, false));
+        QVERIFY(index.save());
+    }
+
+    FileWorkspaceIndex index{directory_->filePath("workspace.twsp")};
+    QVERIFY(index.load());
+    QCOMPARE(index.entries().size(), 2);
+    QVERIFY(index.contains(filePathB));
+
+    auto const loaded = index.entry(filePathA);
+    QCOMPARE(loaded.rootTag, entryA.rootTag);
+    QCOMPARE(loaded.attributes, entryA.attributes);
+    QCOMPARE(loaded.size, entryA.size);
+    QCOMPARE(loaded.lastModified, entryA.lastModified);
+    QCOMPARE(loaded.contentHash, entryA.contentHash);
+    QCOMPARE(loaded.thumbnail, entryA.thumbnail);
+}
+
+void test_FileWorkspaceIndex::testMissingOrForeignIndexIsEmpty()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\"/>");
+    FileWorkspaceIndex index{directory_->filePath("workspace.twsp")};
+    index.insert(filePath, FileWorkspaceIndex::scan(filePath, false));
+
+    QVERIFY(!index.load());
+    QVERIFY(index.entries().isEmpty());
+
+    // e.g. written by another version
+    writeFile(".workspace.twspidx", "not an index");
+    index.insert(filePath, FileWorkspaceIndex::scan(filePath, false));
+    QVERIFY(!index.load());
+    QVERIFY(index.entries().isEmpty());
+}
+
+void test_FileWorkspaceIndex::testRetainRemovesOtherEntries()
+{
+    auto const filePathA = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto const filePathB = writeFile("b.tpro", "<project name=\"b\"/>");
+    FileWorkspaceIndex index{directory_->filePath("workspace.twsp")};
+    index.insert(filePathA, FileWorkspaceIndex::scan(filePathA, false));
+    index.insert(filePathB, FileWorkspaceIndex::scan(filePathB, false));
+
+    index.retain({filePathB, directory_->filePath("c.tpro")});
+
+    QCOMPARE(index.entries().size(), 1);
+    QVERIFY(index.contains(filePathB));
+}
+
+void test_FileWorkspaceIndex::testUnchangedEntryIsNotRevalidated()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto entry = FileWorkspaceIndex::scan(filePath, true);
+
+    QVERIFY(!FileWorkspaceIndex::revalidate(filePath, &entry));
+
+    // an entry without a hash is hashed once
+    auto unhashed = FileWorkspaceIndex::scan(filePath, false);
+    QVERIFY(FileWorkspaceIndex::revalidate(filePath, &unhashed));
+    QCOMPARE(unhashed.contentHash, entry.contentHash);
+    QVERIFY(!FileWorkspaceIndex::revalidate(filePath, &unhashed));
+}
+
+void test_FileWorkspaceIndex::testChangedFileIsScannedAgain()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto entry = FileWorkspaceIndex::scan(filePath, true);
+    entry.thumbnail = someThumbnail();
+
+    writeFile("a.tpro", "<project name=\"renamed\"/>");
+
+    QVERIFY(FileWorkspaceIndex::revalidate(filePath, &entry));
+    QCOMPARE(entry.attributes.value("name"), QString{"renamed"});
+    QVERIFY(entry.thumbnail.isNull());
+}
+
+void test_FileWorkspaceIndex::testTouchedFileKeepsThumbnail()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto entry = FileWorkspaceIndex::scan(filePath, true);
+    entry.thumbnail = someThumbnail();
+
+    waitForNextModificationTime();
+    writeFile("a.tpro", "<project name=\"a\"/>");
+
+    QVERIFY(FileWorkspaceIndex::revalidate(filePath, &entry));
+    QCOMPARE(entry.lastModified, QFileInfo(filePath).lastModified());
+    QCOMPARE(entry.thumbnail, someThumbnail());
+}
+
+void test_FileWorkspaceIndex::testRemovedFileIsReset()
+{
+    auto const filePath = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto entry = FileWorkspaceIndex::scan(filePath, true);
+
+    QVERIFY(QFile::remove(filePath));
+    QVERIFY(FileWorkspaceIndex::revalidate(filePath, &entry));
+    QCOMPARE(entry.size, qint64{-1});
+    QVERIFY(entry.rootTag.isEmpty());
+
+    QVERIFY(!FileWorkspaceIndex::revalidate(filePath, &entry));
+}
+
+void test_FileWorkspaceIndex::testRevalidationReportsChangedEntries()
+{
+    auto const filePathA = writeFile("a.tpro", "<project name=\"a\"/>");
+    auto const filePathB = writeFile("b.tpro", "<project name=\"b\"/>");
+    QHash<QString, FileWorkspaceIndex::Entry> entries;
+    entries.insert(filePathA, FileWorkspaceIndex::scan(filePathA, true));
+    entries.insert(filePathB, FileWorkspaceIndex::scan(filePathB, true));
+
+    writeFile("b.tpro", "<project name=\"changed\"/>");
+
+    FileWorkspaceIndexRevalidation revalidation{entries, nullptr};
+    revalidation.start();
+    QVERIFY(revalidation.wait(5000));
+
+    auto const changed = revalidation.changedEntries();
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.value(filePathB).attributes.value("name"), QString{"changed"});
+}
+
+QTEST_MAIN(test_FileWorkspaceIndex)
@@ -0,0 +1,40 @@
+#ifndef TEST_FILE_WORKSPACE_INDEX_H
+#define TEST_FILE_WORKSPACE_INDEX_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+#include <QTemporaryDir>
+
+class test_FileWorkspaceIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // scan
+    void testScanReadsRootElement();
+    void testScanOfMissingFileIsEmpty();
+    void testHeaderDomDocument();
+
+    // index file
+    void testIndexFileIsNextToWorkspace();
+    void testSaveAndLoad();
+    void testMissingOrForeignIndexIsEmpty();
+    void testRetainRemovesOtherEntries();
+
+    // revalidation
+    void testUnchangedEntryIsNotRevalidated();
+    void testChangedFileIsScannedAgain();
+    void testTouchedFileKeepsThumbnail();
+    void testRemovedFileIsReset();
+    void testRevalidationReportsChangedEntries();
+
+private:
+    QString writeFile(QString const& name, QByteArray const& content) const;
+
+    QScopedPointer<QTemporaryDir> directory_;
+};
+
+#endif // TEST_FILE_WORKSPACE_INDEX_H
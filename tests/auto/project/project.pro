@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += project_hash \
+           file_helper \
+           file_watch_service \
+           file_workspace_index \
+           sql_project_store
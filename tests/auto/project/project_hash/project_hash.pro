@@ -0,0 +1,10 @@
+include(../../testcase.pri)
+include(../../item/item_test.pri)
+
+TARGET = testProjectHash
+
+SOURCES +=  \
+            test_project_hash.cpp
+
+HEADERS +=  \
+            test_project_hash.h
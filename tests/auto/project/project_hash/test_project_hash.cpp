@@ -0,0 +1,198 @@
+#include "test_project_hash.h"
+
+#include "project/project_hash.h"
+#include "item/item_scene.h"
+#include "item_test_application.h"
+#include "some_item.h"
+
+#include <QGraphicsView>
+
+static QDomElement parse(QDomDocument& document, QString const& xml)
+{
+    if (!document.setContent(xml)) {
+        return QDomElement();
+    }
+
+    return document.documentElement();
+}
+
+static ProjectHash itemsHash(QDomElement const& element)
+{
+    ProjectHash hash;
+    hash.insertChildren(element, ProjectHash::isItemContent);
+    return hash;
+}
+
+// The hash of the items as they are saved, like AbstractProject::itemsHash()
+static ProjectHash savedHash(ItemScene& scene)
+{
+    QDomDocument document;
+    QDomElement root = document.createElement("project");
+    document.appendChild(root);
+    scene.saveToXml(document, root);
+    return itemsHash(root);
+}
+
+static QString const twoConnectedItems =
+    "<project name=\"p\">"
+    "<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"a\" x=\"0\" y=\"0\"/>"
+    "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"b\" x=\"100\" y=\"0\"/>"
+    "<GraphicsItemConnector fromItem=\"0\" fromIndex=\"0\" toItem=\"1\" toIndex=\"0\"/>"
+    "</project>";
+
+void test_ProjectHash::initTestCase()
+{
+    application_.reset(startItemTestApplication());
+}
+
+void test_ProjectHash::cleanupTestCase()
+{
+    application_.reset();
+}
+
+void test_ProjectHash::testOrderAndIdsAreIgnored()
+{
+    QDomDocument documentA;
+    QDomDocument documentB;
+    auto const a = parse(documentA, twoConnectedItems);
+    auto const b = parse(documentB,
+                         "<project name=\"p\">"
+                         "<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"b\" x=\"100\" y=\"0\"/>"
+                         "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"a\" x=\"0\" y=\"0\"/>"
+                         "<GraphicsItemConnector fromItem=\"1\" fromIndex=\"0\" toItem=\"0\" toIndex=\"0\"/>"
+                         "</project>");
+
+    QVERIFY(ProjectHash(a) == ProjectHash(b));
+    QVERIFY(ProjectHash(a).differences(ProjectHash(b)).isEmpty());
+}
+
+void test_ProjectHash::testChangedItemIsReported()
+{
+    QDomDocument documentA;
+    QDomDocument documentB;
+    auto const a = parse(documentA, twoConnectedItems);
+    auto b = parse(documentB, twoConnectedItems);
+    b.firstChildElement().setAttribute("x", 50);
+
+    QVERIFY(ProjectHash(a) != ProjectHash(b));
+    QCOMPARE(ProjectHash(a).differences(ProjectHash(b)), QStringList{ProjectHash::itemKey("a")});
+}
+
+void test_ProjectHash::testProjectAttributesAreHashed()
+{
+    QDomDocument documentA;
+    QDomDocument documentB;
+    auto const a = parse(documentA, twoConnectedItems);
+    auto b = parse(documentB, twoConnectedItems);
+    b.setAttribute("name", "renamed");
+
+    QVERIFY(ProjectHash(a) != ProjectHash(b));
+    QVERIFY(itemsHash(a) == itemsHash(b)); // the item content alone is equal
+}
+
+void test_ProjectHash::testDuplicateNamesShareOneLeaf()
+{
+    QString const first = "<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"x\" x=\"0\" y=\"0\"/>";
+    QString const second = "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"x\" x=\"100\" y=\"0\"/>";
+
+    QDomDocument documentA;
+    QDomDocument documentB;
+    auto const a = parse(documentA, "<project>" + first + second + "</project>");
+    auto const b = parse(documentB, "<project>" + second + first + "</project>");
+
+    QVERIFY(itemsHash(a) == itemsHash(b));
+
+    QDomDocument documentC;
+    auto c = parse(documentC, "<project>" + first + second + "</project>");
+    c.lastChildElement().setAttribute("y", 20);
+    QCOMPARE(itemsHash(a).differences(itemsHash(c)), QStringList{ProjectHash::itemKey("x")});
+}
+
+void test_ProjectHash::testGroupLeafIgnoresOrder()
+{
+    QDomDocument document;
+    QByteArray const leafA = ProjectHash::hashElement(document.createElement("a"));
+    QByteArray const leafB = ProjectHash::hashElement(document.createElement("b"));
+
+    QCOMPARE(ProjectHash::groupLeaf({leafA}), leafA);
+    QCOMPARE(ProjectHash::groupLeaf({leafA, leafB}), ProjectHash::groupLeaf({leafB, leafA}));
+    QVERIFY(ProjectHash::groupLeaf({leafA, leafB}) != ProjectHash::groupLeaf({leafA, leafA}));
+}
+
+void test_ProjectHash::testInsertAndRemove()
+{
+    QDomDocument document;
+    ProjectHash hash;
+    QByteArray const emptyRoot = hash.root();
+
+    hash.insert("key", ProjectHash::hashElement(document.createElement("a")));
+    QVERIFY(hash.root() != emptyRoot);
+    QCOMPARE(hash.differences(ProjectHash()), QStringList{"key"});
+
+    hash.remove("key");
+    QCOMPARE(hash.root(), emptyRoot);
+}
+
+void test_ProjectHash::testSceneHashEqualsSavedHash()
+{
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    auto itemA = new SomeItem{"dup", 1};
+    auto itemB = new SomeItem{"dup", 2};
+    itemB->setPos(200, 0);
+    scene.addItem(itemA);
+    scene.addItem(itemB);
+
+    QVERIFY(scene.contentHash() == savedHash(scene));
+
+    itemA->setPos(0, 100);
+    QVERIFY(scene.contentHash() == savedHash(scene));
+
+    itemB->setName("unique");
+    QVERIFY(scene.contentHash() == savedHash(scene));
+
+    delete itemA;
+    QVERIFY(scene.contentHash() == savedHash(scene));
+}
+
+void test_ProjectHash::testLoadedSceneWithDuplicateNamesStaysEqual()
+{
+    QDomDocument document;
+    QDomElement root = document.createElement("project");
+    document.appendChild(root);
+
+    {
+        ItemScene scene{{}};
+        QGraphicsView view{&scene};
+        scene.addItem(new SomeItem{"dup", 1});
+        auto second = new SomeItem{"dup", 2};
+        second->setPos(200, 0);
+        scene.addItem(second);
+        scene.addItem(new SomeItem{"dup", 3});
+        QVERIFY(scene.saveToXml(document, root));
+    }
+
+    ItemScene scene{{}};
+    QGraphicsView view{&scene};
+    QVERIFY(scene.loadFromXml(root));
+    QVERIFY(scene.contentHash() == itemsHash(root));
+
+    // change one of the items with the same name, the loaded leaf is replaced by the one of the whole group
+    SomeItem* moved = nullptr;
+
+    for (QGraphicsItem* item : scene.items()) {
+        if (auto someItem = qobject_cast<SomeItem*>(item->toGraphicsObject())) {
+            moved = someItem;
+        }
+    }
+
+    QVERIFY(moved != nullptr);
+    moved->setPos(moved->pos() + QPointF{0, 300});
+    QVERIFY(scene.contentHash() == savedHash(scene));
+
+    // moving it back restores the loaded hash
+    moved->setPos(moved->pos() - QPointF{0, 300});
+    QVERIFY(scene.contentHash() == itemsHash(root));
+}
+
+QTEST_APPLESS_MAIN(test_ProjectHash)
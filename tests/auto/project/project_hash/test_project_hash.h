@@ -0,0 +1,31 @@
+#ifndef TEST_PROJECT_HASH_H
+#define TEST_PROJECT_HASH_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class test_ProjectHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testOrderAndIdsAreIgnored();
+    void testChangedItemIsReported();
+    void testProjectAttributesAreHashed();
+    void testDuplicateNamesShareOneLeaf();
+    void testGroupLeafIgnoresOrder();
+    void testInsertAndRemove();
+
+    // the incrementally maintained hash of ItemScene
+    void testSceneHashEqualsSavedHash();
+    void testLoadedSceneWithDuplicateNamesStaysEqual();
+
+private:
+    QScopedPointer<class QApplication> application_;
+};
+
+#endif // TEST_PROJECT_HASH_H
@@ -0,0 +1,11 @@
+include(../../testcase.pri)
+
+QT += sql
+
+TARGET = testSqlProjectStore
+
+SOURCES +=  \
+            test_sql_project_store.cpp
+
+HEADERS +=  \
+            test_sql_project_store.h
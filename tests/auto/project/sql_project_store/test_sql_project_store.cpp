@@ -0,0 +1,270 @@
+#include "test_sql_project_store.h"
+
+#include "project/sql_project_store.h"
+#include "project/project_hash.h"
+#include "project/project_manager_config.h"
+
+static QString const twoConnectedItems =
+    "<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"a\" x=\"0\" y=\"0\"/>"
+    "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"b\" x=\"100\" y=\"0\"/>"
+    "<GraphicsItemConnector fromItem=\"0\" fromIndex=\"0\" toItem=\"1\" toIndex=\"0\"/>"
+    "<" ProDomElmTagSettingsScope "><Setting name=\"s\" value=\"1\"/></" ProDomElmTagSettingsScope ">";
+
+static QDomDocument projectDocument(QString const& content, QString const& name = "p")
+{
+    QDomDocument document;
+    document.setContent(QString("<%1 name=\"%2\" version=\"2.0\" description=\"d\">%3</%1>")
+                        .arg(ProDomElmTagPro).arg(name).arg(content));
+    return document;
+}
+
+static SqlProjectStore::ProjectRow projectRow(QString const& name)
+{
+    SqlProjectStore::ProjectRow row;
+    row.name = name;
+    row.version = "2.0";
+    row.description = "d";
+    return row;
+}
+
+// the item element of a read document which a connector refers to
+static QDomElement itemOf(QDomDocument const& document, QString const& idAttribute)
+{
+    auto const connector = document.documentElement().firstChildElement("GraphicsItemConnector");
+
+    for (auto item = document.documentElement().firstChildElement("GraphicsItem"); !item.isNull();
+            item = item.nextSiblingElement("GraphicsItem")) {
+        if (item.attribute("id") == connector.attribute(idAttribute)) {
+            return item;
+        }
+    }
+
+    return QDomElement();
+}
+
+// the number of rows changed by the connection since it was opened
+int test_SqlProjectStore::changes() const
+{
+    SqlQuery query{"SELECT total_changes()", store_->database()};
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+int test_SqlProjectStore::rowCount(QString const& table) const
+{
+    SqlQuery query{QString("SELECT COUNT(*) FROM %1").arg(table), store_->database()};
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+void test_SqlProjectStore::init()
+{
+    SqlDatabase database{"QSQLITE"};
+    database.setDatabaseName(":memory:");
+
+    // the store keeps the only connection, so every test gets its own, empty database
+    store_.reset(new SqlProjectStore{database});
+    QVERIFY2(store_->open(), qPrintable(store_->lastError()));
+}
+
+void test_SqlProjectStore::cleanup()
+{
+    store_.reset();
+}
+
+void test_SqlProjectStore::testRoundTrip()
+{
+    auto const document = projectDocument(twoConnectedItems);
+    auto row = projectRow("p");
+
+    QVERIFY2(store_->writeProjectDomDocument(&row, document), qPrintable(store_->lastError()));
+    QVERIFY(row.id >= 0);
+    QCOMPARE(rowCount("project_element"), 4);
+
+    auto const read = store_->readProjectDomDocument(row.id);
+    QCOMPARE(read.documentElement().tagName(), QString{ProDomElmTagPro});
+    QCOMPARE(read.documentElement().attribute("name"), QString{"p"});
+    QVERIFY(ProjectHash(read.documentElement()) == ProjectHash(document.documentElement()));
+
+    QCOMPARE(itemOf(read, "fromItem").attribute("name"), QString{"a"});
+    QCOMPARE(itemOf(read, "toItem").attribute("name"), QString{"b"});
+}
+
+void test_SqlProjectStore::testMissingProjectIsNull()
+{
+    QVERIFY(store_->readProjectDomDocument(42).isNull());
+    QVERIFY(!store_->lastError().isEmpty());
+}
+
+void test_SqlProjectStore::testOnlyChangedRowsAreWritten()
+{
+    auto document = projectDocument(twoConnectedItems);
+    auto row = projectRow("p");
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+
+    // saved again unchanged: only the project row
+    int before = changes();
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+    QCOMPARE(changes() - before, 1);
+
+    // a moved item: the project row and the item row
+    document.documentElement().firstChildElement("GraphicsItem").setAttribute("x", 50);
+    before = changes();
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+    QCOMPARE(changes() - before, 2);
+
+    // a removed setting: the project row and the deleted setting row
+    auto root = document.documentElement();
+    root.removeChild(root.firstChildElement(ProDomElmTagSettingsScope));
+    before = changes();
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+    QCOMPARE(changes() - before, 2);
+    QCOMPARE(rowCount("project_element"), 3);
+
+    QVERIFY(ProjectHash(store_->readProjectDomDocument(row.id).documentElement()) == ProjectHash(root));
+}
+
+void test_SqlProjectStore::testDuplicateNamesKeepTheirConnectors()
+{
+    // the connector starts at the second item named x
+    auto document = projectDocument("<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"x\" x=\"0\" y=\"0\"/>"
+                                    "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"x\" x=\"100\" y=\"0\"/>"
+                                    "<GraphicsItem type=\"SomeItem\" id=\"2\" name=\"y\" x=\"200\" y=\"0\"/>"
+                                    "<GraphicsItemConnector fromItem=\"1\" fromIndex=\"0\" toItem=\"2\" toIndex=\"0\"/>");
+    auto row = projectRow("p");
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+
+    auto read = store_->readProjectDomDocument(row.id);
+    QCOMPARE(itemOf(read, "fromItem").attribute("x"), QString{"100"});
+    QCOMPARE(itemOf(read, "toItem").attribute("name"), QString{"y"});
+
+    // without the first x, the remaining one is numbered differently
+    auto root = document.documentElement();
+    root.removeChild(root.firstChildElement("GraphicsItem"));
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+
+    read = store_->readProjectDomDocument(row.id);
+    QCOMPARE(itemOf(read, "fromItem").attribute("x"), QString{"100"});
+    QCOMPARE(itemOf(read, "toItem").attribute("name"), QString{"y"});
+}
+
+void test_SqlProjectStore::testManyDuplicateNamesKeepTheirOrder()
+{
+    // keyed "x" to "x #12", a lexical order would read "x #10" before "x #2"
+    QString content;
+
+    for (int i = 0; i < 12; i++) {
+        content += QString("<GraphicsItem type=\"SomeItem\" id=\"%1\" name=\"x\" x=\"%2\" y=\"0\"/>").arg(i).arg(i * 100);
+    }
+
+    content += "<GraphicsItemConnector fromItem=\"1\" fromIndex=\"0\" toItem=\"10\" toIndex=\"0\"/>";
+    auto const document = projectDocument(content);
+    auto row = projectRow("p");
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+
+    auto const read = store_->readProjectDomDocument(row.id);
+    QVERIFY(ProjectHash(read.documentElement()) == ProjectHash(document.documentElement()));
+
+    int i = 0;
+
+    for (auto item = read.documentElement().firstChildElement("GraphicsItem"); !item.isNull();
+            item = item.nextSiblingElement("GraphicsItem"), i++) {
+        QCOMPARE(item.attribute("id"), QString::number(i));
+        QCOMPARE(item.attribute("x"), QString::number(i * 100));
+    }
+
+    QCOMPARE(i, 12);
+    QCOMPARE(itemOf(read, "fromItem").attribute("x"), QString{"100"});
+    QCOMPARE(itemOf(read, "toItem").attribute("x"), QString{"1000"});
+
+    // read and saved again, nothing but the project row is written
+    auto const before = changes();
+    QVERIFY(store_->writeProjectDomDocument(&row, read));
+    QCOMPARE(changes() - before, 1);
+}
+
+void test_SqlProjectStore::testMovedRowsOnlyWriteTheirPosition()
+{
+    auto document = projectDocument("<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"a\" x=\"0\" y=\"0\"/>"
+                                    "<GraphicsItem type=\"SomeItem\" id=\"1\" name=\"b\" x=\"100\" y=\"0\"/>"
+                                    "<GraphicsItem type=\"SomeItem\" id=\"2\" name=\"c\" x=\"200\" y=\"0\"/>");
+    auto row = projectRow("p");
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+
+    // the project row, the deleted row and the two moved rows
+    auto root = document.documentElement();
+    root.removeChild(root.firstChildElement("GraphicsItem"));
+    auto const before = changes();
+    QVERIFY(store_->writeProjectDomDocument(&row, document));
+    QCOMPARE(changes() - before, 4);
+
+    auto const read = store_->readProjectDomDocument(row.id);
+    QCOMPARE(read.documentElement().firstChildElement("GraphicsItem").attribute("name"), QString{"b"});
+    QCOMPARE(read.documentElement().lastChildElement("GraphicsItem").attribute("name"), QString{"c"});
+}
+
+void test_SqlProjectStore::testRemovedProjectsAreDeleted()
+{
+    SqlProjectStore::WorkspaceRow workspace;
+    workspace.name = "w";
+    workspace.version = "1.0";
+
+    QVector<SqlProjectStore::ProjectRow> projects{projectRow("p"), projectRow("q")};
+    QVERIFY(store_->writeWorkspace(workspace, &projects));
+    QVERIFY(store_->hasWorkspace());
+    QVERIFY(store_->writeProjectDomDocument(&projects[0], projectDocument(twoConnectedItems, "p")));
+    QVERIFY(store_->writeProjectDomDocument(&projects[1], projectDocument(twoConnectedItems, "q")));
+
+    auto const removedId = projects.at(0).id;
+    projects.removeFirst();
+    QVERIFY(store_->writeWorkspace(workspace, &projects));
+
+    auto const read = store_->readProjects();
+    QCOMPARE(read.size(), 1);
+    QCOMPARE(read.first().id, projects.first().id);
+    QCOMPARE(read.first().name, QString{"q"});
+    QCOMPARE(rowCount("project_element"), 4);
+    QVERIFY(store_->readProjectDomDocument(removedId).isNull());
+
+    SqlProjectStore::WorkspaceRow readWorkspace;
+    QVERIFY(store_->readWorkspace(&readWorkspace));
+    QCOMPARE(readWorkspace.name, QString{"w"});
+
+    QVERIFY(store_->deleteWorkspace(true));
+    QVERIFY(!store_->hasWorkspace());
+    QCOMPARE(rowCount("project"), 0);
+    QCOMPARE(rowCount("project_element"), 0);
+}
+
+void test_SqlProjectStore::testProjectIdsUsingItemType()
+{
+    auto p = projectRow("p");
+    auto q = projectRow("q");
+    QVERIFY(store_->writeProjectDomDocument(&p, projectDocument(twoConnectedItems, "p")));
+    QVERIFY(store_->writeProjectDomDocument(&q, projectDocument(
+            "<GraphicsItem type=\"OtherItem\" id=\"0\" name=\"a\" x=\"0\" y=\"0\"/>", "q")));
+
+    QCOMPARE(store_->projectIdsUsingItemType("SomeItem"), QList<qint64>{p.id});
+    QCOMPARE(store_->projectIdsUsingItemType("OtherItem"), QList<qint64>{q.id});
+    QVERIFY(store_->projectIdsUsingItemType("UnknownItem").isEmpty());
+
+    // the item is replaced
+    QVERIFY(store_->writeProjectDomDocument(&q, projectDocument(
+            "<GraphicsItem type=\"SomeItem\" id=\"0\" name=\"a\" x=\"0\" y=\"0\"/>", "q")));
+    QCOMPARE(store_->projectIdsUsingItemType("SomeItem").size(), 2);
+    QVERIFY(store_->projectIdsUsingItemType("OtherItem").isEmpty());
+}
+
+void test_SqlProjectStore::testAutosave()
+{
+    auto row = projectRow("p");
+    QVERIFY(store_->writeProjectDomDocument(&row, projectDocument(twoConnectedItems)));
+    QVERIFY(store_->readAutosaveDomDocument(row.id).isNull());
+
+    auto const autosave = projectDocument(twoConnectedItems, "autosaved");
+    QVERIFY(store_->writeAutosaveDomDocument(row.id, autosave));
+    QCOMPARE(store_->readAutosaveDomDocument(row.id).documentElement().attribute("name"), QString{"autosaved"});
+
+    QVERIFY(store_->writeAutosaveDomDocument(row.id, QDomDocument{}));
+    QVERIFY(store_->readAutosaveDomDocument(row.id).isNull());
+}
+
+QTEST_MAIN(test_SqlProjectStore)
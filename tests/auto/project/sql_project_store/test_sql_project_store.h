@@ -0,0 +1,35 @@
+#ifndef TEST_SQL_PROJECT_STORE_H
+#define TEST_SQL_PROJECT_STORE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QtTest/QTest>
+
+class SqlProjectStore;
+
+class test_SqlProjectStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRoundTrip();
+    void testMissingProjectIsNull();
+    void testOnlyChangedRowsAreWritten();
+    void testDuplicateNamesKeepTheirConnectors();
+    void testManyDuplicateNamesKeepTheirOrder();
+    void testMovedRowsOnlyWriteTheirPosition();
+    void testRemovedProjectsAreDeleted();
+    void testProjectIdsUsingItemType();
+    void testAutosave();
+
+private:
+    int changes() const;
+    int rowCount(QString const& table) const;
+
+    QScopedPointer<SqlProjectStore> store_;
+};
+
+#endif // TEST_SQL_PROJECT_STORE_H